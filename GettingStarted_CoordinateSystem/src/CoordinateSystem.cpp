@@ -1,22 +1,32 @@
 #include <array>
 #include <iostream>
+#include <optional>
 
 #include "display.h"
+#include "frameCapture.h"
+#include "glStateCache.h"
 #include "shader.h"
 #include "texture2D.h"
 
-void KeyCallback(Display::value_type* window, int key, int scancode, int action, int mods);
-void WindowSizeCallback(GLFWwindow* window, int width, int height);
+void HandleEvents(Display& display);
+void KeyEvent(Display& display, int key, int action);
+void FramebufferSizeEvent(int width, int height);
 
 // settings
 constexpr unsigned int SCR_WIDTH{800};
 constexpr unsigned int SCR_HEIGHT{600};
 
-int main()
+int main(int argc, char* argv[])
 {
-    Display window{SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL"};
-    window.SetKeyCallback(KeyCallback);
-    window.SetWindowSizeCallback(WindowSizeCallback);
+    // --capture renders a fixed number of frames hidden and compares them with golden images
+    FrameCapture::Settings captureSettings;
+    const bool capture{FrameCapture::ParseArguments(argc, argv, captureSettings)};
+    Display window{SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", false, !capture};
+    std::optional<FrameCapture> frameCapture;
+    if(capture){
+        frameCapture.emplace(window, captureSettings);
+    }
+    auto& stateCache{GLStateCache::Current()};
 
     Shader shader{"./shaders/coordinate.vert", "./shaders/coordinate.frag"};
 
@@ -38,10 +48,10 @@ int main()
     glGenBuffers(1, &VBO);
     glGenBuffers(1, &EBO);
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    stateCache.BindBuffer(GL_ARRAY_BUFFER, VBO);
     glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(vertices.front()), vertices.data(), GL_STATIC_DRAW);
 
-    glBindVertexArray(VAO);
+    stateCache.BindVertexArray(VAO);
     // position attribute
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(float) * 5, reinterpret_cast<void*>(0));
     glEnableVertexAttribArray(0);
@@ -49,11 +59,11 @@ int main()
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(float) * 5, reinterpret_cast<void*>(3 * sizeof(vertices.front())));
     glEnableVertexAttribArray(1);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    stateCache.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(indices.front()), indices.data(), GL_STATIC_DRAW);
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    stateCache.BindBuffer(GL_ARRAY_BUFFER, 0);
+    stateCache.BindVertexArray(0);
 
     Texture2D texture1{"./textures/container.jpg"};
     Texture2D texture2{"./textures/awesomeface.png", true};
@@ -71,35 +81,60 @@ int main()
 
     // render loop
     while(!window.IsClosed()){
+        // input and resizes seen by the last poll
+        HandleEvents(window);
+
         window.Clear(0.2f, 0.3f, 0.3f, 1.0f);
 
-        glBindVertexArray(VAO);
+        stateCache.BindVertexArray(VAO);
         glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-        glBindVertexArray(0);
+        stateCache.BindVertexArray(0);
 
         shader.SetUniformMatrix("model", model);
         shader.SetUniformMatrix("view", view);
         shader.SetUniformMatrix("projection", projection);
 
+        if(frameCapture){
+            frameCapture->EndFrame();
+        }
+
         // check and call events and swap buffers
         window.Update();
     }
 
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteBuffers(1, &EBO);
+    stateCache.DeleteVertexArray(VAO);
+    stateCache.DeleteBuffer(VBO);
+    stateCache.DeleteBuffer(EBO);
 
-    return 0;
+    return frameCapture ? frameCapture->GetExitCode() : 0;
+}
+
+void HandleEvents(Display& display)
+{
+    Display::Event event;
+    while(display.PollEvent(event)){
+        switch(event.type){
+            case Display::EventType::Key:
+                KeyEvent(display, event.key, event.action);
+                break;
+
+            case Display::EventType::FramebufferSize:
+                FramebufferSizeEvent(event.width, event.height);
+                break;
+
+            default:
+                break;
+        }
+    }
 }
 
-void KeyCallback(Display::value_type* window, int key, int scancode, int action, int mods)
+void KeyEvent(Display& display, int key, int action)
 {
-    auto display = Display::GetWindowUserPointer(window);
     switch(key){
         case GLFW_KEY_ESCAPE:
         {
             if(action == GLFW_PRESS){
-                display->SetClose();
+                display.SetClose();
             }
         }
         break;
@@ -107,10 +142,10 @@ void KeyCallback(Display::value_type* window, int key, int scancode, int action,
         case GLFW_KEY_L:
         {
             if(action == GLFW_PRESS || action == GLFW_REPEAT){
-                glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+                GLStateCache::Current().PolygonMode(GL_LINE);
             }
             else{
-                glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+                GLStateCache::Current().PolygonMode(GL_FILL);
             }
         }
         break;
@@ -118,11 +153,11 @@ void KeyCallback(Display::value_type* window, int key, int scancode, int action,
         case GLFW_KEY_P:
         {
             if(action == GLFW_PRESS || action == GLFW_REPEAT){
-                glPolygonMode(GL_FRONT_AND_BACK, GL_POINT);
+                GLStateCache::Current().PolygonMode(GL_POINT);
                 glPointSize(2.0f);
             }
             else{
-                glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+                GLStateCache::Current().PolygonMode(GL_FILL);
                 glPointSize(1.0f);
             }
         }
@@ -130,7 +165,7 @@ void KeyCallback(Display::value_type* window, int key, int scancode, int action,
     }
 }
 
-void WindowSizeCallback(GLFWwindow* window, int width, int height)
+void FramebufferSizeEvent(int width, int height)
 {
     glViewport(0, 0, width, height);
     //TODO later update any perspective matrices used here
@@ -0,0 +1,49 @@
+#ifndef BENCHMARK_MESHES_H_10192026
+#define BENCHMARK_MESHES_H_10192026
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+/*
+Generated test geometry shared by the benchmarks.
+*/
+struct UvSphere
+{
+    std::vector<glm::vec3> positions;   // unit radius, so they double as normals
+    std::vector<glm::vec2> texCoords;   // segment / segments, ring / rings
+    std::vector<std::uint32_t> indices; // triangle list, counter clockwise seen from outside
+};
+
+// rings * segments quads, (rings + 1) * (segments + 1) vertices, the seam and pole vertices are duplicated
+inline UvSphere MakeUvSphere(std::size_t rings, std::size_t segments)
+{
+    constexpr float pi{3.14159265358979f};
+    UvSphere sphere;
+    sphere.positions.reserve((rings + 1) * (segments + 1));
+    sphere.texCoords.reserve((rings + 1) * (segments + 1));
+    for(std::size_t ring{}; ring <= rings; ++ring){
+        auto v{static_cast<float>(ring) / static_cast<float>(rings)};
+        auto theta{pi * v};
+        for(std::size_t segment{}; segment <= segments; ++segment){
+            auto u{static_cast<float>(segment) / static_cast<float>(segments)};
+            auto phi{2.0f * pi * u};
+            sphere.positions.emplace_back(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+            sphere.texCoords.emplace_back(u, v);
+        }
+    }
+    sphere.indices.reserve(rings * segments * 6);
+    for(std::size_t ring{}; ring < rings; ++ring){
+        for(std::size_t segment{}; segment < segments; ++segment){
+            auto a{static_cast<std::uint32_t>(ring * (segments + 1) + segment)};
+            auto b{static_cast<std::uint32_t>(a + segments + 1)};
+            sphere.indices.insert(sphere.indices.end(), {a, a + 1, b, a + 1, b + 1, b});
+        }
+    }
+    return sphere;
+}
+
+#endif // !BENCHMARK_MESHES_H_10192026
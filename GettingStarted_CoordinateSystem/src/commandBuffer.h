@@ -0,0 +1,52 @@
+#ifndef COMMAND_BUFFER_H_10192026
+#define COMMAND_BUFFER_H_10192026
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "renderQueue.h"
+
+/*
+Draw packets and their sort keys recorded without a single GL call, so any thread can fill one.
+Every recording thread owns its CommandBuffer, the GL thread merges them into a RenderQueue with
+RenderQueue::Submit(const CommandBuffer&) and sorts and replays everything on the one context.
+*/
+class CommandBuffer
+{
+public:
+    explicit CommandBuffer(std::size_t capacity = 0)
+    {
+        m_keys.reserve(capacity);
+        m_packets.reserve(capacity);
+    }
+
+    inline void Record(std::uint64_t key, const DrawPacket& packet)
+    {
+        m_keys.push_back(key);
+        m_packets.push_back(packet);
+    }
+
+    // same key as RenderQueue::Submit(packet, depth, pass, translucent)
+    inline void Record(const DrawPacket& packet, float depth, unsigned int pass = 0, bool translucent = false)
+    {
+        unsigned int program{packet.shader ? static_cast<unsigned int>(*packet.shader) : 0u};
+        Record(RenderQueue::MakeKey(pass, translucent, program, RenderQueue::MaterialId(packet), packet.vertexArray, depth), packet);
+    }
+
+    inline void Clear()
+    {
+        m_keys.clear();
+        m_packets.clear();
+    }
+
+    inline std::size_t Size() const { return m_packets.size(); }
+    inline const std::vector<std::uint64_t>& GetKeys() const { return m_keys; }
+    inline const std::vector<DrawPacket>& GetPackets() const { return m_packets; }
+
+private:
+    std::vector<std::uint64_t> m_keys;
+    std::vector<DrawPacket> m_packets;
+};
+
+#endif // !COMMAND_BUFFER_H_10192026
@@ -0,0 +1,132 @@
+#include "computeProgram.h"
+#include "glStateCache.h"
+#include <iostream>
+#include <memory>
+
+namespace
+{
+    // GL_IMAGE_1D up to GL_UNSIGNED_INT_IMAGE_2D_MULTISAMPLE_ARRAY are contiguous enum values
+    inline bool IsImageType(GLenum type)
+    {
+        return type >= GL_IMAGE_1D && type <= GL_UNSIGNED_INT_IMAGE_2D_MULTISAMPLE_ARRAY;
+    }
+}
+
+ComputeProgram::ComputeProgram(const std::basic_string_view<char> computeFile)
+    : Shader{computeFile}, m_workGroupSize{}, m_storageBlocks{}, m_images{}
+{
+    int linked{};
+    glGetProgramiv(*this, GL_LINK_STATUS, &linked);
+    if(linked == GL_FALSE){
+        std::cerr << "Error compute program " << computeFile << " did not link" << std::endl;
+        return;
+    }
+    Reflect();
+}
+
+void ComputeProgram::Dispatch(unsigned int groupsX, unsigned int groupsY, unsigned int groupsZ) const
+{
+#if defined DEBUG || defined _DEBUG
+    ValidateBindings();
+#endif // DEBUG || defined _DEBUG
+    Bind();
+    glDispatchCompute(groupsX, groupsY, groupsZ);
+}
+
+void ComputeProgram::DispatchThreads(unsigned int threadsX, unsigned int threadsY, unsigned int threadsZ) const
+{
+    auto groups = [](unsigned int threads, unsigned int groupSize){
+        return groupSize ? (threads + groupSize - 1) / groupSize : 0u;
+    };
+    Dispatch(groups(threadsX, m_workGroupSize[0]), groups(threadsY, m_workGroupSize[1]), groups(threadsZ, m_workGroupSize[2]));
+}
+
+void ComputeProgram::DispatchIndirect(unsigned int buffer, GLintptr offset) const
+{
+#if defined DEBUG || defined _DEBUG
+    ValidateBindings();
+#endif // DEBUG || defined _DEBUG
+    Bind();
+    GLStateCache::Current().BindBuffer(GL_DISPATCH_INDIRECT_BUFFER, buffer);
+    glDispatchComputeIndirect(offset);
+    GLStateCache::Current().BindBuffer(GL_DISPATCH_INDIRECT_BUFFER, 0);
+}
+
+bool ComputeProgram::ValidateBindings() const
+{
+    bool valid{true};
+    for(const auto& block : m_storageBlocks){
+        int buffer{};
+        glGetIntegeri_v(GL_SHADER_STORAGE_BUFFER_BINDING, block.binding, &buffer);
+        if(buffer == 0){
+            std::cerr << "Error storage block " << block.name << " has no buffer at binding " << block.binding << std::endl;
+            valid = false;
+            continue;
+        }
+
+        // a range bound with glBindBufferRange reports its size, glBindBufferBase reports 0 for the whole buffer
+        GLint64 size{};
+        glGetInteger64i_v(GL_SHADER_STORAGE_BUFFER_SIZE, block.binding, &size);
+        if(size == 0){
+            GLStateCache::Current().BindBuffer(GL_COPY_READ_BUFFER, buffer);
+            glGetBufferParameteri64v(GL_COPY_READ_BUFFER, GL_BUFFER_SIZE, &size);
+            GLStateCache::Current().BindBuffer(GL_COPY_READ_BUFFER, 0);
+        }
+        if(size < block.minimumSize){
+            std::cerr << "Error storage block " << block.name << " needs " << block.minimumSize
+                << " bytes, binding " << block.binding << " has " << size << std::endl;
+            valid = false;
+        }
+    }
+
+    for(const auto& image : m_images){
+        int texture{};
+        glGetIntegeri_v(GL_IMAGE_BINDING_NAME, image.binding, &texture);
+        if(texture == 0){
+            std::cerr << "Error image " << image.name << " has no texture at unit " << image.binding << std::endl;
+            valid = false;
+        }
+    }
+    return valid;
+}
+
+void ComputeProgram::Reflect()
+{
+    int workGroupSize[3]{};
+    glGetProgramiv(*this, GL_COMPUTE_WORK_GROUP_SIZE, workGroupSize);
+    for(size_t i{}; i < m_workGroupSize.size(); ++i){
+        m_workGroupSize[i] = static_cast<unsigned int>(workGroupSize[i]);
+    }
+
+    int blockCount{};
+    int maxNameSize{};
+    glGetProgramInterfaceiv(*this, GL_SHADER_STORAGE_BLOCK, GL_ACTIVE_RESOURCES, &blockCount);
+    glGetProgramInterfaceiv(*this, GL_SHADER_STORAGE_BLOCK, GL_MAX_NAME_LENGTH, &maxNameSize);
+    for(decltype(blockCount)i{}; i < blockCount; ++i){
+        auto name{std::make_unique<char[]>(maxNameSize)};
+        glGetProgramResourceName(*this, GL_SHADER_STORAGE_BLOCK, i, maxNameSize, nullptr, name.get());
+        // runtime sized arrays count as one element
+        const GLenum properties[]{GL_BUFFER_BINDING, GL_BUFFER_DATA_SIZE};
+        int values[2]{};
+        glGetProgramResourceiv(*this, GL_SHADER_STORAGE_BLOCK, i, 2, properties, 2, nullptr, values);
+        m_storageBlocks.push_back({name.get(), static_cast<unsigned int>(values[0]), values[1]});
+    }
+
+    int uniformCount{};
+    glGetProgramInterfaceiv(*this, GL_UNIFORM, GL_ACTIVE_RESOURCES, &uniformCount);
+    glGetProgramInterfaceiv(*this, GL_UNIFORM, GL_MAX_NAME_LENGTH, &maxNameSize);
+    for(decltype(uniformCount)i{}; i < uniformCount; ++i){
+        const GLenum properties[]{GL_TYPE, GL_LOCATION};
+        int values[2]{};
+        glGetProgramResourceiv(*this, GL_UNIFORM, i, 2, properties, 2, nullptr, values);
+        if(!IsImageType(static_cast<GLenum>(values[0])) || values[1] < 0){
+            continue;
+        }
+        auto name{std::make_unique<char[]>(maxNameSize)};
+        glGetProgramResourceName(*this, GL_UNIFORM, i, maxNameSize, nullptr, name.get());
+        // the unit from layout(binding = n), later glUniform1i changes are not tracked
+        int unit{};
+        glGetUniformiv(*this, values[1], &unit);
+        m_images.push_back({name.get(), static_cast<unsigned int>(unit), 0});
+    }
+}
@@ -0,0 +1,66 @@
+#ifndef COMPUTE_PROGRAM_H_10192026
+#define COMPUTE_PROGRAM_H_10192026
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "shader.h"
+
+/*
+Shader linked from a single .comp file with helpers for dispatching it.
+The work group size declared with local_size_x/y/z is read back from the program, DispatchThreads()
+rounds a thread count up to whole work groups.
+Shader storage blocks and image uniforms are reflected with their binding points,
+ValidateBindings() reports any binding without a buffer or image attached, or with a buffer smaller
+than the block needs. Debug builds validate before every dispatch.
+Barrier() forwards to glMemoryBarrier, combine the BarrierBits of every way the written data is read next.
+*/
+class ComputeProgram : public Shader
+{
+public:
+    enum BarrierBits : GLbitfield
+    {
+        StorageBuffer = GL_SHADER_STORAGE_BARRIER_BIT,     // later storage buffer access in shaders
+        ImageAccess = GL_SHADER_IMAGE_ACCESS_BARRIER_BIT,   // later imageLoad/imageStore
+        TextureFetch = GL_TEXTURE_FETCH_BARRIER_BIT,        // later sampling of written images
+        Command = GL_COMMAND_BARRIER_BIT,                   // indirect draw and dispatch parameters
+        VertexAttribute = GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT,
+        ElementArray = GL_ELEMENT_ARRAY_BARRIER_BIT,
+        BufferUpdate = GL_BUFFER_UPDATE_BARRIER_BIT,        // glGetBufferSubData and friends
+        All = GL_ALL_BARRIER_BITS
+    };
+
+    struct Binding
+    {
+        std::basic_string<char> name;
+        unsigned int binding;
+        int minimumSize;    // bytes for storage blocks, 0 for images
+    };
+
+    explicit ComputeProgram(const std::basic_string_view<char> computeFile);
+
+    void Dispatch(unsigned int groupsX, unsigned int groupsY = 1, unsigned int groupsZ = 1) const;
+    void DispatchThreads(unsigned int threadsX, unsigned int threadsY = 1, unsigned int threadsZ = 1) const;
+    // reads a DispatchIndirectCommand {groupsX, groupsY, groupsZ} from buffer at offset
+    void DispatchIndirect(unsigned int buffer, GLintptr offset = 0) const;
+
+    bool ValidateBindings() const;
+
+    inline const std::array<unsigned int, 3>& GetWorkGroupSize() const { return m_workGroupSize; }
+    inline const std::vector<Binding>& GetStorageBlocks() const { return m_storageBlocks; }
+    inline const std::vector<Binding>& GetImages() const { return m_images; }
+
+    static inline void Barrier(GLbitfield barriers) { glMemoryBarrier(barriers); }
+
+private:
+    void Reflect();
+
+    std::array<unsigned int, 3> m_workGroupSize;
+    std::vector<Binding> m_storageBlocks;
+    std::vector<Binding> m_images;
+};
+
+#endif // !COMPUTE_PROGRAM_H_10192026
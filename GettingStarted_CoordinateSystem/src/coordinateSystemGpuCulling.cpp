@@ -0,0 +1,271 @@
+#include <array>
+#include <iostream>
+#include <optional>
+#include <vector>
+
+#include "computeProgram.h"
+#include "display.h"
+#include "frameCapture.h"
+#include "glStateCache.h"
+#include "gpuCuller.h"
+#include "gpuTimer.h"
+#include "hiZPyramid.h"
+#include "shader.h"
+#include "texture2D.h"
+
+void HandleEvents(Display& display);
+void KeyEvent(Display& display, int key, int action);
+void FramebufferSizeEvent(int width, int height);
+
+// settings
+constexpr unsigned int SCR_WIDTH{800};
+constexpr unsigned int SCR_HEIGHT{600};
+constexpr int GRID_SIZE{60};
+
+// toggled with O
+bool occlusionCulling{true};
+
+int main(int argc, char* argv[])
+{
+    // --capture renders a fixed number of frames hidden and compares them with golden images
+    FrameCapture::Settings captureSettings;
+    const bool capture{FrameCapture::ParseArguments(argc, argv, captureSettings)};
+    Display window{SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", false, !capture};
+    std::optional<FrameCapture> frameCapture;
+    if(capture){
+        frameCapture.emplace(window, captureSettings);
+    }
+    auto& stateCache{GLStateCache::Current()};
+
+    Shader shader{"./shaders/coordinate_indirect.vert", "./shaders/coordinate.frag"};
+    ComputeProgram cullShader{"./shaders/cull.comp"};
+    ComputeProgram hiZCopyShader{"./shaders/hiz_copy.comp"};
+    ComputeProgram hiZDownsampleShader{"./shaders/hiz_downsample.comp"};
+
+    // indexed cube, 4 vertices per face so every face keeps its own texture coordinates
+    std::array vertices{
+        // positions          // texture coords
+        -0.5f, -0.5f, -0.5f, 0.0f, 0.0f,
+         0.5f, -0.5f, -0.5f, 1.0f, 0.0f,
+         0.5f,  0.5f, -0.5f, 1.0f, 1.0f,
+        -0.5f,  0.5f, -0.5f, 0.0f, 1.0f,
+
+        -0.5f, -0.5f,  0.5f, 0.0f, 0.0f,
+         0.5f, -0.5f,  0.5f, 1.0f, 0.0f,
+         0.5f,  0.5f,  0.5f, 1.0f, 1.0f,
+        -0.5f,  0.5f,  0.5f, 0.0f, 1.0f,
+
+        -0.5f,  0.5f,  0.5f, 1.0f, 0.0f,
+        -0.5f,  0.5f, -0.5f, 1.0f, 1.0f,
+        -0.5f, -0.5f, -0.5f, 0.0f, 1.0f,
+        -0.5f, -0.5f,  0.5f, 0.0f, 0.0f,
+
+         0.5f,  0.5f,  0.5f, 1.0f, 0.0f,
+         0.5f,  0.5f, -0.5f, 1.0f, 1.0f,
+         0.5f, -0.5f, -0.5f, 0.0f, 1.0f,
+         0.5f, -0.5f,  0.5f, 0.0f, 0.0f,
+
+        -0.5f, -0.5f, -0.5f, 0.0f, 1.0f,
+         0.5f, -0.5f, -0.5f, 1.0f, 1.0f,
+         0.5f, -0.5f,  0.5f, 1.0f, 0.0f,
+        -0.5f, -0.5f,  0.5f, 0.0f, 0.0f,
+
+        -0.5f,  0.5f, -0.5f, 0.0f, 1.0f,
+         0.5f,  0.5f, -0.5f, 1.0f, 1.0f,
+         0.5f,  0.5f,  0.5f, 1.0f, 0.0f,
+        -0.5f,  0.5f,  0.5f, 0.0f, 0.0f
+    };
+
+    std::array indices{
+         0u,  1u,  2u,  2u,  3u,  0u,
+         4u,  5u,  6u,  6u,  7u,  4u,
+         8u,  9u, 10u, 10u, 11u,  8u,
+        12u, 13u, 14u, 14u, 15u, 12u,
+        16u, 17u, 18u, 18u, 19u, 16u,
+        20u, 21u, 22u, 22u, 23u, 20u
+    };
+
+    unsigned int VAO, VBO, EBO;
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glGenBuffers(1, &EBO);
+
+    stateCache.BindVertexArray(VAO);
+    stateCache.BindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(vertices.front()), vertices.data(), GL_STATIC_DRAW);
+
+    // position attribute
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(float) * 5, reinterpret_cast<void*>(0));
+    glEnableVertexAttribArray(0);
+    // texture coordinate attribute
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(float) * 5, reinterpret_cast<void*>(3 * sizeof(vertices.front())));
+    glEnableVertexAttribArray(1);
+
+    stateCache.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(indices.front()), indices.data(), GL_STATIC_DRAW);
+
+    stateCache.BindVertexArray(0);
+
+    // a grid of cubes around the camera, most of them behind it or off to the side
+    std::vector<GpuObject> objects;
+    objects.reserve(GRID_SIZE * GRID_SIZE * GRID_SIZE);
+    for(int x{}; x < GRID_SIZE; ++x){
+        for(int y{}; y < GRID_SIZE; ++y){
+            for(int z{}; z < GRID_SIZE; ++z){
+                glm::vec3 position{glm::vec3(x, y, z) * 3.0f - glm::vec3{GRID_SIZE * 1.5f}};
+                glm::mat4 model{glm::translate(glm::mat4{1.0f}, position)};
+                model = glm::rotate(model, glm::radians(7.0f * (x + y + z)), glm::vec3(1.0f, 0.3f, 0.5f));
+                objects.push_back({model, glm::vec4{0.0f, 0.0f, 0.0f, 0.87f}});
+            }
+        }
+    }
+
+    GpuCuller culler{cullShader, objects.size()};
+    culler.SetObjects(objects.data(), objects.size());
+    culler.SetMesh(static_cast<unsigned int>(indices.size()));
+    culler.EnableObjectIndexAttribute(VAO, 2);
+
+    HiZPyramid hiZ{hiZCopyShader, hiZDownsampleShader};
+    GpuTimer sceneTimer;
+    GpuTimer hiZTimer;
+
+    Texture2D texture1{"./textures/container.jpg"};
+    Texture2D texture2{"./textures/awesomeface.png", true};
+
+    shader.Bind(); // don't forget to activate the shader before setting uniforms!
+    shader.SetUniform("texture1", 0);
+    shader.SetUniform("texture2", 1);
+
+    texture1.Bind(0);
+    texture2.Bind(1);
+
+    glm::mat4 projection{1.0f};
+    projection = glm::perspective(glm::radians(45.0f), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f);
+    shader.SetUniformMatrix("projection", projection);
+
+    // render loop
+    int frame{};
+    while(!window.IsClosed()){
+        // input and resizes seen by the last poll
+        HandleEvents(window);
+
+        window.Clear(0.2f, 0.3f, 0.3f, 1.0f);
+
+        // turn on the spot so different parts of the grid pass the culling
+        auto time{static_cast<float>(window.GetTime())};
+        glm::mat4 view{glm::lookAt(glm::vec3{0.0f}, glm::vec3{std::sin(time * 0.2f), 0.0f, -std::cos(time * 0.2f)},
+                                   glm::vec3{0.0f, 1.0f, 0.0f})};
+
+        // cull against the depth of the last frame, then draw
+        sceneTimer.Begin();
+        culler.SetOcclusion(occlusionCulling ? &hiZ : nullptr);
+        auto viewProjection{projection * view};
+        culler.Cull(viewProjection);
+
+        shader.Bind();
+        shader.SetUniformMatrix("view", view);
+        stateCache.BindVertexArray(VAO);
+        culler.Draw();
+        stateCache.BindVertexArray(0);
+        sceneTimer.End();
+
+        // the depth buffer is still intact before the swap
+        hiZTimer.Begin();
+        int width{}, height{};
+        glfwGetFramebufferSize(window, &width, &height);
+        hiZ.Build(width, height, viewProjection);
+        hiZTimer.End();
+
+        if(++frame % 120 == 0){
+            auto stats{culler.ReadStats()};
+            std::cout << "visible " << stats.visible << " of " << culler.GetObjectCount()
+                << ", frustum culled " << stats.frustumCulled << ", occlusion culled " << stats.occlusionCulled
+                << ", cull + draw " << sceneTimer.GetMilliseconds() << " ms, hi-z build " << hiZTimer.GetMilliseconds()
+                << " ms" << std::endl;
+        }
+
+        if(frameCapture){
+            frameCapture->EndFrame();
+        }
+
+        // check and call events and swap buffers
+        window.Update();
+    }
+
+    stateCache.DeleteVertexArray(VAO);
+    stateCache.DeleteBuffer(VBO);
+    stateCache.DeleteBuffer(EBO);
+
+    return frameCapture ? frameCapture->GetExitCode() : 0;
+}
+
+void HandleEvents(Display& display)
+{
+    Display::Event event;
+    while(display.PollEvent(event)){
+        switch(event.type){
+            case Display::EventType::Key:
+                KeyEvent(display, event.key, event.action);
+                break;
+
+            case Display::EventType::FramebufferSize:
+                FramebufferSizeEvent(event.width, event.height);
+                break;
+
+            default:
+                break;
+        }
+    }
+}
+
+void KeyEvent(Display& display, int key, int action)
+{
+    switch(key){
+        case GLFW_KEY_ESCAPE:
+        {
+            if(action == GLFW_PRESS){
+                display.SetClose();
+            }
+        }
+        break;
+
+        case GLFW_KEY_L:
+        {
+            if(action == GLFW_PRESS || action == GLFW_REPEAT){
+                GLStateCache::Current().PolygonMode(GL_LINE);
+            }
+            else{
+                GLStateCache::Current().PolygonMode(GL_FILL);
+            }
+        }
+        break;
+
+        case GLFW_KEY_O:
+        {
+            if(action == GLFW_PRESS){
+                occlusionCulling = !occlusionCulling;
+                std::cout << "occlusion culling " << (occlusionCulling ? "on" : "off") << std::endl;
+            }
+        }
+        break;
+
+        case GLFW_KEY_P:
+        {
+            if(action == GLFW_PRESS || action == GLFW_REPEAT){
+                GLStateCache::Current().PolygonMode(GL_POINT);
+                glPointSize(2.0f);
+            }
+            else{
+                GLStateCache::Current().PolygonMode(GL_FILL);
+                glPointSize(1.0f);
+            }
+        }
+        break;
+    }
+}
+
+void FramebufferSizeEvent(int width, int height)
+{
+    glViewport(0, 0, width, height);
+    //TODO later update any perspective matrices used here
+}
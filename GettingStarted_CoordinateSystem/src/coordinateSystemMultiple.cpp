@@ -1,22 +1,51 @@
+#include <algorithm>
 #include <array>
+#include <chrono>
 #include <iostream>
+#include <optional>
 
 #include "display.h"
+#include "frameCapture.h"
+#include "frameGrabber.h"
+#include "frustumCuller.h"
+#include "glStateCache.h"
+#include "gpuTimer.h"
+#include "mesh.h"
+#include "meshOptimizer.h"
+#include "renderQueue.h"
 #include "shader.h"
 #include "texture2D.h"
+#include "vertexQuantizer.h"
 
-void KeyCallback(Display::value_type* window, int key, int scancode, int action, int mods);
-void WindowSizeCallback(GLFWwindow* window, int width, int height);
+void HandleEvents(Display& display);
+void KeyEvent(Display& display, int key, int action);
+void FramebufferSizeEvent(int width, int height);
 
 // settings
 constexpr unsigned int SCR_WIDTH{800};
 constexpr unsigned int SCR_HEIGHT{600};
+constexpr float FAR_PLANE{100.0f};
+// R starts recording input, the next R saves it here, replay it with --capture <name> --input <file>
+constexpr const char* INPUT_FILE{"./input.events"};
 
-int main()
+// toggled with S, off issues the draws in the order the cubes are listed
+bool sortDraws{true};
+// toggled with Q, draws the cube with snorm16 positions and unorm16 texture coordinates
+bool quantizedVertices{true};
+// toggled with G, streams every frame into frames.rgba through a FrameGrabber to compare frame times
+bool grabFrames{false};
+
+int main(int argc, char* argv[])
 {
-    Display window{SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL"};
-    window.SetKeyCallback(KeyCallback);
-    window.SetWindowSizeCallback(WindowSizeCallback);
+    // --capture renders a fixed number of frames hidden and compares them with golden images
+    FrameCapture::Settings captureSettings;
+    const bool capture{FrameCapture::ParseArguments(argc, argv, captureSettings)};
+    Display window{SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", false, !capture};
+    std::optional<FrameCapture> frameCapture;
+    if(capture){
+        frameCapture.emplace(window, captureSettings);
+    }
+    auto& stateCache{GLStateCache::Current()};
 
     Shader shader{"./shaders/coordinate.vert", "./shaders/coordinate.frag"};
 
@@ -65,22 +94,28 @@ int main()
         -0.5f,  0.5f, -0.5f, 0.0f, 1.0f
     };
 
-    unsigned int VAO, VBO, EBO;
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
+    static_assert(sizeof(vertices) == PositionTexCoordLayout::Stride * 36, "vertices don't match the layout");
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(vertices.front()), vertices.data(), GL_STATIC_DRAW);
+    // the cube is listed as a triangle soup, weld the shared corners, reorder them for the caches and draw it indexed
+    auto welded{MeshOptimizer::Weld(vertices.data(), 36, PositionTexCoordLayout::Stride)};
+    MeshOptimizer::Optimize(welded);
+    auto indices{MeshOptimizer::PackIndices(welded.indices, welded.VertexCount())};
+    auto cubeCache{MeshOptimizer::AnalyzeVertexCache(welded.indices.data(), welded.indices.size(), welded.VertexCount())};
+    std::cout << "cube welded from " << welded.originalVertexCount << " to " << welded.VertexCount() << " vertices, "
+        << (indices.type == GL_UNSIGNED_SHORT ? 16 : 32) << " bit indices, vertex cache hits " << cubeCache.hits << "/"
+        << cubeCache.indices << ", ACMR " << cubeCache.acmr << " (unindexed 3.0), ATVR " << cubeCache.atvr << std::endl;
 
-    glBindVertexArray(VAO);
-    // position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(float) * 5, reinterpret_cast<void*>(0));
-    glEnableVertexAttribArray(0);
-    // texture coordinate attribute
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(float) * 5, reinterpret_cast<void*>(3 * sizeof(vertices.front())));
-    glEnableVertexAttribArray(1);
+    // same vertices packed into 12 bytes, the decode transform goes into the model matrix
+    auto quantized{VertexQuantizer::Quantize(welded.vertices.data(), welded.VertexCount(), welded.stride, 0, 3 * sizeof(float))};
+    std::cout << "cube quantized from " << welded.stride << " to " << quantized.stride << " bytes per vertex, position error max "
+        << quantized.error.maxPosition << ", texture coordinate error max " << quantized.error.maxTexCoord << std::endl;
+    const auto decode{quantized.transform.Matrix()};
 
-    glBindVertexArray(0);
+    VertexArrayCache vertexArrays;
+    Mesh cube{vertexArrays, PositionTexCoordLayout{}, welded.vertices.data(), welded.VertexCount(),
+              VertexStorage::Interleaved, indices.data.data(), indices.count, indices.type};
+    Mesh quantizedCube{vertexArrays, QuantizedPositionTexCoordLayout{}, quantized.vertices.data(), welded.VertexCount(),
+                       VertexStorage::Interleaved, indices.data.data(), indices.count, indices.type};
 
     Texture2D texture1{"./textures/container.jpg"};
     Texture2D texture2{"./textures/awesomeface.png", true};
@@ -89,9 +124,6 @@ int main()
     shader.SetUniform("texture1", 0);
     shader.SetUniform("texture2", 1);
 
-    texture1.Bind(0);
-    texture2.Bind(1);
-
     std::array cubePositions{
         glm::vec3{0.0f, 0.0f, 0.0f},
         glm::vec3{2.0f, 5.0f, -15.0f},
@@ -110,45 +142,143 @@ int main()
     shader.SetUniformMatrix("view", view);
 
     glm::mat4 projection{1.0f};
-    projection = glm::perspective(glm::radians(45.0f), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f);
+    projection = glm::perspective(glm::radians(45.0f), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, FAR_PLANE);
     shader.SetUniformMatrix("projection", projection);
 
+    // the cubes don't move, build their models and bounds once
+    std::array<glm::mat4, cubePositions.size()> models;
+    FrustumCuller culler{cubePositions.size()};
+    for(size_t i{}; i < cubePositions.size(); ++i){
+        glm::mat4 model{1.0f};
+        model = glm::translate(model, cubePositions[i]);
+        auto angle = glm::radians(20.0f * (float)i);
+        model = glm::rotate(model, angle, glm::vec3(1.0f, 0.3f, 0.5f));
+        models[i] = model;
+        culler.Add(model, glm::vec3{-0.5f}, glm::vec3{0.5f});
+    }
+
+    // two materials alternating between the cubes, so the draw order decides how often textures change
+    const std::array<std::array<unsigned int, DrawPacket::TextureCount>, 2> materials{{
+        {texture1, texture2},
+        {texture2, texture1}
+    }};
+    RenderQueue queue{cubePositions.size()};
+    GpuTimer drawTimer;
+    std::optional<FrameGrabber> grabber;
+
     // render loop
+    int frame{};
+    double frameMilliseconds{};
+    auto frameStart{std::chrono::steady_clock::now()};
     while(!window.IsClosed()){
+        // input and resizes seen by the last poll
+        HandleEvents(window);
+
         window.Clear(0.2f, 0.3f, 0.3f, 1.0f);
 
-        glBindVertexArray(VAO);
-        for(size_t i{}; i < cubePositions.size(); ++i){
-            glm::mat4 model{1.0f};
-            model = glm::translate(model, cubePositions[i]);
-            auto angle = glm::radians(20.0f * (float)i);
-            model = glm::rotate(model, angle, glm::vec3(1.0f, 0.3f, 0.5f));
-            shader.SetUniformMatrix("model", model);
-            
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+        // only draw the cubes inside the view frustum
+        queue.Clear();
+        const auto& mesh{quantizedVertices ? quantizedCube : cube};
+        for(auto i : culler.Cull(projection * view)){
+            DrawPacket packet{&shader, materials[i % materials.size()], mesh.GetVertexArray(), GL_TRIANGLES,
+                              0, static_cast<int>(mesh.GetDrawCount()), mesh.GetIndexType(),
+                              quantizedVertices ? models[i] * decode : models[i], &mesh};
+            auto viewDepth{-(view * models[i][3]).z};
+            queue.Submit(packet, viewDepth / FAR_PLANE);
         }
+        if(sortDraws){
+            queue.Sort();
+        }
+        drawTimer.Begin();
+        queue.Execute();
+        drawTimer.End();
+
+        stateCache.BindVertexArray(0);
 
-        glBindVertexArray(0);
+        if(++frame % 300 == 0){
+            const auto& stats{queue.GetStats()};
+            std::cout << (sortDraws ? "sorted" : "unsorted") << " " << stats.packets << " draws, program changes "
+                << stats.programChanges << ", texture changes " << stats.textureChanges << ", vertex array changes "
+                << stats.vertexArrayChanges << ", sort " << stats.sortMilliseconds << " ms\n";
+            std::cout << (quantizedVertices ? "quantized" : "float") << " vertices, " << mesh.GetMemorySize()
+                << " bytes of mesh data, draws took " << drawTimer.GetMilliseconds() << " ms on the GPU\n";
+            auto total{stateCache.GetTotal()};
+            std::cout << "state changes requested " << total.requested << ", filtered " << total.filtered << "\n";
+            std::cout << "cpu frame time " << frameMilliseconds / 300.0 << " ms" << (grabFrames ? " while grabbing" : "") << "\n";
+            frameMilliseconds = 0.0;
+            if(grabber){
+                auto grabStats{grabber->GetStats()};
+                std::cout << "grabbed " << grabStats.grabbed << " frames, " << grabStats.dropped << " dropped, "
+                    << grabStats.stalls << " stalls, " << (grabStats.grabbed != 0 ? grabStats.renderMilliseconds / grabStats.grabbed : 0.0)
+                    << " ms per frame on the render thread, "
+                    << (grabStats.consumed != 0 ? grabStats.consumerMilliseconds / grabStats.consumed : 0.0) << " ms per frame writing\n";
+                grabber->ResetStats();
+            }
+            for(int state{}; state < static_cast<int>(GLStateCache::State::Count); ++state){
+                const auto& counters{stateCache.GetCounters(static_cast<GLStateCache::State>(state))};
+                std::cout << "    " << GLStateCache::GetName(static_cast<GLStateCache::State>(state))
+                    << " " << counters.filtered << "/" << counters.requested << "\n";
+            }
+            std::cout << std::flush;
+            stateCache.ResetCounters();
+        }
+
+        if(frameCapture){
+            frameCapture->EndFrame();
+        }
+
+        if(grabFrames && window.GetFrameGrabber() == nullptr){
+            if(!grabber){
+                int width{}, height{};
+                glfwGetFramebufferSize(window, &width, &height);
+                grabber.emplace(width, height, FrameGrabber::RawWriter("./frames.rgba"));
+            }
+            grabber->ResetStats();
+            window.SetFrameGrabber(&*grabber);
+        }
+        else if(!grabFrames && window.GetFrameGrabber() != nullptr){
+            window.SetFrameGrabber(nullptr);
+            grabber->Flush();
+        }
 
         // check and call events and swap buffers
         window.Update();
+
+        auto frameEnd{std::chrono::steady_clock::now()};
+        frameMilliseconds += std::chrono::duration<double, std::milli>(frameEnd - frameStart).count();
+        frameStart = frameEnd;
     }
+    window.SetFrameGrabber(nullptr);
 
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteBuffers(1, &EBO);
+    return frameCapture ? frameCapture->GetExitCode() : 0;
+}
+
+void HandleEvents(Display& display)
+{
+    Display::Event event;
+    while(display.PollEvent(event)){
+        switch(event.type){
+            case Display::EventType::Key:
+                KeyEvent(display, event.key, event.action);
+                break;
 
-    return 0;
+            case Display::EventType::FramebufferSize:
+                FramebufferSizeEvent(event.width, event.height);
+                break;
+
+            default:
+                break;
+        }
+    }
 }
 
-void KeyCallback(Display::value_type* window, int key, int scancode, int action, int mods)
+void KeyEvent(Display& display, int key, int action)
 {
-    auto display = Display::GetWindowUserPointer(window);
     switch(key){
         case GLFW_KEY_ESCAPE:
         {
             if(action == GLFW_PRESS){
-                display->SetClose();
+                display.SetClose();
             }
         }
         break;
@@ -156,10 +286,55 @@ void KeyCallback(Display::value_type* window, int key, int scancode, int action,
         case GLFW_KEY_L:
         {
             if(action == GLFW_PRESS || action == GLFW_REPEAT){
-                glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+                GLStateCache::Current().PolygonMode(GL_LINE);
             }
             else{
-                glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+                GLStateCache::Current().PolygonMode(GL_FILL);
+            }
+        }
+        break;
+
+        case GLFW_KEY_S:
+        {
+            if(action == GLFW_PRESS){
+                sortDraws = !sortDraws;
+            }
+        }
+        break;
+
+        case GLFW_KEY_Q:
+        {
+            if(action == GLFW_PRESS){
+                quantizedVertices = !quantizedVertices;
+            }
+        }
+        break;
+
+        case GLFW_KEY_G:
+        {
+            if(action == GLFW_PRESS){
+                grabFrames = !grabFrames;
+            }
+        }
+        break;
+
+        case GLFW_KEY_R:
+        {
+            if(action == GLFW_PRESS){
+                if(!display.IsRecording()){
+                    display.StartRecording();
+                    std::cout << "recording input" << std::endl;
+                }
+                else{
+                    auto events{display.StopRecording()};
+                    // the R presses toggling the recording aren't part of it
+                    events.erase(std::remove_if(events.begin(), events.end(), [](const Display::Event& event){
+                        return event.type == Display::EventType::Key && event.key == GLFW_KEY_R;
+                    }), events.end());
+                    if(Display::SaveEvents(INPUT_FILE, events)){
+                        std::cout << events.size() << " input events saved to " << INPUT_FILE << std::endl;
+                    }
+                }
             }
         }
         break;
@@ -167,11 +342,11 @@ void KeyCallback(Display::value_type* window, int key, int scancode, int action,
         case GLFW_KEY_P:
         {
             if(action == GLFW_PRESS || action == GLFW_REPEAT){
-                glPolygonMode(GL_FRONT_AND_BACK, GL_POINT);
+                GLStateCache::Current().PolygonMode(GL_POINT);
                 glPointSize(2.0f);
             }
             else{
-                glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+                GLStateCache::Current().PolygonMode(GL_FILL);
                 glPointSize(1.0f);
             }
         }
@@ -179,7 +354,7 @@ void KeyCallback(Display::value_type* window, int key, int scancode, int action,
     }
 }
 
-void WindowSizeCallback(GLFWwindow* window, int width, int height)
+void FramebufferSizeEvent(int width, int height)
 {
     glViewport(0, 0, width, height);
     //TODO later update any perspective matrices used here
@@ -0,0 +1,364 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "commandBuffer.h"
+#include "display.h"
+#include "frameCapture.h"
+#include "frustumCuller.h"
+#include "glStateCache.h"
+#include "gltfImporter.h"
+#include "gltfModel.h"
+#include "jobSystem.h"
+#include "lodSelector.h"
+#include "mesh.h"
+#include "meshFile.h"
+#include "renderQueue.h"
+#include "shader.h"
+#include "texture2D.h"
+
+void HandleEvents(Display& display);
+void KeyEvent(Display& display, int key, int action);
+void FramebufferSizeEvent(int width, int height);
+
+// settings
+constexpr unsigned int SCR_WIDTH{800};
+constexpr unsigned int SCR_HEIGHT{600};
+constexpr float FAR_PLANE{100.0f};
+constexpr int GRID_SIZE{40};
+
+// toggled with T, off records every command on the GL thread
+bool parallelRecording{true};
+// toggled with O, off draws every sphere at full detail
+bool lodSelection{true};
+
+int main(int argc, char* argv[])
+{
+    // --gltf <file> places a glTF scene in front of the camera, the other arguments go to FrameCapture
+    std::string gltfPath;
+    std::vector<char*> captureArguments{argv, argv + argc};
+    auto gltfArgument{std::find(captureArguments.begin() + 1, captureArguments.end(), std::string_view{"--gltf"})};
+    if(gltfArgument != captureArguments.end() && gltfArgument + 1 != captureArguments.end()){
+        gltfPath = *(gltfArgument + 1);
+        captureArguments.erase(gltfArgument, gltfArgument + 2);
+    }
+
+    // --capture renders a fixed number of frames hidden and compares them with golden images
+    FrameCapture::Settings captureSettings;
+    const bool capture{FrameCapture::ParseArguments(static_cast<int>(captureArguments.size()), captureArguments.data(),
+                                                    captureSettings)};
+    Display window{SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", false, !capture};
+    std::optional<FrameCapture> frameCapture;
+    if(capture){
+        frameCapture.emplace(window, captureSettings);
+    }
+    auto& stateCache{GLStateCache::Current()};
+
+    Shader shader{"./shaders/coordinate.vert", "./shaders/coordinate.frag"};
+
+    // cubes and spheres come from converted mesh files, mapped and uploaded without parsing,
+    // the sphere file holds a chain of simplified levels of detail behind the full mesh
+    MeshFile cubeFile{"./meshes/cube.mesh"};
+    MeshFile sphereFile{"./meshes/sphere.mesh"};
+    if(!cubeFile.IsValid() || !sphereFile.IsValid()){
+        return -1;
+    }
+    VertexArrayCache vertexArrays;
+    Mesh cube{vertexArrays, cubeFile.GetLayout(), cubeFile.GetVertices(), cubeFile.GetVertexCount(),
+              VertexStorage::Interleaved, cubeFile.GetIndices(), cubeFile.GetIndexCount(), cubeFile.GetIndexType()};
+    Mesh sphere{vertexArrays, sphereFile.GetLayout(), sphereFile.GetVertices(), sphereFile.GetVertexCount(),
+                VertexStorage::Interleaved, sphereFile.GetIndices(), sphereFile.GetIndexCount(), sphereFile.GetIndexType()};
+
+    // the grid alternates the shapes, everything per shape is indexed with i % ShapeCount
+    constexpr std::size_t ShapeCount{2};
+    const std::array<const MeshFile*, ShapeCount> shapeFiles{&cubeFile, &sphereFile};
+    const std::array<const Mesh*, ShapeCount> shapeMeshes{&cube, &sphere};
+    std::array<glm::vec3, ShapeCount> boundsMin, boundsMax;
+    std::array<float, ShapeCount> radii;
+    std::array<glm::mat4, ShapeCount> decodes;
+    for(std::size_t shape{}; shape < ShapeCount; ++shape){
+        const auto& header{shapeFiles[shape]->GetHeader()};
+        boundsMin[shape] = glm::vec3{header.boundsMin[0], header.boundsMin[1], header.boundsMin[2]};
+        boundsMax[shape] = glm::vec3{header.boundsMax[0], header.boundsMax[1], header.boundsMax[2]};
+        radii[shape] = 0.5f * glm::length(boundsMax[shape] - boundsMin[shape]);
+        decodes[shape] = shapeFiles[shape]->GetDecodeMatrix();
+    }
+
+    Texture2D texture1{"./textures/container.jpg"};
+    Texture2D texture2{"./textures/awesomeface.png", true};
+
+    shader.Bind(); // don't forget to activate the shader before setting uniforms!
+    shader.SetUniform("texture1", 0);
+    shader.SetUniform("texture2", 1);
+
+    glm::mat4 projection{1.0f};
+    projection = glm::perspective(glm::radians(45.0f), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, FAR_PLANE);
+    shader.SetUniformMatrix("projection", projection);
+    LodSelector lodSelector{projection, static_cast<float>(SCR_HEIGHT)};
+
+    JobSystem jobs;
+
+    std::optional<GltfModel> gltfModel;
+    std::vector<GltfModel::DrawItem> gltfItems;
+    if(!gltfPath.empty()){
+        GltfImporter::Scene scene;
+        if(!GltfImporter::Load(gltfPath, jobs, scene)){
+            return -1;
+        }
+        gltfModel.emplace(vertexArrays, scene);
+        scene.timings.Print(std::cout);
+        std::cout << gltfModel->GetDrawItems().size() << " glTF draws, GL upload " << gltfModel->GetUploadMilliseconds()
+            << " ms" << std::endl;
+        gltfItems = gltfModel->GetDrawItems();
+    }
+
+    // a grid of cubes and spheres around the camera, followed by the glTF draws
+    constexpr std::size_t gridCount{GRID_SIZE * GRID_SIZE * GRID_SIZE};
+    std::vector<glm::mat4> models;
+    models.reserve(gridCount + gltfItems.size());
+    FrustumCuller culler{models.capacity()};
+    for(int x{}; x < GRID_SIZE; ++x){
+        for(int y{}; y < GRID_SIZE; ++y){
+            for(int z{}; z < GRID_SIZE; ++z){
+                glm::vec3 position{glm::vec3(x, y, z) * 3.0f - glm::vec3{GRID_SIZE * 1.5f}};
+                glm::mat4 model{glm::translate(glm::mat4{1.0f}, position)};
+                model = glm::rotate(model, glm::radians(7.0f * (x + y + z)), glm::vec3(1.0f, 0.3f, 0.5f));
+                auto shape{models.size() % ShapeCount};
+                models.push_back(model);
+                culler.Add(model, boundsMin[shape], boundsMax[shape]);
+            }
+        }
+    }
+
+    // the glTF scene scaled to 2 units, in front of the camera's start direction between two grid cubes
+    if(!gltfItems.empty()){
+        glm::vec3 sceneMin{std::numeric_limits<float>::max()};
+        glm::vec3 sceneMax{std::numeric_limits<float>::lowest()};
+        for(const auto& item : gltfItems){
+            for(int corner{}; corner < 8; ++corner){
+                glm::vec3 local{(corner & 1) ? item.boundsMax.x : item.boundsMin.x, (corner & 2) ? item.boundsMax.y : item.boundsMin.y,
+                                (corner & 4) ? item.boundsMax.z : item.boundsMin.z};
+                glm::vec3 world{item.world * glm::vec4{local, 1.0f}};
+                sceneMin = glm::min(sceneMin, world);
+                sceneMax = glm::max(sceneMax, world);
+            }
+        }
+        auto extent{std::max(sceneMax.x - sceneMin.x, std::max(sceneMax.y - sceneMin.y, sceneMax.z - sceneMin.z))};
+        glm::mat4 placement{glm::translate(glm::mat4{1.0f}, glm::vec3{0.0f, 0.0f, -4.5f})};
+        placement = glm::scale(placement, glm::vec3{extent > 0.0f ? 2.0f / extent : 1.0f});
+        placement = glm::translate(placement, -0.5f * (sceneMin + sceneMax));
+        for(const auto& item : gltfItems){
+            models.push_back(placement * item.world);
+            culler.Add(models.back(), item.boundsMin, item.boundsMax);
+        }
+    }
+
+    const std::array<std::array<unsigned int, DrawPacket::TextureCount>, 2> materials{{
+        {texture1, texture2},
+        {texture2, texture1}
+    }};
+
+    // each job culls a slice of the grid, picks a level of detail for the visible objects and records them,
+    // no GL calls off the main thread
+    const unsigned int workerCount{jobs.GetThreadCount()};
+    std::vector<CommandBuffer> commandBuffers(workerCount);
+    std::vector<std::vector<std::uint32_t>> visible(workerCount);
+    // objects drawn per LOD and the triangles they would have cost at full detail, per worker
+    std::vector<std::array<std::size_t, MeshFileHeader::MaxLods>> lodCounts(workerCount);
+    std::vector<std::size_t> fullDetailTriangles(workerCount);
+    auto record = [&](unsigned int worker, unsigned int workers, const glm::mat4& view){
+        // slices start on a batch boundary of the culler
+        auto batches{(models.size() + FrustumCuller::BatchWidth - 1) / FrustumCuller::BatchWidth};
+        auto first{std::min(batches * worker / workers * FrustumCuller::BatchWidth, models.size())};
+        auto last{std::min(batches * (worker + 1) / workers * FrustumCuller::BatchWidth, models.size())};
+
+        auto& commands{commandBuffers[worker]};
+        auto& slice{visible[worker]};
+        commands.Clear();
+        slice.clear();
+        lodCounts[worker].fill(0);
+        fullDetailTriangles[worker] = 0;
+        culler.CullRange(FrustumCuller::ExtractPlanes(projection * view), first, last, slice);
+        for(auto i : slice){
+            if(i >= gridCount){
+                // glTF draws have no levels of detail, untextured ones keep the grid's textures
+                const auto& item{gltfItems[i - gridCount]};
+                const auto* mesh{item.mesh};
+                std::array<unsigned int, DrawPacket::TextureCount> textures{texture1, texture2};
+                if(item.texture != nullptr){
+                    textures = {*item.texture, *item.texture};
+                }
+                DrawPacket packet{&shader, textures, mesh->GetVertexArray(), GL_TRIANGLES, 0,
+                                  static_cast<int>(mesh->GetDrawCount()), mesh->GetIndexType(), models[i], mesh};
+                commands.Record(packet, -(view * models[i][3]).z / FAR_PLANE);
+                ++lodCounts[worker][0];
+                fullDetailTriangles[worker] += mesh->GetDrawCount() / 3;
+                continue;
+            }
+            auto shape{i % ShapeCount};
+            const auto* mesh{shapeMeshes[shape]};
+            auto lods{shapeFiles[shape]->GetLods()};
+            auto viewDepth{-(view * models[i][3]).z};
+            auto lod{lodSelection ? lodSelector.Select(lods, radii[shape], viewDepth) : 0};
+            DrawPacket packet{&shader, materials[i % materials.size()], mesh->GetVertexArray(), GL_TRIANGLES,
+                              static_cast<int>(lods[lod].firstIndex), static_cast<int>(lods[lod].indexCount),
+                              mesh->GetIndexType(), models[i] * decodes[shape], mesh};
+            commands.Record(packet, viewDepth / FAR_PLANE);
+            ++lodCounts[worker][lod];
+            fullDetailTriangles[worker] += lods[0].indexCount / 3;
+        }
+    };
+
+    RenderQueue queue{models.size()};
+
+    // render loop
+    int frame{};
+    double recordMilliseconds{};
+    while(!window.IsClosed()){
+        // input and resizes seen by the last poll
+        HandleEvents(window);
+
+        window.Clear(0.2f, 0.3f, 0.3f, 1.0f);
+
+        // turn on the spot so different parts of the grid are recorded
+        auto time{static_cast<float>(window.GetTime())};
+        glm::mat4 view{glm::lookAt(glm::vec3{0.0f}, glm::vec3{std::sin(time * 0.2f), 0.0f, -std::cos(time * 0.2f)},
+                                   glm::vec3{0.0f, 1.0f, 0.0f})};
+
+        auto start{std::chrono::steady_clock::now()};
+        auto workers{parallelRecording ? workerCount : 1u};
+        JobCounter recorded;
+        for(unsigned int worker{1}; worker < workers; ++worker){
+            jobs.Run([&record, worker, workers, &view](){ record(worker, workers, view); }, &recorded);
+        }
+        record(0, workers, view);
+        jobs.Wait(recorded);
+
+        // merge in worker order, the sort makes the result independent of the thread count
+        queue.Clear();
+        for(unsigned int worker{}; worker < workers; ++worker){
+            queue.Submit(commandBuffers[worker]);
+        }
+        queue.Sort();
+        recordMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        shader.Bind();
+        shader.SetUniformMatrix("view", view);
+        queue.Execute();
+        stateCache.BindVertexArray(0);
+
+        if(++frame % 120 == 0){
+            const auto& stats{queue.GetStats()};
+            std::cout << workers << " recording threads, " << stats.packets << " draws, record + merge + sort "
+                << recordMilliseconds / 120.0 << " ms per frame (sort " << stats.sortMilliseconds << " ms)" << std::endl;
+            std::array<std::size_t, MeshFileHeader::MaxLods> lodTotals{};
+            std::size_t fullDetail{};
+            for(unsigned int worker{}; worker < workers; ++worker){
+                for(std::size_t lod{}; lod < lodTotals.size(); ++lod){
+                    lodTotals[lod] += lodCounts[worker][lod];
+                }
+                fullDetail += fullDetailTriangles[worker];
+            }
+            std::cout << stats.triangles << " triangles of " << fullDetail << " at full detail, objects per LOD";
+            for(std::size_t lod{}; lod < sphereFile.GetLods().size(); ++lod){
+                std::cout << " " << lodTotals[lod];
+            }
+            std::cout << (lodSelection ? "" : " (LOD selection off)") << std::endl;
+            recordMilliseconds = 0.0;
+            jobs.PrintUtilization(std::cout);
+            jobs.ResetStats();
+        }
+
+        if(frameCapture){
+            frameCapture->EndFrame();
+        }
+
+        // check and call events and swap buffers
+        window.Update();
+    }
+
+    return frameCapture ? frameCapture->GetExitCode() : 0;
+}
+
+void HandleEvents(Display& display)
+{
+    Display::Event event;
+    while(display.PollEvent(event)){
+        switch(event.type){
+            case Display::EventType::Key:
+                KeyEvent(display, event.key, event.action);
+                break;
+
+            case Display::EventType::FramebufferSize:
+                FramebufferSizeEvent(event.width, event.height);
+                break;
+
+            default:
+                break;
+        }
+    }
+}
+
+void KeyEvent(Display& display, int key, int action)
+{
+    switch(key){
+        case GLFW_KEY_ESCAPE:
+        {
+            if(action == GLFW_PRESS){
+                display.SetClose();
+            }
+        }
+        break;
+
+        case GLFW_KEY_L:
+        {
+            if(action == GLFW_PRESS || action == GLFW_REPEAT){
+                GLStateCache::Current().PolygonMode(GL_LINE);
+            }
+            else{
+                GLStateCache::Current().PolygonMode(GL_FILL);
+            }
+        }
+        break;
+
+        case GLFW_KEY_T:
+        {
+            if(action == GLFW_PRESS){
+                parallelRecording = !parallelRecording;
+            }
+        }
+        break;
+
+        case GLFW_KEY_O:
+        {
+            if(action == GLFW_PRESS){
+                lodSelection = !lodSelection;
+            }
+        }
+        break;
+
+        case GLFW_KEY_P:
+        {
+            if(action == GLFW_PRESS || action == GLFW_REPEAT){
+                GLStateCache::Current().PolygonMode(GL_POINT);
+                glPointSize(2.0f);
+            }
+            else{
+                GLStateCache::Current().PolygonMode(GL_FILL);
+                glPointSize(1.0f);
+            }
+        }
+        break;
+    }
+}
+
+void FramebufferSizeEvent(int width, int height)
+{
+    glViewport(0, 0, width, height);
+}
@@ -1,22 +1,38 @@
 #include <array>
 #include <iostream>
+#include <optional>
 
 #include "display.h"
+#include "frameCapture.h"
+#include "frameLoop.h"
+#include "glStateCache.h"
 #include "shader.h"
 #include "texture2D.h"
 
-void KeyCallback(Display::value_type* window, int key, int scancode, int action, int mods);
-void WindowSizeCallback(GLFWwindow* window, int width, int height);
+void HandleEvents(Display& display);
+void KeyEvent(Display& display, int key, int action);
+void FramebufferSizeEvent(int width, int height);
 
 // settings
 constexpr unsigned int SCR_WIDTH{800};
 constexpr unsigned int SCR_HEIGHT{600};
+constexpr double UPDATE_RATE{60.0};
+constexpr double LIMITED_FRAME_RATE{30.0};
 
-int main()
+// toggled with F, caps the frame rate, the cubes keep turning at the same speed
+bool limitFrameRate{false};
+
+int main(int argc, char* argv[])
 {
-    Display window{SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL"};
-    window.SetKeyCallback(KeyCallback);
-    window.SetWindowSizeCallback(WindowSizeCallback);
+    // --capture renders a fixed number of frames hidden and compares them with golden images
+    FrameCapture::Settings captureSettings;
+    const bool capture{FrameCapture::ParseArguments(argc, argv, captureSettings)};
+    Display window{SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", false, !capture};
+    std::optional<FrameCapture> frameCapture;
+    if(capture){
+        frameCapture.emplace(window, captureSettings);
+    }
+    auto& stateCache{GLStateCache::Current()};
 
     Shader shader{"./shaders/coordinate.vert", "./shaders/coordinate.frag"};
 
@@ -69,10 +85,10 @@ int main()
     glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    stateCache.BindBuffer(GL_ARRAY_BUFFER, VBO);
     glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(vertices.front()), vertices.data(), GL_STATIC_DRAW);
 
-    glBindVertexArray(VAO);
+    stateCache.BindVertexArray(VAO);
     // position attribute
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(float) * 5, reinterpret_cast<void*>(0));
     glEnableVertexAttribArray(0);
@@ -80,7 +96,7 @@ int main()
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(float) * 5, reinterpret_cast<void*>(3 * sizeof(vertices.front())));
     glEnableVertexAttribArray(1);
 
-    glBindVertexArray(0);
+    stateCache.BindVertexArray(0);
 
     Texture2D texture1{"./textures/container.jpg"};
     Texture2D texture2{"./textures/awesomeface.png", true};
@@ -113,17 +129,32 @@ int main()
     projection = glm::perspective(glm::radians(45.0f), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f);
     shader.SetUniformMatrix("projection", projection);
 
-    // render loop
-    while(!window.IsClosed()){
+    // the turning cubes advance on a fixed step, drawing blends the last two steps
+    Interpolated<float> degrees;
+    FrameLoop::Settings loopSettings;
+    loopSettings.updateRate = UPDATE_RATE;
+    loopSettings.reportInterval = 5.0;
+    FrameLoop loop{window, loopSettings};
+
+    auto update = [&degrees](double step){
+        degrees.Store();
+        degrees.Current() += 50.0f * static_cast<float>(step);
+    };
+
+    auto render = [&](float alpha){
+        // input and resizes seen by the last poll
+        HandleEvents(window);
+
+        loop.SetMaxFrameRate(limitFrameRate ? LIMITED_FRAME_RATE : 0.0);
         window.Clear(0.2f, 0.3f, 0.3f, 1.0f);
 
-        glBindVertexArray(VAO);
+        stateCache.BindVertexArray(VAO);
         for(size_t i{}; i < cubePositions.size(); ++i){
             glm::mat4 model{1.0f};
             model = glm::translate(model, cubePositions[i]);
             auto angle = glm::radians(20.0f * (float)i);
             if((i % 3 == 0)){
-                angle = glm::radians(50.0f * (float)glfwGetTime());
+                angle = glm::radians(degrees.Get(alpha));
             }
             model = glm::rotate(model, angle, glm::vec3(1.0f, 0.3f, 0.5f));
             shader.SetUniformMatrix("model", model);
@@ -131,27 +162,73 @@ int main()
             glDrawArrays(GL_TRIANGLES, 0, 36);
         }
 
-        glBindVertexArray(0);
+        stateCache.BindVertexArray(0);
 
-        // check and call events and swap buffers
-        window.Update();
-    }
+        if(frameCapture){
+            frameCapture->EndFrame();
+        }
+    };
 
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteBuffers(1, &EBO);
+    // render loop, FrameLoop swaps buffers and polls events
+    loop.Run(update, render);
 
-    return 0;
+    stateCache.DeleteVertexArray(VAO);
+    stateCache.DeleteBuffer(VBO);
+    stateCache.DeleteBuffer(EBO);
+
+    return frameCapture ? frameCapture->GetExitCode() : 0;
 }
 
-void KeyCallback(Display::value_type* window, int key, int scancode, int action, int mods)
+void HandleEvents(Display& display)
+{
+    Display::Event event;
+    while(display.PollEvent(event)){
+        switch(event.type){
+            case Display::EventType::Key:
+                KeyEvent(display, event.key, event.action);
+                break;
+
+            case Display::EventType::FramebufferSize:
+                FramebufferSizeEvent(event.width, event.height);
+                break;
+
+            default:
+                break;
+        }
+    }
+}
+
+void KeyEvent(Display& display, int key, int action)
 {
-    auto display = Display::GetWindowUserPointer(window);
     switch(key){
         case GLFW_KEY_ESCAPE:
         {
             if(action == GLFW_PRESS){
-                display->SetClose();
+                display.SetClose();
+            }
+        }
+        break;
+
+        case GLFW_KEY_V:
+        {
+            // cycles vsync off, on, adaptive and late swap tear, printing the latency of the mode it leaves
+            if(action == GLFW_PRESS){
+                auto latency{display.GetLatencyStats()};
+                std::cout << Display::GetSwapModeName(display.GetSwapMode()) << ": input to photon " << latency.averageMilliseconds
+                    << " ms average, " << latency.minMilliseconds << " to " << latency.maxMilliseconds << " ms over "
+                    << latency.samples << " presses, " << latency.lateSwaps << " late swaps" << std::endl;
+                auto next{(static_cast<int>(display.GetSwapMode()) + 1) % 4};
+                display.SetSwapMode(static_cast<Display::SwapMode>(next));
+                display.ResetLatencyStats();
+                std::cout << "switched to " << Display::GetSwapModeName(display.GetSwapMode()) << std::endl;
+            }
+        }
+        break;
+
+        case GLFW_KEY_F:
+        {
+            if(action == GLFW_PRESS){
+                limitFrameRate = !limitFrameRate;
             }
         }
         break;
@@ -159,10 +236,10 @@ void KeyCallback(Display::value_type* window, int key, int scancode, int action,
         case GLFW_KEY_L:
         {
             if(action == GLFW_PRESS || action == GLFW_REPEAT){
-                glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+                GLStateCache::Current().PolygonMode(GL_LINE);
             }
             else{
-                glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+                GLStateCache::Current().PolygonMode(GL_FILL);
             }
         }
         break;
@@ -170,11 +247,11 @@ void KeyCallback(Display::value_type* window, int key, int scancode, int action,
         case GLFW_KEY_P:
         {
             if(action == GLFW_PRESS || action == GLFW_REPEAT){
-                glPolygonMode(GL_FRONT_AND_BACK, GL_POINT);
+                GLStateCache::Current().PolygonMode(GL_POINT);
                 glPointSize(2.0f);
             }
             else{
-                glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+                GLStateCache::Current().PolygonMode(GL_FILL);
                 glPointSize(1.0f);
             }
         }
@@ -182,7 +259,7 @@ void KeyCallback(Display::value_type* window, int key, int scancode, int action,
     }
 }
 
-void WindowSizeCallback(GLFWwindow* window, int width, int height)
+void FramebufferSizeEvent(int width, int height)
 {
     glViewport(0, 0, width, height);
     //TODO later update any perspective matrices used here
@@ -1,9 +1,25 @@
 #include "display.h"
+#include "frameGrabber.h"
+#include "glStateCache.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
 #include <iostream>
 #include <sstream>
+#include <type_traits>
+#include <utility>
 
-Display::Display(int width, int height, const std::basic_string_view<char> title, bool fullscreen)
-    : m_window{nullptr}, m_isClosed{}, m_windowName{title}
+namespace
+{
+    // event files start with the magic and the size of Event, a build with a different layout can't misread them
+    constexpr char EventFileMagic[4]{'E', 'V', 'T', '1'};
+}
+
+Display::Display(int width, int height, const std::basic_string_view<char> title, bool fullscreen, bool visible)
+    : m_window{nullptr}, m_isClosed{}, m_frameCount{}, m_fixedTimeStep{}, m_frameGrabber{},
+    m_swapMode{SwapMode::On}, m_softwareLateSwap{}, m_hasSwapControlTear{}, m_swapInterval{-2}, m_refreshPeriod{1.0 / 60.0},
+    m_lastSwapTime{}, m_pendingInputTime{-1.0}, m_frameInputTime{-1.0}, m_latencySum{}, m_latency{},
+    m_events{}, m_droppedEvents{}, m_recording{}, m_recordStart{}, m_replaying{}, m_replayStart{}, m_replayNext{}, m_windowName{title}
 {
     glfwSetErrorCallback(DisplayErrorCallback);
     if(glfwInit() == GLFW_FALSE){
@@ -14,6 +30,7 @@ Display::Display(int width, int height, const std::basic_string_view<char> title
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, visible ? GLFW_TRUE : GLFW_FALSE);
     //glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GL_TRUE);
 
     // The monitor to use for full screen mode, or NULL for windowed mode.
@@ -50,6 +67,23 @@ Display::Display(int width, int height, const std::basic_string_view<char> title
 
     glfwSetWindowUserPointer(m_window, this);	// to use callback functions from classes
     glfwSetWindowCloseCallback(m_window, DisplayWindowCloseCallback);  // keep this internal
+    // the rest only queue events, m_keyCallback and m_resizeCallback are still forwarded to
+    glfwSetKeyCallback(m_window, DisplayKeyCallback);
+    glfwSetMouseButtonCallback(m_window, DisplayMouseButtonCallback);
+    glfwSetCursorPosCallback(m_window, DisplayCursorPositionCallback);
+    glfwSetScrollCallback(m_window, DisplayScrollCallback);
+    glfwSetWindowSizeCallback(m_window, DisplayWindowSizeCallback);
+    glfwSetFramebufferSizeCallback(m_window, DisplayFramebufferSizeCallback);
+
+    // WGL on Windows, GLX on X11
+    m_hasSwapControlTear = glfwExtensionSupported("WGL_EXT_swap_control_tear") == GLFW_TRUE ||
+        glfwExtensionSupported("GLX_EXT_swap_control_tear") == GLFW_TRUE;
+    const auto* videoMode{glfwGetVideoMode(monitor != nullptr ? monitor : glfwGetPrimaryMonitor())};
+    if(videoMode != nullptr && videoMode->refreshRate > 0){
+        m_refreshPeriod = 1.0 / videoMode->refreshRate;
+    }
+    SetSwapMode(SwapMode::On);
+    m_lastSwapTime = glfwGetTime();
 
     int flags;
     glGetIntegerv(GL_CONTEXT_FLAGS, &flags);
@@ -70,14 +104,44 @@ Display::~Display()
 void Display::Clear(float r, float g, float b, float a) const
 {
     glClearColor(r, g, b, a);
-    glEnable(GL_DEPTH_TEST);
+    GLStateCache::Current().Enable(GL_DEPTH_TEST);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
 
 void Display::Update()
 {
+    if(m_frameGrabber != nullptr){
+        m_frameGrabber->Grab(m_frameCount);
+    }
+
+    if(m_softwareLateSwap){
+        // a frame slower than a refresh already missed its vertical blank, waiting for the next costs a whole one
+        bool late{glfwGetTime() - m_lastSwapTime > m_refreshPeriod};
+        m_latency.lateSwaps += late ? 1 : 0;
+        SetSwapInterval(late ? 0 : 1);
+    }
     glfwSwapBuffers(m_window);
+    m_lastSwapTime = glfwGetTime();
+
+    if(m_frameInputTime >= 0.0){
+        auto milliseconds{(m_lastSwapTime - m_frameInputTime + m_refreshPeriod * 0.5) * 1000.0};
+        m_latency.minMilliseconds = m_latency.samples == 0 ? milliseconds : std::min(m_latency.minMilliseconds, milliseconds);
+        m_latency.maxMilliseconds = std::max(m_latency.maxMilliseconds, milliseconds);
+        m_latencySum += milliseconds;
+        ++m_latency.samples;
+    }
+
+    // presses seen by this poll are handled by the next frame
     glfwPollEvents();
+    if(m_replaying){
+        ReplayEvents();
+    }
+    m_frameInputTime = m_pendingInputTime;
+    m_pendingInputTime = -1.0;
+    if(m_frameGrabber != nullptr){
+        m_frameGrabber->Poll();
+    }
+    ++m_frameCount;
 }
 
 bool Display::IsClosed() const
@@ -85,6 +149,175 @@ bool Display::IsClosed() const
     return m_isClosed;
 }
 
+double Display::GetTime() const
+{
+    return m_fixedTimeStep > 0.0 ? static_cast<double>(m_frameCount) * m_fixedTimeStep : glfwGetTime();
+}
+
+void Display::SetFixedTimeStep(double seconds)
+{
+    m_fixedTimeStep = seconds;
+}
+
+void Display::SetSwapMode(SwapMode mode)
+{
+    m_swapMode = mode;
+    m_softwareLateSwap = mode == SwapMode::LateSwapTear || (mode == SwapMode::Adaptive && !m_hasSwapControlTear);
+    switch(mode){
+        case SwapMode::Off:
+            SetSwapInterval(0);
+            break;
+        case SwapMode::On:
+        case SwapMode::LateSwapTear:
+            SetSwapInterval(1);
+            break;
+        case SwapMode::Adaptive:
+            SetSwapInterval(m_hasSwapControlTear ? -1 : 1);
+            break;
+    }
+}
+
+Display::LatencyStats Display::GetLatencyStats() const
+{
+    auto stats{m_latency};
+    stats.averageMilliseconds = stats.samples != 0 ? m_latencySum / static_cast<double>(stats.samples) : 0.0;
+    return stats;
+}
+
+void Display::ResetLatencyStats()
+{
+    m_latency = LatencyStats{};
+    m_latencySum = 0.0;
+}
+
+const char* Display::GetSwapModeName(SwapMode mode)
+{
+    switch(mode){
+        case SwapMode::Off:
+            return "vsync off";
+        case SwapMode::On:
+            return "vsync on";
+        case SwapMode::Adaptive:
+            return "adaptive vsync";
+        case SwapMode::LateSwapTear:
+            return "late swap tear";
+    }
+    return "unknown";
+}
+
+bool Display::PollEvent(Event& event)
+{
+    return m_events.Pop(event);
+}
+
+void Display::StartRecording()
+{
+    m_recorded.clear();
+    m_recordStart = m_frameCount;
+    m_recording = true;
+}
+
+std::vector<Display::Event> Display::StopRecording()
+{
+    m_recording = false;
+    return std::move(m_recorded);
+}
+
+void Display::StartReplay(std::vector<Event> events)
+{
+    m_replay = std::move(events);
+    m_replayStart = m_frameCount;
+    m_replayNext = 0;
+    m_replaying = !m_replay.empty();
+}
+
+bool Display::SaveEvents(const std::string& path, const std::vector<Event>& events)
+{
+    static_assert(std::is_trivially_copyable_v<Event>, "events are written as they are in memory");
+    std::ofstream file{path, std::ios::binary | std::ios::trunc};
+    const std::uint32_t eventSize{sizeof(Event)};
+    const std::uint64_t count{events.size()};
+    file.write(EventFileMagic, sizeof(EventFileMagic));
+    file.write(reinterpret_cast<const char*>(&eventSize), sizeof(eventSize));
+    file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    file.write(reinterpret_cast<const char*>(events.data()), static_cast<std::streamsize>(events.size() * sizeof(Event)));
+    if(!file){
+        std::cerr << "Failed to write events to " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Display::LoadEvents(const std::string& path, std::vector<Event>& events)
+{
+    std::ifstream file{path, std::ios::binary};
+    char magic[sizeof(EventFileMagic)]{};
+    std::uint32_t eventSize{};
+    std::uint64_t count{};
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&eventSize), sizeof(eventSize));
+    file.read(reinterpret_cast<char*>(&count), sizeof(count));
+    if(!file || std::memcmp(magic, EventFileMagic, sizeof(magic)) != 0 || eventSize != sizeof(Event)){
+        std::cerr << "Not an event file of this build " << path << std::endl;
+        return false;
+    }
+    events.resize(count);
+    file.read(reinterpret_cast<char*>(events.data()), static_cast<std::streamsize>(count * sizeof(Event)));
+    if(!file){
+        std::cerr << "Event file " << path << " is truncated" << std::endl;
+        events.clear();
+        return false;
+    }
+    return true;
+}
+
+void Display::InputEvent(Event event)
+{
+    // live input would change the outcome of the recorded stream
+    if(m_replaying){
+        return;
+    }
+    if(m_recording){
+        auto recorded{event};
+        recorded.frame -= m_recordStart;
+        m_recorded.push_back(recorded);
+    }
+    QueueEvent(event);
+}
+
+void Display::QueueEvent(const Event& event)
+{
+    if(event.type == EventType::Key && event.action == GLFW_PRESS && m_pendingInputTime < 0.0){
+        m_pendingInputTime = event.time;
+    }
+    if(!m_events.Push(event)){
+        ++m_droppedEvents;
+    }
+}
+
+void Display::ReplayEvents()
+{
+    const auto frame{m_frameCount - m_replayStart};
+    while(m_replayNext < m_replay.size() && m_replay[m_replayNext].frame <= frame){
+        auto event{m_replay[m_replayNext++]};
+        event.frame = m_frameCount;
+        event.time = glfwGetTime();
+        QueueEvent(event);
+    }
+    if(m_replayNext == m_replay.size()){
+        m_replaying = false;
+        m_replay.clear();
+    }
+}
+
+void Display::SetSwapInterval(int interval)
+{
+    if(interval != m_swapInterval){
+        glfwSwapInterval(interval);
+        m_swapInterval = interval;
+    }
+}
+
 void Display::SetClose()
 {
     m_isClosed = true;
@@ -99,13 +332,11 @@ Display* Display::GetWindowUserPointer(GLFWwindow* window)
 void Display::SetKeyCallback(KeyCallback keyCallback)
 {
     m_keyCallback = keyCallback;
-    glfwSetKeyCallback(m_window, m_keyCallback);
 }
 
 void Display::SetWindowSizeCallback(WindowSizeCallback resizeCallback)
 {
     m_resizeCallback = resizeCallback;
-    glfwSetWindowSizeCallback(m_window, m_resizeCallback);
 }
 
 void Display::DisplayErrorCallback(int error, const char* description)
@@ -113,6 +344,69 @@ void Display::DisplayErrorCallback(int error, const char* description)
     std::cerr << "ERROR: code: " << error << " msg: " << description << std::endl;
 }
 
+void Display::DisplayKeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    auto display = reinterpret_cast<Display*>(glfwGetWindowUserPointer(window));
+    Event event{EventType::Key, display->m_frameCount, glfwGetTime()};
+    event.key = key;
+    event.scancode = scancode;
+    event.action = action;
+    event.mods = mods;
+    display->InputEvent(event);
+    if(display->m_keyCallback != nullptr){
+        display->m_keyCallback(window, key, scancode, action, mods);
+    }
+}
+
+void Display::DisplayMouseButtonCallback(GLFWwindow* window, int button, int action, int mods)
+{
+    auto display = reinterpret_cast<Display*>(glfwGetWindowUserPointer(window));
+    Event event{EventType::MouseButton, display->m_frameCount, glfwGetTime()};
+    event.key = button;
+    event.action = action;
+    event.mods = mods;
+    display->InputEvent(event);
+}
+
+void Display::DisplayCursorPositionCallback(GLFWwindow* window, double x, double y)
+{
+    auto display = reinterpret_cast<Display*>(glfwGetWindowUserPointer(window));
+    Event event{EventType::CursorPosition, display->m_frameCount, glfwGetTime()};
+    event.x = x;
+    event.y = y;
+    display->InputEvent(event);
+}
+
+void Display::DisplayScrollCallback(GLFWwindow* window, double x, double y)
+{
+    auto display = reinterpret_cast<Display*>(glfwGetWindowUserPointer(window));
+    Event event{EventType::Scroll, display->m_frameCount, glfwGetTime()};
+    event.x = x;
+    event.y = y;
+    display->InputEvent(event);
+}
+
+void Display::DisplayWindowSizeCallback(GLFWwindow* window, int width, int height)
+{
+    auto display = reinterpret_cast<Display*>(glfwGetWindowUserPointer(window));
+    Event event{EventType::WindowSize, display->m_frameCount, glfwGetTime()};
+    event.width = width;
+    event.height = height;
+    display->QueueEvent(event);
+    if(display->m_resizeCallback != nullptr){
+        display->m_resizeCallback(window, width, height);
+    }
+}
+
+void Display::DisplayFramebufferSizeCallback(GLFWwindow* window, int width, int height)
+{
+    auto display = reinterpret_cast<Display*>(glfwGetWindowUserPointer(window));
+    Event event{EventType::FramebufferSize, display->m_frameCount, glfwGetTime()};
+    event.width = width;
+    event.height = height;
+    display->QueueEvent(event);
+}
+
 void Display::DisplayWindowCloseCallback(GLFWwindow* window)
 {
     auto display = reinterpret_cast<Display*>(glfwGetWindowUserPointer(window));
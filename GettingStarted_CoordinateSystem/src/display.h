@@ -1,13 +1,20 @@
 #ifndef DISPLAY_H_08162020
 #define DISPLAY_H_08162020
 
+#include <cstdint>
+#include <string>
 #include <string_view>
+#include <vector>
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
+
+#include "spscQueue.h"
+
+class FrameGrabber;
+
 /*
-Create a GLFW window
-Calling application can provide event callback functions if wanted.
+Create a GLFW window, its input and window events are queued for the application to handle once per frame.
 */
 class Display
 {
@@ -18,7 +25,54 @@ private:
 public:
     using value_type = GLFWwindow;
 
-    explicit Display(int width, int height, const std::basic_string_view<char> title, bool fullscreen = false);
+    // swap interval, the constructor starts with On
+    enum class SwapMode
+    {
+        Off,            // 0, never waits for vertical blank, lowest latency, tears
+        On,             // 1, every frame waits for vertical blank
+        Adaptive,       // -1 with WGL/GLX_EXT_swap_control_tear, a late frame tears once instead of waiting a refresh
+        LateSwapTear    // Adaptive decided in software, a frame slower than a refresh swaps with 0, others with 1
+    };
+
+    struct LatencyStats
+    {
+        std::uint64_t samples{};
+        double averageMilliseconds{};
+        double minMilliseconds{};
+        double maxMilliseconds{};
+        std::uint64_t lateSwaps{};      // swaps that skipped vertical blank in LateSwapTear
+    };
+
+    enum class EventType : std::uint8_t
+    {
+        Key,
+        MouseButton,
+        CursorPosition,
+        Scroll,
+        WindowSize,
+        FramebufferSize
+    };
+
+    struct Event
+    {
+        EventType type{};
+        std::uint64_t frame{};      // GetFrameCount() of the poll that saw it
+        double time{};              // glfwGetTime() when GLFW reported it
+        int key{};                  // Key GLFW_KEY_*, MouseButton GLFW_MOUSE_BUTTON_*
+        int scancode{};
+        int action{};               // GLFW_PRESS, GLFW_RELEASE or GLFW_REPEAT
+        int mods{};
+        int width{};                // WindowSize in screen coordinates, FramebufferSize in pixels
+        int height{};
+        double x{};                 // CursorPosition, Scroll offsets
+        double y{};
+    };
+
+    static constexpr std::size_t EventQueueSize{1024};
+
+    // visible = false for offscreen runs, the hidden window still has a default framebuffer to read back
+    explicit Display(int width, int height, const std::basic_string_view<char> title, bool fullscreen = false,
+                     bool visible = true);
 
     ~Display();
 
@@ -26,10 +80,48 @@ public:
     void Update();
     bool IsClosed() const;
 
+    // glfwGetTime(), or Update() calls times the fixed step so animation is the same on every run
+    double GetTime() const;
+    // 0 goes back to glfwGetTime()
+    void SetFixedTimeStep(double seconds);
+    inline std::uint64_t GetFrameCount() const { return m_frameCount; }
+
+    // Update() grabs before the swap and polls after it, not owned, nullptr stops grabbing
+    inline void SetFrameGrabber(FrameGrabber* grabber) { m_frameGrabber = grabber; }
+    inline FrameGrabber* GetFrameGrabber() const { return m_frameGrabber; }
+
+    void SetSwapMode(SwapMode mode);
+    inline SwapMode GetSwapMode() const { return m_swapMode; }
+    inline double GetRefreshPeriod() const { return m_refreshPeriod; }
+    // input to photon estimate of frames that handled a key press: press to the return of
+    // glfwSwapBuffers() plus half a refresh to scan out, frames queued by the driver aren't seen
+    LatencyStats GetLatencyStats() const;
+    void ResetLatencyStats();
+    static const char* GetSwapModeName(SwapMode mode);
+
+    // next event of the last poll, oldest first, false when there are no more. GLFW's callbacks only queue
+    // them, handling them here keeps GL state changes out of glfwPollEvents()
+    bool PollEvent(Event& event);
+    // events lost to a full queue
+    inline std::uint64_t GetDroppedEventCount() const { return m_droppedEvents; }
+
+    // copies every input event from now on, frames counted from here
+    void StartRecording();
+    std::vector<Event> StopRecording();
+    inline bool IsRecording() const { return m_recording; }
+    // queues a recorded stream on the same frames counted from here and ignores live input until it ends,
+    // with SetFixedTimeStep() runs see the same input at the same time
+    void StartReplay(std::vector<Event> events);
+    inline bool IsReplaying() const { return m_replaying; }
+    // raw events behind a header with the size of Event, files of a build with another layout are rejected
+    static bool SaveEvents(const std::string& path, const std::vector<Event>& events);
+    static bool LoadEvents(const std::string& path, std::vector<Event>& events);
+
     void SetClose();
     static Display* GetWindowUserPointer(GLFWwindow* window);
     inline operator GLFWwindow* () { return m_window; }
 
+    // called inside the poll, for code that doesn't use PollEvent()
     void SetKeyCallback(KeyCallback keyCallback);
     void SetWindowSizeCallback(WindowSizeCallback resizeCallback);
 
@@ -43,10 +135,48 @@ private:
     static void glDebugOutput(GLenum source, GLenum type, GLuint id, GLenum severity,
                               GLsizei length, const GLchar* message, const void* userParam);
     static void DisplayWindowCloseCallback(GLFWwindow* window);
+    static void DisplayKeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
+    static void DisplayMouseButtonCallback(GLFWwindow* window, int button, int action, int mods);
+    static void DisplayCursorPositionCallback(GLFWwindow* window, double x, double y);
+    static void DisplayScrollCallback(GLFWwindow* window, double x, double y);
+    static void DisplayWindowSizeCallback(GLFWwindow* window, int width, int height);
+    static void DisplayFramebufferSizeCallback(GLFWwindow* window, int width, int height);
+
+    void SetSwapInterval(int interval);
+    // live input, recorded and then queued unless a replay is running
+    void InputEvent(Event event);
+    void QueueEvent(const Event& event);
+    void ReplayEvents();
 
     GLFWwindow* m_window;
     bool m_isClosed;
 
+    std::uint64_t m_frameCount;
+    double m_fixedTimeStep;
+    FrameGrabber* m_frameGrabber;
+
+    SwapMode m_swapMode;
+    bool m_softwareLateSwap;
+    bool m_hasSwapControlTear;
+    int m_swapInterval;     // -2 until the first glfwSwapInterval()
+    double m_refreshPeriod;
+    double m_lastSwapTime;
+    // glfwGetTime() of the first key press since the last poll and of the one the current frame handles, < 0 for none
+    double m_pendingInputTime;
+    double m_frameInputTime;
+    double m_latencySum;
+    LatencyStats m_latency;
+
+    SpscQueue<Event, EventQueueSize> m_events;
+    std::uint64_t m_droppedEvents;
+    bool m_recording;
+    std::uint64_t m_recordStart;
+    std::vector<Event> m_recorded;
+    bool m_replaying;
+    std::uint64_t m_replayStart;
+    std::size_t m_replayNext;
+    std::vector<Event> m_replay;
+
     std::string m_windowName;
 
     KeyCallback m_keyCallback = nullptr;
@@ -0,0 +1,177 @@
+#include "frameCapture.h"
+#include <charconv>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <SOIL2/stb_image_write.h>
+
+namespace
+{
+    template<typename T>
+    bool ParseNumber(const char* text, T& value)
+    {
+        std::string_view view{text};
+        auto [next, error] = std::from_chars(view.data(), view.data() + view.size(), value);
+        return error == std::errc{} && next == view.data() + view.size();
+    }
+
+    bool WritePng(const std::filesystem::path& path, const Texture2D::ImageData& image)
+    {
+        std::error_code error;
+        std::filesystem::create_directories(path.parent_path(), error);
+        if(stbi_write_png(path.string().c_str(), image.width, image.height, 4, image.pixels.data(), image.width * 4) == 0){
+            std::cerr << "Failed to write " << path.string() << std::endl;
+            return false;
+        }
+        return true;
+    }
+}
+
+bool FrameCapture::ParseArguments(int argc, char* argv[], Settings& settings)
+{
+    bool capture{};
+    for(int i{1}; i < argc; ++i){
+        std::string_view argument{argv[i]};
+        bool hasValue{i + 1 < argc};
+        bool valid{true};
+        if(argument == "--update-golden"){
+            settings.updateGolden = true;
+        }
+        else if(!hasValue){
+            valid = false;
+        }
+        else if(argument == "--capture"){
+            settings.name = argv[++i];
+            capture = true;
+        }
+        else if(argument == "--frames"){
+            valid = ParseNumber(argv[++i], settings.frameCount) && settings.frameCount > 0;
+        }
+        else if(argument == "--interval"){
+            valid = ParseNumber(argv[++i], settings.interval);
+        }
+        else if(argument == "--time-step"){
+            valid = ParseNumber(argv[++i], settings.timeStep) && settings.timeStep > 0.0;
+        }
+        else if(argument == "--output"){
+            settings.outputDirectory = argv[++i];
+        }
+        else if(argument == "--golden"){
+            settings.goldenDirectory = argv[++i];
+        }
+        else if(argument == "--input"){
+            settings.inputFile = argv[++i];
+        }
+        else if(argument == "--threshold"){
+            valid = ParseNumber(argv[++i], settings.tolerance.threshold);
+        }
+        else if(argument == "--max-different"){
+            valid = ParseNumber(argv[++i], settings.tolerance.maxDifferentPixels);
+        }
+        else{
+            valid = false;
+        }
+        if(!valid){
+            std::cerr << "Ignoring capture argument " << argument << std::endl;
+        }
+    }
+    return capture;
+}
+
+FrameCapture::FrameCapture(Display& display, const Settings& settings)
+    : m_display{display}, m_settings{settings}, m_captured{}, m_failed{}, m_finished{},
+    m_grabber{FramebufferWidth(display), FramebufferHeight(display),
+              [this](const FrameGrabber::Frame& frame){ Check(frame.image, frame.index); }, FrameGrabber::Backpressure::Wait}
+{
+    m_display.SetFixedTimeStep(m_settings.timeStep);
+    if(!m_settings.inputFile.empty()){
+        std::vector<Display::Event> events;
+        if(Display::LoadEvents(m_settings.inputFile, events)){
+            m_display.StartReplay(std::move(events));
+        }
+        else{
+            ++m_failed;
+        }
+    }
+}
+
+void FrameCapture::EndFrame()
+{
+    if(m_finished){
+        return;
+    }
+    const auto frame{m_display.GetFrameCount()};
+    const bool last{frame + 1 >= m_settings.frameCount};
+    if(last || (m_settings.interval != 0 && frame % m_settings.interval == 0)){
+        // the back buffer is complete until Update() swaps it
+        glReadBuffer(GL_BACK);
+        m_grabber.Grab(frame);
+    }
+    m_grabber.Poll();
+
+    if(last){
+        m_grabber.Flush();
+        std::cout << m_settings.name << ": " << m_captured << " frames captured, " << m_failed << " failed" << std::endl;
+        m_finished = true;
+        m_display.SetClose();
+    }
+}
+
+int FrameCapture::FramebufferWidth(Display& display)
+{
+    int width{}, height{};
+    glfwGetFramebufferSize(display, &width, &height);
+    return width;
+}
+
+int FrameCapture::FramebufferHeight(Display& display)
+{
+    int width{}, height{};
+    glfwGetFramebufferSize(display, &width, &height);
+    return height;
+}
+
+void FrameCapture::Check(const Texture2D::ImageData& image, std::uint64_t frame)
+{
+    std::ostringstream fileName;
+    fileName << m_settings.name << '_' << std::setw(4) << std::setfill('0') << frame;
+    const std::filesystem::path output{m_settings.outputDirectory};
+    const auto goldenPath{std::filesystem::path{m_settings.goldenDirectory} / (fileName.str() + ".png")};
+
+    ++m_captured;
+    WritePng(output / (fileName.str() + ".png"), image);
+    if(m_settings.updateGolden){
+        WritePng(goldenPath, image);
+        return;
+    }
+
+    std::error_code error;
+    Texture2D::ImageData golden;
+    if(std::filesystem::exists(goldenPath, error)){
+        golden = Texture2D::Decode(goldenPath.string());
+    }
+    if(!golden.IsValid()){
+        std::cerr << fileName.str() << ": no golden image " << goldenPath.string() << ", run with --update-golden" << std::endl;
+        ++m_failed;
+        return;
+    }
+
+    Texture2D::ImageData diff;
+    auto result{ImageDiff::Compare(golden, image, m_settings.tolerance, &diff)};
+    if(result.sizeMismatch){
+        std::cerr << fileName.str() << ": golden image is " << golden.width << "x" << golden.height
+            << ", frame is " << image.width << "x" << image.height << std::endl;
+        ++m_failed;
+    }
+    else if(!result.matches){
+        std::cerr << fileName.str() << ": " << result.differentPixels << " pixels differ ("
+            << result.differentFraction * 100.0 << "%), largest distance " << result.maxDistance << std::endl;
+        WritePng(output / (fileName.str() + "_diff.png"), diff);
+        ++m_failed;
+    }
+}
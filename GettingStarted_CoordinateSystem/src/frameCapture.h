@@ -0,0 +1,80 @@
+#ifndef FRAME_CAPTURE_H_10192026
+#define FRAME_CAPTURE_H_10192026
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "display.h"
+#include "frameGrabber.h"
+#include "imageDiff.h"
+#include "texture2D.h"
+
+/*
+Regression capture of a sample's output, so changes can be checked against known good images.
+The display advances on a fixed time step instead of the wall clock and closes itself after frameCount
+frames, every interval-th frame and the last one are read back, written as PNG and compared with the
+image of the same name in the golden directory:
+    <outputDirectory>/<name>_<frame>.png        captured frame
+    <outputDirectory>/<name>_<frame>_diff.png   differing pixels in red, only for mismatches
+    <goldenDirectory>/<name>_<frame>.png        expected frame, written instead with updateGolden
+EndFrame() goes after all drawing and before Display::Update(). The selected frames go through a
+FrameGrabber that waits instead of dropping frames, PNG writing and comparing run on its consumer thread.
+inputFile replays input recorded with Display::StartRecording() and saved with Display::SaveEvents(),
+from the first frame on, so interactive states can be captured too. A file that doesn't load fails the run.
+ParseArguments() reads the settings from the command line, it returns false without --capture, so
+samples run normally unless asked:
+    --capture <name> [--frames n] [--interval n] [--time-step seconds] [--output dir] [--golden dir]
+    [--threshold t] [--max-different fraction] [--update-golden] [--input file]
+*/
+class FrameCapture
+{
+public:
+    struct Settings
+    {
+        std::string name;
+        unsigned int frameCount{60};
+        unsigned int interval{30};
+        double timeStep{1.0 / 60.0};
+        std::string outputDirectory{"./capture"};
+        std::string goldenDirectory{"./golden"};
+        std::string inputFile;
+        ImageDiff::Tolerance tolerance;
+        bool updateGolden{};
+    };
+
+    static bool ParseArguments(int argc, char* argv[], Settings& settings);
+
+    FrameCapture(Display& display, const Settings& settings);
+
+    void EndFrame();
+
+    inline bool IsFinished() const { return m_finished; }
+    inline unsigned int GetCapturedCount() const { return m_captured; }
+    inline unsigned int GetFailedCount() const { return m_failed; }
+    // for main's return, non zero when a frame didn't match or had no golden image
+    inline int GetExitCode() const { return m_failed != 0 ? 1 : 0; }
+
+    FrameCapture(const FrameCapture& other) = delete;
+    FrameCapture& operator=(const FrameCapture& other) = delete;
+    FrameCapture(FrameCapture&& other) = delete;
+    FrameCapture& operator=(FrameCapture&& other) = delete;
+
+private:
+    static int FramebufferWidth(Display& display);
+    static int FramebufferHeight(Display& display);
+
+    // on the grabber's consumer thread
+    void Check(const Texture2D::ImageData& image, std::uint64_t frame);
+
+    Display& m_display;
+    Settings m_settings;
+
+    std::atomic<unsigned int> m_captured;
+    std::atomic<unsigned int> m_failed;
+    bool m_finished;
+
+    FrameGrabber m_grabber;
+};
+
+#endif // !FRAME_CAPTURE_H_10192026
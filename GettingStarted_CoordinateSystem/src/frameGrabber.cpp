@@ -0,0 +1,249 @@
+#include "frameGrabber.h"
+#include "glStateCache.h"
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <utility>
+
+#include <SOIL2/stb_image_write.h>
+
+namespace
+{
+    // blocks until the GPU passed the fence, flushing so a fence still in the command queue gets there
+    void WaitFence(GLsync fence)
+    {
+        constexpr GLuint64 oneSecond{1'000'000'000};
+        while(glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, oneSecond) == GL_TIMEOUT_EXPIRED){
+        }
+    }
+
+    double MillisecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+FrameGrabber::FrameGrabber(int width, int height, Consumer consumer, Backpressure backpressure,
+                           std::size_t ringSize, std::size_t poolSize)
+    : m_width{width}, m_height{height}, m_consumer{std::move(consumer)}, m_backpressure{backpressure},
+    m_slots(ringSize), m_oldest{}, m_pending{}, m_pool(poolSize), m_consuming{}, m_stop{}, m_stats{}
+{
+    assert(ringSize > 0 && poolSize > 0);
+    const auto frameSize{static_cast<std::size_t>(m_width) * static_cast<std::size_t>(m_height) * 4};
+    for(auto& slot : m_slots){
+        slot = Slot{};
+        glGenBuffers(1, &slot.buffer);
+        GLStateCache::Current().BindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+        glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(frameSize), nullptr, GL_STREAM_READ);
+    }
+    GLStateCache::Current().BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    // all the memory frames ever need, the render thread doesn't allocate while grabbing
+    for(auto& image : m_pool){
+        image.width = m_width;
+        image.height = m_height;
+        image.pixels.resize(frameSize);
+    }
+
+    m_thread = std::thread{&FrameGrabber::ConsumerLoop, this};
+}
+
+FrameGrabber::~FrameGrabber()
+{
+    Flush();
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_stop = true;
+    }
+    m_queued.notify_all();
+    m_thread.join();
+
+    for(auto& slot : m_slots){
+        GLStateCache::Current().DeleteBuffer(slot.buffer);
+    }
+}
+
+void FrameGrabber::Grab(std::uint64_t frameIndex)
+{
+    auto start{std::chrono::steady_clock::now()};
+
+    bool stalled{};
+    if(m_pending == m_slots.size()){
+        auto& oldest{m_slots[m_oldest]};
+        if(glClientWaitSync(oldest.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0) == GL_TIMEOUT_EXPIRED){
+            stalled = true;
+            WaitFence(oldest.fence);
+        }
+        Resolve(oldest);
+    }
+
+    auto& slot{m_slots[(m_oldest + m_pending) % m_slots.size()]};
+    GLStateCache::Current().BindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    GLStateCache::Current().BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.frame = frameIndex;
+    ++m_pending;
+
+    auto milliseconds{MillisecondsSince(start)};
+    std::lock_guard<std::mutex> lock{m_mutex};
+    ++m_stats.grabbed;
+    m_stats.stalls += stalled ? 1 : 0;
+    m_stats.renderMilliseconds += milliseconds;
+}
+
+void FrameGrabber::Poll()
+{
+    auto start{std::chrono::steady_clock::now()};
+    // read backs finish in order, the first one still running ends the poll
+    while(m_pending != 0 && glClientWaitSync(m_slots[m_oldest].fence, 0, 0) != GL_TIMEOUT_EXPIRED){
+        Resolve(m_slots[m_oldest]);
+    }
+
+    auto milliseconds{MillisecondsSince(start)};
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_stats.renderMilliseconds += milliseconds;
+}
+
+void FrameGrabber::Flush()
+{
+    while(m_pending != 0){
+        WaitFence(m_slots[m_oldest].fence);
+        Resolve(m_slots[m_oldest]);
+    }
+    std::unique_lock<std::mutex> lock{m_mutex};
+    m_released.wait(lock, [this](){ return m_queue.empty() && !m_consuming; });
+}
+
+FrameGrabber::Stats FrameGrabber::GetStats() const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_stats;
+}
+
+void FrameGrabber::ResetStats()
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_stats = Stats{};
+}
+
+void FrameGrabber::Resolve(Slot& slot)
+{
+    Texture2D::ImageData image;
+    {
+        std::unique_lock<std::mutex> lock{m_mutex};
+        if(m_pool.empty() && m_backpressure == Backpressure::Wait){
+            m_released.wait(lock, [this](){ return !m_pool.empty(); });
+        }
+        if(!m_pool.empty()){
+            image = std::move(m_pool.back());
+            m_pool.pop_back();
+        }
+    }
+
+    bool queued{};
+    if(image.IsValid()){
+        GLStateCache::Current().BindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+        const auto* mapped{static_cast<const unsigned char*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0,
+                                                                              static_cast<GLsizeiptr>(image.pixels.size()),
+                                                                              GL_MAP_READ_BIT))};
+        if(mapped != nullptr){
+            // GL rows start at the bottom
+            const auto rowSize{static_cast<std::size_t>(m_width) * 4};
+            for(int row{}; row < m_height; ++row){
+                std::memcpy(&image.pixels[row * rowSize], mapped + (m_height - 1 - row) * rowSize, rowSize);
+            }
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            queued = true;
+        }
+        else{
+            std::cerr << "Failed to map the read back of frame " << slot.frame << std::endl;
+        }
+        GLStateCache::Current().BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+    m_oldest = (m_oldest + 1) % m_slots.size();
+    --m_pending;
+
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        if(queued){
+            m_queue.push_back(Frame{slot.frame, std::move(image)});
+        }
+        else{
+            ++m_stats.dropped;
+            if(image.IsValid()){
+                m_pool.push_back(std::move(image));
+            }
+        }
+    }
+    if(queued){
+        m_queued.notify_one();
+    }
+}
+
+void FrameGrabber::ConsumerLoop()
+{
+    while(true){
+        Frame frame;
+        {
+            std::unique_lock<std::mutex> lock{m_mutex};
+            m_queued.wait(lock, [this](){ return m_stop || !m_queue.empty(); });
+            if(m_queue.empty()){
+                return;
+            }
+            frame = std::move(m_queue.front());
+            m_queue.pop_front();
+            m_consuming = true;
+        }
+
+        auto start{std::chrono::steady_clock::now()};
+        m_consumer(frame);
+        auto milliseconds{MillisecondsSince(start)};
+
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_pool.push_back(std::move(frame.image));
+            m_consuming = false;
+            ++m_stats.consumed;
+            m_stats.consumerMilliseconds += milliseconds;
+        }
+        m_released.notify_all();
+    }
+}
+
+FrameGrabber::Consumer FrameGrabber::PngWriter(std::string directory, std::string prefix)
+{
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    return [directory = std::move(directory), prefix = std::move(prefix)](const Frame& frame){
+        std::ostringstream fileName;
+        fileName << prefix << '_' << std::setw(5) << std::setfill('0') << frame.index << ".png";
+        auto path{(std::filesystem::path{directory} / fileName.str()).string()};
+        const auto& image{frame.image};
+        if(stbi_write_png(path.c_str(), image.width, image.height, 4, image.pixels.data(), image.width * 4) == 0){
+            std::cerr << "Failed to write " << path << std::endl;
+        }
+    };
+}
+
+FrameGrabber::Consumer FrameGrabber::RawWriter(std::string path)
+{
+    // std::function has to be copyable, the stream is shared
+    auto file{std::make_shared<std::ofstream>(path, std::ios::binary | std::ios::trunc)};
+    if(!*file){
+        std::cerr << "Failed to open " << path << std::endl;
+    }
+    return [file](const Frame& frame){
+        file->write(reinterpret_cast<const char*>(frame.image.pixels.data()), static_cast<std::streamsize>(frame.image.pixels.size()));
+    };
+}
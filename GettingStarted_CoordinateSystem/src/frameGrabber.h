@@ -0,0 +1,123 @@
+#ifndef FRAME_GRABBER_H_10192026
+#define FRAME_GRABBER_H_10192026
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "texture2D.h"
+
+/*
+Reads frames back from the GPU without waiting for them.
+Grab() starts glReadPixels of the read framebuffer into the next pixel pack buffer of a ring and puts a
+glFenceSync behind it. Poll() checks the fences oldest first without blocking, a finished buffer is
+mapped, copied top row first into a pooled image and queued for the consumer thread, which calls the
+Consumer with it and hands the image back to the pool. A frame normally reaches the consumer ringSize - 1
+frames after it was grabbed, the render thread only pays for starting the copy and the memcpy out of a
+finished buffer.
+The ring is full when Grab() reaches a buffer whose fence hasn't signaled yet, it then waits and counts
+a stall. When the consumer falls behind and no pooled image is free, Backpressure::Drop skips the frame,
+Backpressure::Wait blocks the render thread until the consumer is done with one, for captures that must
+not lose frames.
+Stats::renderMilliseconds is everything Grab() and Poll() cost the render thread, the frame time
+impact of grabbing.
+The size is fixed at construction, Grab() reads the lower left width x height of the framebuffer.
+Display::SetFrameGrabber() grabs every frame before the swap and polls after it.
+*/
+class FrameGrabber
+{
+public:
+    enum class Backpressure
+    {
+        Drop,
+        Wait
+    };
+
+    struct Frame
+    {
+        std::uint64_t index;
+        Texture2D::ImageData image;     // RGBA8, top row first
+    };
+
+    // runs on the consumer thread, one frame at a time in grab order
+    using Consumer = std::function<void(const Frame&)>;
+
+    struct Stats
+    {
+        std::uint64_t grabbed{};
+        std::uint64_t consumed{};
+        std::uint64_t dropped{};
+        std::uint64_t stalls{};     // Grab() had to wait for the oldest read back
+        double renderMilliseconds{};
+        double consumerMilliseconds{};
+    };
+
+    FrameGrabber(int width, int height, Consumer consumer, Backpressure backpressure = Backpressure::Drop,
+                 std::size_t ringSize = 3, std::size_t poolSize = 4);
+    ~FrameGrabber();
+
+    // after drawing, before the swap
+    void Grab(std::uint64_t frameIndex);
+    void Poll();
+    // waits until every grabbed frame went through the consumer
+    void Flush();
+
+    // locks, the consumer thread updates its part while frames are in flight
+    Stats GetStats() const;
+    void ResetStats();
+
+    inline int GetWidth() const { return m_width; }
+    inline int GetHeight() const { return m_height; }
+
+    // <directory>/<prefix>_<frame>.png
+    static Consumer PngWriter(std::string directory, std::string prefix);
+    // appends the frames to one file, ffmpeg -f rawvideo -pix_fmt rgba -s <width>x<height> -i <path> reads it
+    static Consumer RawWriter(std::string path);
+
+    FrameGrabber(const FrameGrabber& other) = delete;
+    FrameGrabber& operator=(const FrameGrabber& other) = delete;
+    FrameGrabber(FrameGrabber&& other) = delete;
+    FrameGrabber& operator=(FrameGrabber&& other) = delete;
+
+private:
+    struct Slot
+    {
+        unsigned int buffer;
+        GLsync fence;
+        std::uint64_t frame;
+    };
+
+    // maps a slot whose fence signaled and queues its image, the fence is deleted either way
+    void Resolve(Slot& slot);
+    void ConsumerLoop();
+
+    int m_width;
+    int m_height;
+    Consumer m_consumer;
+    Backpressure m_backpressure;
+
+    std::vector<Slot> m_slots;
+    std::size_t m_oldest;       // next slot to resolve
+    std::size_t m_pending;      // slots with a fence
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_queued;
+    std::condition_variable m_released;
+    std::vector<Texture2D::ImageData> m_pool;
+    std::deque<Frame> m_queue;
+    bool m_consuming;
+    bool m_stop;
+    Stats m_stats;
+
+    std::thread m_thread;
+};
+
+#endif // !FRAME_GRABBER_H_10192026
@@ -0,0 +1,104 @@
+#include "frameLoop.h"
+#include <cmath>
+#include <iostream>
+#include <thread>
+
+namespace
+{
+    double MillisecondsBetween(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+    {
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+}
+
+void FrameLoop::Stats::Print(std::ostream& os) const
+{
+    if(frames == 0){
+        return;
+    }
+    auto perFrame = [this](double milliseconds){ return milliseconds / static_cast<double>(frames); };
+    os << frames << " frames in " << elapsedMilliseconds << " ms, " << frames * 1000.0 / elapsedMilliseconds << " fps, "
+        << updates << " updates, " << droppedSteps << " steps dropped\n"
+        << "    per frame: update " << perFrame(updateMilliseconds) << " ms, render " << perFrame(renderMilliseconds)
+        << " ms, swap " << perFrame(swapMilliseconds) << " ms, idle " << perFrame(idleMilliseconds) << " ms\n";
+}
+
+FrameLoop::FrameLoop(Display& display, const Settings& settings)
+    : m_display{display}, m_settings{settings}, m_stats{}
+{}
+
+void FrameLoop::Run(const UpdateFunction& update, const RenderFunction& render)
+{
+    const auto step{GetStep()};
+    double accumulator{};
+    auto previousTime{m_display.GetTime()};
+    auto nextFrame{Clock::now()};
+    auto reportStart{Clock::now()};
+
+    while(!m_display.IsClosed()){
+        auto frameStart{Clock::now()};
+
+        auto time{m_display.GetTime()};
+        accumulator += time - previousTime;
+        previousTime = time;
+
+        unsigned int steps{};
+        while(accumulator >= step && steps < m_settings.maxUpdatesPerFrame){
+            update(step);
+            accumulator -= step;
+            ++steps;
+        }
+        if(accumulator >= step){
+            // whatever didn't fit is lost, catching up later would only make the next frame slower
+            m_stats.droppedSteps += static_cast<std::uint64_t>(accumulator / step);
+            accumulator = std::fmod(accumulator, step);
+        }
+        auto updated{Clock::now()};
+
+        render(static_cast<float>(accumulator / step));
+        auto rendered{Clock::now()};
+
+        m_display.Update();
+        auto swapped{Clock::now()};
+
+        Pace(nextFrame);
+        auto frameEnd{Clock::now()};
+
+        m_stats.frames += 1;
+        m_stats.updates += steps;
+        m_stats.updateMilliseconds += MillisecondsBetween(frameStart, updated);
+        m_stats.renderMilliseconds += MillisecondsBetween(updated, rendered);
+        m_stats.swapMilliseconds += MillisecondsBetween(rendered, swapped);
+        m_stats.idleMilliseconds += MillisecondsBetween(swapped, frameEnd);
+        m_stats.elapsedMilliseconds += MillisecondsBetween(frameStart, frameEnd);
+
+        if(m_settings.reportInterval > 0.0 && MillisecondsBetween(reportStart, frameEnd) >= m_settings.reportInterval * 1000.0){
+            m_stats.Print(std::cout);
+            std::cout << std::flush;
+            ResetStats();
+            reportStart = frameEnd;
+        }
+    }
+}
+
+void FrameLoop::Pace(Clock::time_point& nextFrame)
+{
+    if(m_settings.maxFrameRate <= 0.0){
+        return;
+    }
+    const auto period{std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_settings.maxFrameRate))};
+    nextFrame += period;
+    auto now{Clock::now()};
+    // behind schedule, start over from now instead of rushing the next frames to catch up
+    if(now > nextFrame){
+        nextFrame = now;
+        return;
+    }
+    constexpr std::chrono::milliseconds spin{1};
+    if(nextFrame - now > spin){
+        std::this_thread::sleep_until(nextFrame - spin);
+    }
+    while(Clock::now() < nextFrame){
+        std::this_thread::yield();
+    }
+}
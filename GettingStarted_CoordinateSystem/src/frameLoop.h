@@ -0,0 +1,100 @@
+#ifndef FRAME_LOOP_H_10192026
+#define FRAME_LOOP_H_10192026
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+
+#include "display.h"
+
+/*
+Render loop on top of a Display that runs the simulation on a fixed step, independent of the frame rate.
+Every frame the time passed on Display::GetTime() is added to an accumulator, update(step) runs once for
+every whole step in it and render(alpha) draws once, alpha = leftover / step tells how far the display
+time is between the last two updates, so rendering blends them with Interpolated and motion stays smooth
+at any frame rate. Frames slower than maxUpdatesPerFrame steps drop the rest of the time instead of
+spiraling into ever longer catch ups, the scene slows down and Stats::droppedSteps counts it.
+maxFrameRate paces the loop on the wall clock, sleeping most of the way to the next frame and yielding
+the last millisecond, sleep alone overshoots by a scheduler tick. 0 leaves pacing to the swap.
+Stats time update, render, Display::Update() (swap and events) and the pacing wait per frame, Print()
+shows them averaged, every reportInterval seconds Run() prints them to std::cout and starts over.
+With Display::SetFixedTimeStep() the display time, and with it every update, is the same on every run.
+*/
+class FrameLoop
+{
+public:
+    struct Settings
+    {
+        double updateRate{60.0};            // fixed steps per second
+        double maxFrameRate{};              // frames per second, 0 unlimited
+        unsigned int maxUpdatesPerFrame{5};
+        double reportInterval{};            // seconds, 0 never reports
+    };
+
+    struct Stats
+    {
+        std::uint64_t frames{};
+        std::uint64_t updates{};
+        std::uint64_t droppedSteps{};
+        double updateMilliseconds{};
+        double renderMilliseconds{};
+        double swapMilliseconds{};
+        double idleMilliseconds{};
+        double elapsedMilliseconds{};
+
+        void Print(std::ostream& os) const;
+    };
+
+    using UpdateFunction = std::function<void(double step)>;
+    using RenderFunction = std::function<void(float alpha)>;
+
+    FrameLoop(Display& display, const Settings& settings);
+
+    // returns when the display closes
+    void Run(const UpdateFunction& update, const RenderFunction& render);
+
+    inline void SetMaxFrameRate(double framesPerSecond) { m_settings.maxFrameRate = framesPerSecond; }
+    inline double GetStep() const { return 1.0 / m_settings.updateRate; }
+    inline const Stats& GetStats() const { return m_stats; }
+    inline void ResetStats() { m_stats = Stats{}; }
+
+    FrameLoop(const FrameLoop& other) = delete;
+    FrameLoop& operator=(const FrameLoop& other) = delete;
+    FrameLoop(FrameLoop&& other) = delete;
+    FrameLoop& operator=(FrameLoop&& other) = delete;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void Pace(Clock::time_point& nextFrame);
+
+    Display& m_display;
+    Settings m_settings;
+    Stats m_stats;
+};
+
+/*
+Simulation state seen between two fixed steps.
+Call Store() at the start of every update before changing Current(), Get(alpha) blends the state of the
+last two updates for rendering. T needs + - and * float, float and the glm vectors have them.
+*/
+template<typename T>
+class Interpolated
+{
+public:
+    explicit Interpolated(const T& value = T{})
+        : m_previous{value}, m_current{value}
+    {}
+
+    inline void Store() { m_previous = m_current; }
+    inline T& Current() { return m_current; }
+    inline const T& Current() const { return m_current; }
+    inline T Get(float alpha) const { return m_previous + (m_current - m_previous) * alpha; }
+
+private:
+    T m_previous;
+    T m_current;
+};
+
+#endif // !FRAME_LOOP_H_10192026
@@ -0,0 +1,236 @@
+#include "frustumCuller.h"
+#include <cassert>
+#include <chrono>
+#include <cmath>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FRUSTUM_CULLER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    struct Streams
+    {
+        const float* centerX; const float* centerY; const float* centerZ;
+        const float* extentX; const float* extentY; const float* extentZ;
+        const float* radius;
+    };
+
+    /*
+    an object is outside when it lies completely behind one plane
+    box:    dot(n, center) + d < -dot(abs(n), extents)
+    sphere: dot(n, center) + d < -radius
+    returns one bit per object of the batch, set when the object is visible
+    */
+#if defined(__AVX2__)
+    constexpr std::size_t LaneCount{8};
+
+    inline unsigned int TestBatch(const Streams& s, std::size_t i, const std::array<glm::vec4, 6>& planes, bool box)
+    {
+        const auto signMask{_mm256_set1_ps(-0.0f)};
+        const auto cx{_mm256_loadu_ps(s.centerX + i)};
+        const auto cy{_mm256_loadu_ps(s.centerY + i)};
+        const auto cz{_mm256_loadu_ps(s.centerZ + i)};
+        const auto ex{_mm256_loadu_ps(s.extentX + i)};
+        const auto ey{_mm256_loadu_ps(s.extentY + i)};
+        const auto ez{_mm256_loadu_ps(s.extentZ + i)};
+        const auto radius{_mm256_loadu_ps(s.radius + i)};
+
+        auto outside{_mm256_setzero_ps()};
+        for(const auto& plane : planes){
+            const auto nx{_mm256_set1_ps(plane.x)};
+            const auto ny{_mm256_set1_ps(plane.y)};
+            const auto nz{_mm256_set1_ps(plane.z)};
+            auto distance{_mm256_add_ps(_mm256_mul_ps(nx, cx), _mm256_set1_ps(plane.w))};
+            distance = _mm256_add_ps(distance, _mm256_mul_ps(ny, cy));
+            distance = _mm256_add_ps(distance, _mm256_mul_ps(nz, cz));
+
+            auto reach{radius};
+            if(box){
+                reach = _mm256_mul_ps(_mm256_andnot_ps(signMask, nx), ex);
+                reach = _mm256_add_ps(reach, _mm256_mul_ps(_mm256_andnot_ps(signMask, ny), ey));
+                reach = _mm256_add_ps(reach, _mm256_mul_ps(_mm256_andnot_ps(signMask, nz), ez));
+            }
+            outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(distance, reach), _mm256_setzero_ps(), _CMP_LT_OQ));
+        }
+        return ~static_cast<unsigned int>(_mm256_movemask_ps(outside)) & 0xffu;
+    }
+#elif defined(FRUSTUM_CULLER_SSE2)
+    constexpr std::size_t LaneCount{4};
+
+    inline unsigned int TestBatch(const Streams& s, std::size_t i, const std::array<glm::vec4, 6>& planes, bool box)
+    {
+        const auto signMask{_mm_set1_ps(-0.0f)};
+        const auto cx{_mm_loadu_ps(s.centerX + i)};
+        const auto cy{_mm_loadu_ps(s.centerY + i)};
+        const auto cz{_mm_loadu_ps(s.centerZ + i)};
+        const auto ex{_mm_loadu_ps(s.extentX + i)};
+        const auto ey{_mm_loadu_ps(s.extentY + i)};
+        const auto ez{_mm_loadu_ps(s.extentZ + i)};
+        const auto radius{_mm_loadu_ps(s.radius + i)};
+
+        auto outside{_mm_setzero_ps()};
+        for(const auto& plane : planes){
+            const auto nx{_mm_set1_ps(plane.x)};
+            const auto ny{_mm_set1_ps(plane.y)};
+            const auto nz{_mm_set1_ps(plane.z)};
+            auto distance{_mm_add_ps(_mm_mul_ps(nx, cx), _mm_set1_ps(plane.w))};
+            distance = _mm_add_ps(distance, _mm_mul_ps(ny, cy));
+            distance = _mm_add_ps(distance, _mm_mul_ps(nz, cz));
+
+            auto reach{radius};
+            if(box){
+                reach = _mm_mul_ps(_mm_andnot_ps(signMask, nx), ex);
+                reach = _mm_add_ps(reach, _mm_mul_ps(_mm_andnot_ps(signMask, ny), ey));
+                reach = _mm_add_ps(reach, _mm_mul_ps(_mm_andnot_ps(signMask, nz), ez));
+            }
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, reach), _mm_setzero_ps()));
+        }
+        return ~static_cast<unsigned int>(_mm_movemask_ps(outside)) & 0xfu;
+    }
+#else
+    constexpr std::size_t LaneCount{1};
+
+    inline unsigned int TestBatch(const Streams& s, std::size_t i, const std::array<glm::vec4, 6>& planes, bool box)
+    {
+        for(const auto& plane : planes){
+            auto distance{plane.x * s.centerX[i] + plane.y * s.centerY[i] + plane.z * s.centerZ[i] + plane.w};
+            auto reach{box ? std::abs(plane.x) * s.extentX[i] + std::abs(plane.y) * s.extentY[i] + std::abs(plane.z) * s.extentZ[i]
+                           : s.radius[i]};
+            if(distance + reach < 0.0f){
+                return 0u;
+            }
+        }
+        return 1u;
+    }
+#endif
+}
+
+FrustumCuller::FrustumCuller(std::size_t capacity)
+    : m_size{}, m_stats{}
+{
+    auto padded{(capacity + BatchWidth - 1) / BatchWidth * BatchWidth};
+    for(auto* stream : {&m_centerX, &m_centerY, &m_centerZ, &m_extentX, &m_extentY, &m_extentZ, &m_radius}){
+        stream->reserve(padded);
+    }
+    m_visible.reserve(padded);
+}
+
+std::size_t FrustumCuller::Add(const glm::vec3& center, const glm::vec3& extents)
+{
+    if(m_size == m_centerX.size()){
+        for(auto* stream : {&m_centerX, &m_centerY, &m_centerZ, &m_extentX, &m_extentY, &m_extentZ, &m_radius}){
+            stream->resize(m_size + BatchWidth, 0.0f);
+        }
+    }
+    auto index{m_size++};
+    Set(index, center, extents);
+    return index;
+}
+
+std::size_t FrustumCuller::Add(const glm::mat4& model, const glm::vec3& localMin, const glm::vec3& localMax)
+{
+    auto index{Add(glm::vec3{}, glm::vec3{})};
+    Set(index, model, localMin, localMax);
+    return index;
+}
+
+void FrustumCuller::Set(std::size_t index, const glm::vec3& center, const glm::vec3& extents)
+{
+    assert(index < m_size);
+    m_centerX[index] = center.x;
+    m_centerY[index] = center.y;
+    m_centerZ[index] = center.z;
+    m_extentX[index] = extents.x;
+    m_extentY[index] = extents.y;
+    m_extentZ[index] = extents.z;
+    m_radius[index] = glm::length(extents);
+}
+
+void FrustumCuller::Set(std::size_t index, const glm::mat4& model, const glm::vec3& localMin, const glm::vec3& localMax)
+{
+    // transform the center and grow the extents by the absolute rotation/scale part (Arvo)
+    auto localCenter{(localMin + localMax) * 0.5f};
+    auto localExtents{(localMax - localMin) * 0.5f};
+    glm::vec3 center{model * glm::vec4{localCenter, 1.0f}};
+    glm::vec3 extents{};
+    for(int column{}; column < 3; ++column){
+        extents += glm::abs(glm::vec3{model[column]}) * localExtents[column];
+    }
+    Set(index, center, extents);
+}
+
+void FrustumCuller::Clear()
+{
+    m_size = 0;
+    for(auto* stream : {&m_centerX, &m_centerY, &m_centerZ, &m_extentX, &m_extentY, &m_extentZ, &m_radius}){
+        stream->clear();
+    }
+    m_visible.clear();
+}
+
+const std::vector<std::uint32_t>& FrustumCuller::Cull(const glm::mat4& viewProjection, Bounds bounds)
+{
+    auto start{std::chrono::steady_clock::now()};
+
+    m_visible.clear();
+    CullRange(ExtractPlanes(viewProjection), 0, m_size, m_visible, bounds);
+
+    m_stats.tested = m_size;
+    m_stats.visible = m_visible.size();
+    m_stats.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return m_visible;
+}
+
+void FrustumCuller::CullRange(const std::array<glm::vec4, 6>& planes, std::size_t first, std::size_t last,
+                              std::vector<std::uint32_t>& visible, Bounds bounds) const
+{
+    assert(first % BatchWidth == 0 && last <= m_size);
+    if(first >= last){
+        return;
+    }
+
+    const Streams streams{m_centerX.data(), m_centerY.data(), m_centerZ.data(),
+                          m_extentX.data(), m_extentY.data(), m_extentZ.data(),
+                          m_radius.data()};
+    const bool box{bounds == Bounds::Box};
+
+    // branch free compaction, every lane writes its index and only visible lanes advance the count
+    auto count{visible.size()};
+    visible.resize(count + (last - first + BatchWidth - 1) / BatchWidth * BatchWidth);
+    for(auto i{first}; i < last; i += LaneCount){
+        auto mask{TestBatch(streams, i, planes, box)};
+        for(std::size_t lane{}; lane < LaneCount; ++lane){
+            visible[count] = static_cast<std::uint32_t>(i + lane);
+            count += (mask >> lane) & 1u;
+        }
+    }
+    // lanes of the last batch past the range may have been counted
+    while(count > 0 && visible[count - 1] >= last){
+        --count;
+    }
+    visible.resize(count);
+}
+
+std::array<glm::vec4, 6> FrustumCuller::ExtractPlanes(const glm::mat4& viewProjection)
+{
+    // Gribb/Hartmann, rows of the clip matrix combined, glm is column major
+    auto row = [&viewProjection](int r){
+        return glm::vec4{viewProjection[0][r], viewProjection[1][r], viewProjection[2][r], viewProjection[3][r]};
+    };
+    std::array<glm::vec4, 6> planes{
+        row(3) + row(0),    // left
+        row(3) - row(0),    // right
+        row(3) + row(1),    // bottom
+        row(3) - row(1),    // top
+        row(3) + row(2),    // near
+        row(3) - row(2)     // far
+    };
+    for(auto& plane : planes){
+        plane /= glm::length(glm::vec3{plane});
+    }
+    return planes;
+}
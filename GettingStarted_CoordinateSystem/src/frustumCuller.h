@@ -0,0 +1,73 @@
+#ifndef FRUSTUM_CULLER_H_10192026
+#define FRUSTUM_CULLER_H_10192026
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+/*
+CPU view frustum culling of world space bounding boxes.
+Boxes are stored as center/extents in structure of arrays form and tested 8 at a time with AVX2
+(4 with SSE2) against the six planes taken from projection * view.
+Cull() returns the compacted list of visible object indices, ready to drive the draw loop.
+Bounds::Sphere tests the sphere around each box, cheaper but looser than Bounds::Box.
+*/
+class FrustumCuller
+{
+public:
+    enum class Bounds
+    {
+        Sphere,
+        Box
+    };
+
+    struct Stats
+    {
+        std::size_t tested{};
+        std::size_t visible{};
+        double milliseconds{};
+    };
+
+    explicit FrustumCuller(std::size_t capacity = 0);
+
+    std::size_t Add(const glm::vec3& center, const glm::vec3& extents);
+    // world space box around the local box [localMin, localMax] transformed by model
+    std::size_t Add(const glm::mat4& model, const glm::vec3& localMin, const glm::vec3& localMax);
+
+    void Set(std::size_t index, const glm::vec3& center, const glm::vec3& extents);
+    void Set(std::size_t index, const glm::mat4& model, const glm::vec3& localMin, const glm::vec3& localMax);
+    void Clear();
+
+    const std::vector<std::uint32_t>& Cull(const glm::mat4& viewProjection, Bounds bounds = Bounds::Box);
+    // appends the visible indices of [first, last) to visible without touching the culler's own state,
+    // so threads can cull disjoint ranges at once, first has to be a multiple of BatchWidth
+    void CullRange(const std::array<glm::vec4, 6>& planes, std::size_t first, std::size_t last,
+                   std::vector<std::uint32_t>& visible, Bounds bounds = Bounds::Box) const;
+
+    inline const std::vector<std::uint32_t>& GetVisible() const { return m_visible; }
+    inline const Stats& GetStats() const { return m_stats; }
+    inline std::size_t Size() const { return m_size; }
+
+    // left, right, bottom, top, near, far planes as (normal, distance) with unit length normals
+    static std::array<glm::vec4, 6> ExtractPlanes(const glm::mat4& viewProjection);
+
+    // the bounds streams grow in steps of this with zeroed boxes, so a CullRange starting on a multiple of it
+    // tests whole batches and its last batch reads padding, never past the streams
+    static constexpr std::size_t BatchWidth{8};
+
+private:
+
+    std::size_t m_size;
+
+    std::vector<float> m_centerX, m_centerY, m_centerZ;
+    std::vector<float> m_extentX, m_extentY, m_extentZ;
+    std::vector<float> m_radius;
+
+    std::vector<std::uint32_t> m_visible;
+    Stats m_stats;
+};
+
+#endif // !FRUSTUM_CULLER_H_10192026
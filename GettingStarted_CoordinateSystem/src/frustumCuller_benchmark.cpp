@@ -0,0 +1,82 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "frustumCuller.h"
+
+// settings
+constexpr std::size_t OBJECT_COUNT{1'000'000};
+constexpr int ITERATIONS{10};
+constexpr unsigned int SCR_WIDTH{800};
+constexpr unsigned int SCR_HEIGHT{600};
+
+/*
+Cull OBJECT_COUNT random boxes spread around the camera and compare the batched culler
+with a plain per object loop over the same planes.
+*/
+int main()
+{
+    std::mt19937 rng{5};
+    std::uniform_real_distribution<float> position{-200.0f, 200.0f};
+    std::uniform_real_distribution<float> size{0.1f, 3.0f};
+
+    std::vector<glm::vec3> centers, extents;
+    FrustumCuller culler{OBJECT_COUNT};
+    for(std::size_t i{}; i < OBJECT_COUNT; ++i){
+        centers.emplace_back(position(rng), position(rng), position(rng));
+        extents.emplace_back(size(rng), size(rng), size(rng));
+        culler.Add(centers.back(), extents.back());
+    }
+
+    auto projection{glm::perspective(glm::radians(45.0f), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f)};
+    auto view{glm::lookAt(glm::vec3{0.0f, 0.0f, 3.0f}, glm::vec3{10.0f, 2.0f, -20.0f}, glm::vec3{0.0f, 1.0f, 0.0f})};
+    auto viewProjection{projection * view};
+    auto planes{FrustumCuller::ExtractPlanes(viewProjection)};
+
+    using clock = std::chrono::steady_clock;
+    for(auto bounds : {FrustumCuller::Bounds::Sphere, FrustumCuller::Bounds::Box}){
+        bool box{bounds == FrustumCuller::Bounds::Box};
+
+        std::vector<std::uint32_t> reference;
+        reference.reserve(OBJECT_COUNT);
+        auto scalar{std::chrono::duration<double, std::milli>::max()};
+        for(int iteration{}; iteration < ITERATIONS; ++iteration){
+            auto start{clock::now()};
+            reference.clear();
+            for(std::size_t i{}; i < OBJECT_COUNT; ++i){
+                bool inside{true};
+                for(const auto& plane : planes){
+                    auto distance{glm::dot(glm::vec3{plane}, centers[i]) + plane.w};
+                    auto reach{box ? glm::dot(glm::abs(glm::vec3{plane}), extents[i]) : glm::length(extents[i])};
+                    if(distance + reach < 0.0f){
+                        inside = false;
+                        break;
+                    }
+                }
+                if(inside){
+                    reference.push_back(static_cast<std::uint32_t>(i));
+                }
+            }
+            scalar = std::min(scalar, std::chrono::duration<double, std::milli>(clock::now() - start));
+        }
+
+        double batched{std::numeric_limits<double>::max()};
+        for(int iteration{}; iteration < ITERATIONS; ++iteration){
+            culler.Cull(viewProjection, bounds);
+            batched = std::min(batched, culler.GetStats().milliseconds);
+        }
+
+        const auto& stats{culler.GetStats()};
+        std::cout << (box ? "box:    " : "sphere: ") << "tested " << stats.tested << ", visible " << stats.visible
+                  << ", per object loop " << scalar.count() << " ms, batched " << batched << " ms ("
+                  << scalar.count() / batched << "x), " << (culler.GetVisible() == reference ? "same" : "DIFFERENT")
+                  << " visible list\n";
+    }
+
+    return 0;
+}
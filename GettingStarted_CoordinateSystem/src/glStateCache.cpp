@@ -0,0 +1,287 @@
+#include "glStateCache.h"
+#include <cassert>
+
+GLStateCache& GLStateCache::Current()
+{
+    thread_local GLStateCache cache;
+    return cache;
+}
+
+GLStateCache::GLStateCache()
+    : m_program{}, m_vertexArray{}, m_buffers{}, m_activeTexture{}, m_textures{}, m_capabilities{},
+    m_blendSource{}, m_blendDestination{}, m_depthFunction{}, m_depthMask{}, m_polygonMode{}, m_counters{}
+{
+    Invalidate();
+}
+
+void GLStateCache::UseProgram(unsigned int program)
+{
+    if(Change(State::Program, m_program, program)){
+        glUseProgram(program);
+    }
+}
+
+void GLStateCache::BindVertexArray(unsigned int vertexArray)
+{
+    if(Change(State::VertexArray, m_vertexArray, vertexArray)){
+        glBindVertexArray(vertexArray);
+        // the element array binding belongs to the vertex array
+        m_buffers[BufferSlot(GL_ELEMENT_ARRAY_BUFFER)] = Unknown;
+    }
+}
+
+void GLStateCache::BindBuffer(GLenum target, unsigned int buffer)
+{
+    auto slot{BufferSlot(target)};
+    if(slot == NotTracked){
+        ++m_counters[static_cast<std::size_t>(State::Buffer)].requested;
+    }
+    else if(!Change(State::Buffer, m_buffers[slot], buffer)){
+        return;
+    }
+    glBindBuffer(target, buffer);
+}
+
+void GLStateCache::BindBufferBase(GLenum target, unsigned int index, unsigned int buffer)
+{
+    // indexed bindings are not tracked, the call always goes through
+    ++m_counters[static_cast<std::size_t>(State::Buffer)].requested;
+    glBindBufferBase(target, index, buffer);
+    auto slot{BufferSlot(target)};
+    if(slot != NotTracked){
+        m_buffers[slot] = buffer;
+    }
+}
+
+void GLStateCache::ActiveTexture(unsigned int unit)
+{
+    if(Change(State::ActiveTexture, m_activeTexture, unit)){
+        glActiveTexture(GL_TEXTURE0 + unit);
+    }
+}
+
+void GLStateCache::BindTexture(unsigned int unit, GLenum target, unsigned int texture)
+{
+    assert(unit < TextureUnitCount);
+
+    // callers go on to glTex* calls on the active unit, it has to be this one even when the binding is already there
+    ActiveTexture(unit);
+    if(target != GL_TEXTURE_2D){
+        ++m_counters[static_cast<std::size_t>(State::Texture)].requested;
+    }
+    else if(!Change(State::Texture, m_textures[unit], texture)){
+        return;
+    }
+    glBindTexture(target, texture);
+}
+
+void GLStateCache::Enable(GLenum capability)
+{
+    SetCapability(capability, true);
+}
+
+void GLStateCache::Disable(GLenum capability)
+{
+    SetCapability(capability, false);
+}
+
+void GLStateCache::BlendFunc(GLenum source, GLenum destination)
+{
+    auto& counters{m_counters[static_cast<std::size_t>(State::Blend)]};
+    ++counters.requested;
+    if(m_blendSource == source && m_blendDestination == destination){
+        ++counters.filtered;
+        return;
+    }
+    m_blendSource = source;
+    m_blendDestination = destination;
+    glBlendFunc(source, destination);
+}
+
+void GLStateCache::DepthFunc(GLenum function)
+{
+    if(Change(State::Depth, m_depthFunction, function)){
+        glDepthFunc(function);
+    }
+}
+
+void GLStateCache::DepthMask(bool write)
+{
+    if(Change(State::Depth, m_depthMask, write ? 1u : 0u)){
+        glDepthMask(write ? GL_TRUE : GL_FALSE);
+    }
+}
+
+void GLStateCache::PolygonMode(GLenum mode)
+{
+    // core profile only has GL_FRONT_AND_BACK
+    if(Change(State::PolygonMode, m_polygonMode, mode)){
+        glPolygonMode(GL_FRONT_AND_BACK, mode);
+    }
+}
+
+void GLStateCache::DeleteProgram(unsigned int program)
+{
+    // a deleted program stays in use until another one is, its name may be handed out again
+    if(m_program == program){
+        m_program = Unknown;
+    }
+    glDeleteProgram(program);
+}
+
+void GLStateCache::DeleteVertexArray(unsigned int vertexArray)
+{
+    // deleting a bound object reverts the binding to 0
+    if(m_vertexArray == vertexArray){
+        m_vertexArray = 0;
+        m_buffers[BufferSlot(GL_ELEMENT_ARRAY_BUFFER)] = Unknown;
+    }
+    glDeleteVertexArrays(1, &vertexArray);
+}
+
+void GLStateCache::DeleteBuffer(unsigned int buffer)
+{
+    for(auto& cached : m_buffers){
+        if(cached == buffer){
+            cached = 0;
+        }
+    }
+    glDeleteBuffers(1, &buffer);
+}
+
+void GLStateCache::DeleteTexture(unsigned int texture)
+{
+    for(auto& cached : m_textures){
+        if(cached == texture){
+            cached = 0;
+        }
+    }
+    glDeleteTextures(1, &texture);
+}
+
+void GLStateCache::Invalidate()
+{
+    m_program = Unknown;
+    m_vertexArray = Unknown;
+    m_buffers.fill(Unknown);
+    m_activeTexture = Unknown;
+    m_textures.fill(Unknown);
+    m_capabilities.fill(Unknown);
+    m_blendSource = Unknown;
+    m_blendDestination = Unknown;
+    m_depthFunction = Unknown;
+    m_depthMask = Unknown;
+    m_polygonMode = Unknown;
+}
+
+GLStateCache::Counters GLStateCache::GetTotal() const
+{
+    Counters total{};
+    for(const auto& counters : m_counters){
+        total.requested += counters.requested;
+        total.filtered += counters.filtered;
+    }
+    return total;
+}
+
+const char* GLStateCache::GetName(State state)
+{
+    switch(state){
+        case State::Program:
+            return "program";
+        case State::VertexArray:
+            return "vertex array";
+        case State::Buffer:
+            return "buffer";
+        case State::Texture:
+            return "texture";
+        case State::ActiveTexture:
+            return "active texture";
+        case State::Capability:
+            return "enable/disable";
+        case State::Blend:
+            return "blend";
+        case State::Depth:
+            return "depth";
+        case State::PolygonMode:
+            return "polygon mode";
+        default:
+            return "unknown";
+    }
+}
+
+std::size_t GLStateCache::BufferSlot(GLenum target)
+{
+    switch(target){
+        case GL_ARRAY_BUFFER:
+            return 0;
+        case GL_ELEMENT_ARRAY_BUFFER:
+            return 1;
+        case GL_SHADER_STORAGE_BUFFER:
+            return 2;
+        case GL_UNIFORM_BUFFER:
+            return 3;
+        case GL_DRAW_INDIRECT_BUFFER:
+            return 4;
+        case GL_DISPATCH_INDIRECT_BUFFER:
+            return 5;
+        case GL_PARAMETER_BUFFER:
+            return 6;
+        case GL_COPY_READ_BUFFER:
+            return 7;
+        case GL_PIXEL_PACK_BUFFER:
+            return 8;
+        case GL_PIXEL_UNPACK_BUFFER:
+            return 9;
+        default:
+            return NotTracked;
+    }
+}
+
+std::size_t GLStateCache::CapabilitySlot(GLenum capability)
+{
+    switch(capability){
+        case GL_DEPTH_TEST:
+            return 0;
+        case GL_BLEND:
+            return 1;
+        case GL_CULL_FACE:
+            return 2;
+        case GL_SCISSOR_TEST:
+            return 3;
+        case GL_STENCIL_TEST:
+            return 4;
+        default:
+            return NotTracked;
+    }
+}
+
+bool GLStateCache::Change(State state, unsigned int& cached, unsigned int value)
+{
+    auto& counters{m_counters[static_cast<std::size_t>(state)]};
+    ++counters.requested;
+    if(cached == value){
+        ++counters.filtered;
+        return false;
+    }
+    cached = value;
+    return true;
+}
+
+void GLStateCache::SetCapability(GLenum capability, bool enabled)
+{
+    auto slot{CapabilitySlot(capability)};
+    if(slot == NotTracked){
+        ++m_counters[static_cast<std::size_t>(State::Capability)].requested;
+    }
+    else if(!Change(State::Capability, m_capabilities[slot], enabled ? 1u : 0u)){
+        return;
+    }
+
+    if(enabled){
+        glEnable(capability);
+    }
+    else{
+        glDisable(capability);
+    }
+}
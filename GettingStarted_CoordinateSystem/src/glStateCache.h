@@ -0,0 +1,112 @@
+#ifndef GL_STATE_CACHE_H_10192026
+#define GL_STATE_CACHE_H_10192026
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include <glad/glad.h>
+
+/*
+Shadow copy of the GL state the render code changes most, redundant calls are dropped before they
+reach the driver.
+A context is current on one thread, so there is one cache per thread, Current() returns it.
+Tracked: program, vertex array, the common buffer targets, GL_TEXTURE_2D of texture units 0-15,
+the active texture unit, depth test/blend/cull face/scissor/stencil enable bits, blend function,
+depth function and mask, and polygon mode. Anything else is passed through and only counted.
+Every state starts unknown so the first call always goes through. Code changing tracked state
+without the cache has to call Invalidate() afterwards.
+Delete objects through the cache too, a deleted name can come back from glGen* while the cache still
+holds it as bound.
+*/
+class GLStateCache
+{
+public:
+    enum class State
+    {
+        Program,
+        VertexArray,
+        Buffer,
+        Texture,
+        ActiveTexture,
+        Capability,
+        Blend,
+        Depth,
+        PolygonMode,
+        Count
+    };
+
+    struct Counters
+    {
+        std::uint64_t requested{};
+        std::uint64_t filtered{};   // requests that matched the cached state and were dropped
+    };
+
+    static constexpr unsigned int TextureUnitCount{16};
+
+    static GLStateCache& Current();
+
+    void UseProgram(unsigned int program);
+    void BindVertexArray(unsigned int vertexArray);
+    void BindBuffer(GLenum target, unsigned int buffer);
+    // also changes the generic binding of target, as glBindBufferBase does
+    void BindBufferBase(GLenum target, unsigned int index, unsigned int buffer);
+    void ActiveTexture(unsigned int unit);
+    // leaves unit active, glTex* calls after it act on texture
+    void BindTexture(unsigned int unit, GLenum target, unsigned int texture);
+
+    void Enable(GLenum capability);
+    void Disable(GLenum capability);
+    void BlendFunc(GLenum source, GLenum destination);
+    void DepthFunc(GLenum function);
+    void DepthMask(bool write);
+    void PolygonMode(GLenum mode);
+
+    void DeleteProgram(unsigned int program);
+    void DeleteVertexArray(unsigned int vertexArray);
+    void DeleteBuffer(unsigned int buffer);
+    void DeleteTexture(unsigned int texture);
+
+    // forget all cached state, the next call of each kind goes through
+    void Invalidate();
+
+    inline const Counters& GetCounters(State state) const { return m_counters[static_cast<std::size_t>(state)]; }
+    Counters GetTotal() const;
+    inline void ResetCounters() { m_counters.fill(Counters{}); }
+    static const char* GetName(State state);
+
+    GLStateCache(const GLStateCache&) = delete;
+    GLStateCache(GLStateCache&&) = delete;
+    GLStateCache& operator=(const GLStateCache&) = delete;
+    GLStateCache& operator=(GLStateCache&&) = delete;
+
+private:
+    static constexpr unsigned int Unknown{0xffffffffu};
+    static constexpr std::size_t BufferTargetCount{10};
+    static constexpr std::size_t CapabilityCount{5};
+    static constexpr std::size_t NotTracked{~std::size_t{}};
+
+    GLStateCache();
+
+    static std::size_t BufferSlot(GLenum target);
+    static std::size_t CapabilitySlot(GLenum capability);
+    // counts the request, returns true when it has to reach GL and stores the new value
+    bool Change(State state, unsigned int& cached, unsigned int value);
+    void SetCapability(GLenum capability, bool enabled);
+
+    unsigned int m_program;
+    unsigned int m_vertexArray;
+    std::array<unsigned int, BufferTargetCount> m_buffers;
+    unsigned int m_activeTexture;
+    std::array<unsigned int, TextureUnitCount> m_textures;
+    std::array<unsigned int, CapabilityCount> m_capabilities;
+    unsigned int m_blendSource;
+    unsigned int m_blendDestination;
+    unsigned int m_depthFunction;
+    unsigned int m_depthMask;
+    unsigned int m_polygonMode;
+
+    std::array<Counters, static_cast<std::size_t>(State::Count)> m_counters;
+};
+
+#endif // !GL_STATE_CACHE_H_10192026
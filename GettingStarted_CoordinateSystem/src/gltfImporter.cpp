@@ -0,0 +1,640 @@
+#include "gltfImporter.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <memory>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "json.h"
+#include "mappedFile.h"
+#include "vertexLayout.h"
+
+namespace
+{
+    using clock = std::chrono::steady_clock;
+
+    constexpr std::uint32_t GlbMagic{0x46546c67};     // "glTF"
+    constexpr std::uint32_t GlbJsonChunk{0x4e4f534a}; // "JSON"
+    constexpr std::uint32_t GlbBinChunk{0x004e4942};  // "BIN\0"
+
+    struct Buffer
+    {
+        std::unique_ptr<MappedFile> file;
+        std::vector<std::byte> decoded;
+        const std::byte* data{};
+        std::size_t size{};
+    };
+
+    // a typed window into a buffer, data is null for accessors without bufferView, which read as zeros
+    struct AccessorView
+    {
+        const std::byte* data;
+        std::size_t count;
+        std::size_t stride;
+        int components;
+        int componentType;
+        bool normalized;
+    };
+
+    inline double Milliseconds(clock::time_point from, clock::time_point to)
+    {
+        return std::chrono::duration<double, std::milli>(to - from).count();
+    }
+
+    std::size_t ComponentSize(int componentType)
+    {
+        switch(componentType){
+            case GL_BYTE:
+            case GL_UNSIGNED_BYTE:
+                return 1;
+            case GL_SHORT:
+            case GL_UNSIGNED_SHORT:
+                return 2;
+            case GL_UNSIGNED_INT:
+            case GL_FLOAT:
+                return 4;
+            default:
+                return 0;
+        }
+    }
+
+    int ComponentCount(const std::string& type)
+    {
+        if(type == "SCALAR"){
+            return 1;
+        }
+        if(type.size() == 4 && type.compare(0, 3, "VEC") == 0 && type[3] >= '2' && type[3] <= '4'){
+            return type[3] - '0';
+        }
+        return 0;
+    }
+
+    template<typename T>
+    inline T ReadValue(const std::byte* data)
+    {
+        T value;
+        std::memcpy(&value, data, sizeof(T));
+        return value;
+    }
+
+    // the GL conversion rules for normalized integers, signed ones clamp -128 and -32768 to -1
+    float ReadComponent(const std::byte* data, int componentType, bool normalized)
+    {
+        switch(componentType){
+            case GL_BYTE:
+            {
+                auto value{static_cast<float>(ReadValue<std::int8_t>(data))};
+                return normalized ? std::max(value / 127.0f, -1.0f) : value;
+            }
+            case GL_UNSIGNED_BYTE:
+            {
+                auto value{static_cast<float>(ReadValue<std::uint8_t>(data))};
+                return normalized ? value / 255.0f : value;
+            }
+            case GL_SHORT:
+            {
+                auto value{static_cast<float>(ReadValue<std::int16_t>(data))};
+                return normalized ? std::max(value / 32767.0f, -1.0f) : value;
+            }
+            case GL_UNSIGNED_SHORT:
+            {
+                auto value{static_cast<float>(ReadValue<std::uint16_t>(data))};
+                return normalized ? value / 65535.0f : value;
+            }
+            case GL_UNSIGNED_INT:
+                return static_cast<float>(ReadValue<std::uint32_t>(data));
+            default:
+                return ReadValue<float>(data);
+        }
+    }
+
+    bool DecodeBase64(std::string_view text, std::vector<std::byte>& out)
+    {
+        static const auto table = [](){
+            std::array<std::int8_t, 256> values;
+            values.fill(-1);
+            const char* alphabet{"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"};
+            for(int i{}; i < 64; ++i){
+                values[static_cast<unsigned char>(alphabet[i])] = static_cast<std::int8_t>(i);
+            }
+            return values;
+        }();
+
+        while(!text.empty() && text.back() == '='){
+            text.remove_suffix(1);
+        }
+        out.clear();
+        out.reserve(text.size() * 3 / 4);
+        std::uint32_t bits{};
+        int bitCount{};
+        for(char c : text){
+            auto value{table[static_cast<unsigned char>(c)]};
+            if(value < 0){
+                return false;
+            }
+            bits = (bits << 6) | static_cast<std::uint32_t>(value);
+            bitCount += 6;
+            if(bitCount >= 8){
+                bitCount -= 8;
+                out.push_back(static_cast<std::byte>((bits >> bitCount) & 0xff));
+            }
+        }
+        return true;
+    }
+
+    // uris are relative to the .gltf and may be percent encoded
+    std::string ResolveUri(std::string_view directory, std::string_view uri)
+    {
+        std::string path{directory};
+        for(std::size_t i{}; i < uri.size(); ++i){
+            if(uri[i] == '%' && i + 2 < uri.size()){
+                unsigned int value{};
+                auto [next, error] = std::from_chars(uri.data() + i + 1, uri.data() + i + 3, value, 16);
+                if(error == std::errc{} && next == uri.data() + i + 3){
+                    path += static_cast<char>(value);
+                    i += 2;
+                    continue;
+                }
+            }
+            path += uri[i];
+        }
+        return path;
+    }
+
+    // data:[<mediatype>];base64,<data>, false for other uris
+    bool IsDataUri(std::string_view uri)
+    {
+        return uri.compare(0, 5, "data:") == 0;
+    }
+
+    bool DecodeDataUri(std::string_view uri, std::vector<std::byte>& out)
+    {
+        auto comma{uri.find(',')};
+        if(comma == std::string_view::npos || uri.substr(0, comma).find(";base64") == std::string_view::npos){
+            return false;
+        }
+        return DecodeBase64(uri.substr(comma + 1), out);
+    }
+
+    bool LoadBuffer(const JsonValue& buffer, std::string_view directory, const std::byte* glbData, std::size_t glbSize,
+                    Buffer& out)
+    {
+        const auto& uri{buffer["uri"].AsString()};
+        if(buffer["uri"].IsNull()){
+            // the first buffer of a .glb lives in the BIN chunk
+            out.data = glbData;
+            out.size = glbSize;
+        }
+        else if(IsDataUri(uri)){
+            if(!DecodeDataUri(uri, out.decoded)){
+                return false;
+            }
+            out.data = out.decoded.data();
+            out.size = out.decoded.size();
+        }
+        else{
+            out.file = std::make_unique<MappedFile>(ResolveUri(directory, uri));
+            if(!out.file->IsOpen()){
+                return false;
+            }
+            out.data = out.file->Data();
+            out.size = out.file->Size();
+        }
+        auto byteLength{buffer["byteLength"].AsNumber(-1.0)};
+        if(out.data == nullptr || byteLength < 1.0 || byteLength > static_cast<double>(out.size)){
+            return false;
+        }
+        out.size = static_cast<std::size_t>(byteLength);
+        return true;
+    }
+
+    bool GetBufferView(const JsonValue& document, const std::vector<Buffer>& buffers, int index,
+                       const std::byte*& data, std::size_t& size, std::size_t& stride)
+    {
+        const auto& view{document["bufferViews"][static_cast<std::size_t>(index)]};
+        auto buffer{view["buffer"].AsInt(-1)};
+        auto offset{view["byteOffset"].AsNumber(0.0)};
+        auto length{view["byteLength"].AsNumber(-1.0)};
+        if(!view.IsObject() || buffer < 0 || static_cast<std::size_t>(buffer) >= buffers.size() ||
+           offset < 0.0 || length < 1.0 || offset + length > static_cast<double>(buffers[buffer].size)){
+            return false;
+        }
+        data = buffers[buffer].data + static_cast<std::size_t>(offset);
+        size = static_cast<std::size_t>(length);
+        stride = static_cast<std::size_t>(view["byteStride"].AsInt(0));
+        return true;
+    }
+
+    bool GetAccessor(const JsonValue& document, const std::vector<Buffer>& buffers, int index, AccessorView& out)
+    {
+        const auto& accessor{document["accessors"][static_cast<std::size_t>(index)]};
+        if(!accessor.IsObject() || accessor.Has("sparse")){
+            return false;
+        }
+        out.componentType = accessor["componentType"].AsInt();
+        out.components = ComponentCount(accessor["type"].AsString());
+        out.normalized = accessor["normalized"].AsBool();
+        auto count{accessor["count"].AsNumber(-1.0)};
+        auto elementSize{ComponentSize(out.componentType) * out.components};
+        if(elementSize == 0 || count < 1.0 || count > std::numeric_limits<std::uint32_t>::max()){
+            return false;
+        }
+        out.count = static_cast<std::size_t>(count);
+        out.data = nullptr;
+        out.stride = elementSize;
+        if(accessor["bufferView"].IsNull()){
+            return true;
+        }
+
+        const std::byte* data{};
+        std::size_t size{}, stride{};
+        if(!GetBufferView(document, buffers, accessor["bufferView"].AsInt(-1), data, size, stride)){
+            return false;
+        }
+        auto offset{accessor["byteOffset"].AsNumber(0.0)};
+        if(stride != 0){
+            out.stride = stride;
+        }
+        if(offset < 0.0 || out.stride < elementSize ||
+           static_cast<std::uint64_t>(offset) + (out.count - 1) * std::uint64_t{out.stride} + elementSize > size){
+            return false;
+        }
+        out.data = data + static_cast<std::size_t>(offset);
+        return true;
+    }
+
+    // copies components of every element to floats at offset inside the interleaved vertices
+    bool ReadAttribute(const JsonValue& document, const std::vector<Buffer>& buffers, const JsonValue& attribute,
+                       int components, std::size_t vertexCount, std::size_t offset, std::vector<std::uint8_t>& vertices)
+    {
+        if(attribute.IsNull()){
+            return true;
+        }
+        AccessorView view;
+        if(!GetAccessor(document, buffers, attribute.AsInt(-1), view) || view.components != components ||
+           view.count != vertexCount){
+            return false;
+        }
+        if(view.data == nullptr){
+            return true;
+        }
+        auto componentSize{ComponentSize(view.componentType)};
+        auto* vertex{vertices.data() + offset};
+        for(std::size_t i{}; i < view.count; ++i, vertex += PositionTexCoordNormalLayout::Stride){
+            const auto* element{view.data + i * view.stride};
+            for(int c{}; c < components; ++c){
+                auto value{ReadComponent(element + c * componentSize, view.componentType, view.normalized)};
+                std::memcpy(vertex + c * sizeof(float), &value, sizeof(float));
+            }
+        }
+        return true;
+    }
+
+    int FindImage(const JsonValue& document, const JsonValue& primitive)
+    {
+        const auto& material{document["materials"][static_cast<std::size_t>(primitive["material"].AsInt(-1))]};
+        const auto& texture{material["pbrMetallicRoughness"]["baseColorTexture"]};
+        auto source{document["textures"][static_cast<std::size_t>(texture["index"].AsInt(-1))]["source"].AsInt(-1)};
+        return source >= 0 && static_cast<std::size_t>(source) < document["images"].Size() ? source : -1;
+    }
+
+    bool ReadPrimitive(const JsonValue& document, const std::vector<Buffer>& buffers, const JsonValue& primitive,
+                       GltfImporter::Primitive& out)
+    {
+        using Layout = PositionTexCoordNormalLayout;
+        static_assert(Layout::Stride == 8 * sizeof(float));
+
+        const auto& attributes{primitive["attributes"]};
+        AccessorView positions;
+        if(!GetAccessor(document, buffers, attributes["POSITION"].AsInt(-1), positions) || positions.components != 3){
+            return false;
+        }
+        auto vertexCount{positions.count};
+        auto& geometry{out.geometry};
+        geometry.stride = Layout::Stride;
+        geometry.originalVertexCount = vertexCount;
+        geometry.vertices.assign(vertexCount * Layout::Stride, 0);
+        if(!ReadAttribute(document, buffers, attributes["POSITION"], 3, vertexCount, Layout::Formats[0].offset, geometry.vertices) ||
+           !ReadAttribute(document, buffers, attributes["TEXCOORD_0"], 2, vertexCount, Layout::Formats[1].offset, geometry.vertices) ||
+           !ReadAttribute(document, buffers, attributes["NORMAL"], 3, vertexCount, Layout::Formats[2].offset, geometry.vertices)){
+            return false;
+        }
+
+        if(primitive["indices"].IsNull()){
+            geometry.indices.resize(vertexCount);
+            for(std::size_t i{}; i < vertexCount; ++i){
+                geometry.indices[i] = static_cast<std::uint32_t>(i);
+            }
+        }
+        else{
+            AccessorView indices;
+            if(!GetAccessor(document, buffers, primitive["indices"].AsInt(-1), indices) || indices.components != 1 ||
+               indices.normalized || indices.data == nullptr ||
+               (indices.componentType != GL_UNSIGNED_BYTE && indices.componentType != GL_UNSIGNED_SHORT &&
+                indices.componentType != GL_UNSIGNED_INT)){
+                return false;
+            }
+            geometry.indices.resize(indices.count);
+            for(std::size_t i{}; i < indices.count; ++i){
+                const auto* element{indices.data + i * indices.stride};
+                std::uint32_t index{indices.componentType == GL_UNSIGNED_BYTE ? ReadValue<std::uint8_t>(element) :
+                                    indices.componentType == GL_UNSIGNED_SHORT ? ReadValue<std::uint16_t>(element) :
+                                    ReadValue<std::uint32_t>(element)};
+                if(index >= vertexCount){
+                    return false;
+                }
+                geometry.indices[i] = index;
+            }
+        }
+        if(geometry.indices.size() % 3 != 0){
+            return false;
+        }
+
+        out.boundsMin = glm::vec3{std::numeric_limits<float>::max()};
+        out.boundsMax = glm::vec3{std::numeric_limits<float>::lowest()};
+        for(std::size_t v{}; v < vertexCount; ++v){
+            glm::vec3 position;
+            std::memcpy(&position, geometry.vertices.data() + v * Layout::Stride, sizeof(position));
+            out.boundsMin = glm::min(out.boundsMin, position);
+            out.boundsMax = glm::max(out.boundsMax, position);
+        }
+        out.image = FindImage(document, primitive);
+        return true;
+    }
+
+    bool DecodeImage(const JsonValue& document, const std::vector<Buffer>& buffers, const JsonValue& image,
+                     std::string_view directory, Texture2D::ImageData& out)
+    {
+        if(!image["bufferView"].IsNull()){
+            const std::byte* data{};
+            std::size_t size{}, stride{};
+            if(!GetBufferView(document, buffers, image["bufferView"].AsInt(-1), data, size, stride)){
+                return false;
+            }
+            out = Texture2D::Decode(reinterpret_cast<const unsigned char*>(data), size);
+        }
+        else if(IsDataUri(image["uri"].AsString())){
+            std::vector<std::byte> encoded;
+            if(!DecodeDataUri(image["uri"].AsString(), encoded)){
+                return false;
+            }
+            out = Texture2D::Decode(reinterpret_cast<const unsigned char*>(encoded.data()), encoded.size());
+        }
+        else{
+            out = Texture2D::Decode(ResolveUri(directory, image["uri"].AsString()));
+        }
+        return out.IsValid();
+    }
+
+    glm::mat4 LocalMatrix(const JsonValue& node)
+    {
+        const auto& matrix{node["matrix"]};
+        if(matrix.Size() == 16){
+            // column major like glm
+            glm::mat4 local;
+            for(int column{}; column < 4; ++column){
+                for(int row{}; row < 4; ++row){
+                    local[column][row] = static_cast<float>(matrix[static_cast<std::size_t>(column * 4 + row)].AsNumber());
+                }
+            }
+            return local;
+        }
+        auto component = [](const JsonValue& array, std::size_t index, double fallback){
+            return static_cast<float>(array[index].AsNumber(fallback));
+        };
+        const auto& t{node["translation"]};
+        const auto& r{node["rotation"]};
+        const auto& s{node["scale"]};
+        glm::vec3 translation{component(t, 0, 0.0), component(t, 1, 0.0), component(t, 2, 0.0)};
+        // glTF stores x, y, z, w
+        glm::quat rotation{component(r, 3, 1.0), component(r, 0, 0.0), component(r, 1, 0.0), component(r, 2, 0.0)};
+        glm::vec3 scale{component(s, 0, 1.0), component(s, 1, 1.0), component(s, 2, 1.0)};
+        return glm::scale(glm::translate(glm::mat4{1.0f}, translation) * glm::mat4_cast(rotation), scale);
+    }
+
+    // walks the default scene's node trees, nodes reached twice (cycles, shared children) are skipped
+    void FlattenNodes(const JsonValue& document, std::vector<GltfImporter::Instance>& instances)
+    {
+        const auto& nodes{document["nodes"]};
+        std::vector<std::size_t> roots;
+        const auto& scene{document["scenes"][static_cast<std::size_t>(document["scene"].AsInt(0))]};
+        if(scene.IsObject()){
+            for(std::size_t i{}; i < scene["nodes"].Size(); ++i){
+                roots.push_back(static_cast<std::size_t>(scene["nodes"][i].AsInt(-1)));
+            }
+        }
+        else{
+            // without scenes every node that isn't a child is a root
+            std::vector<bool> isChild(nodes.Size());
+            for(std::size_t n{}; n < nodes.Size(); ++n){
+                const auto& children{nodes[n]["children"]};
+                for(std::size_t c{}; c < children.Size(); ++c){
+                    auto child{static_cast<std::size_t>(children[c].AsInt(-1))};
+                    if(child < isChild.size()){
+                        isChild[child] = true;
+                    }
+                }
+            }
+            for(std::size_t n{}; n < nodes.Size(); ++n){
+                if(!isChild[n]){
+                    roots.push_back(n);
+                }
+            }
+        }
+
+        std::vector<bool> visited(nodes.Size());
+        std::vector<std::pair<std::size_t, glm::mat4>> stack;
+        for(auto root : roots){
+            stack.emplace_back(root, glm::mat4{1.0f});
+        }
+        while(!stack.empty()){
+            auto [index, parent] = stack.back();
+            stack.pop_back();
+            if(index >= nodes.Size() || visited[index]){
+                continue;
+            }
+            visited[index] = true;
+            const auto& node{nodes[index]};
+            auto world{parent * LocalMatrix(node)};
+            auto mesh{node["mesh"].AsInt(-1)};
+            if(mesh >= 0 && static_cast<std::size_t>(mesh) < document["meshes"].Size()){
+                instances.push_back(GltfImporter::Instance{static_cast<std::size_t>(mesh), world});
+            }
+            const auto& children{node["children"]};
+            for(std::size_t c{}; c < children.Size(); ++c){
+                stack.emplace_back(static_cast<std::size_t>(children[c].AsInt(-1)), world);
+            }
+        }
+    }
+}
+
+void GltfImporter::Timings::Print(std::ostream& os) const
+{
+    os << "read " << readMilliseconds << " ms, parse " << parseMilliseconds << " ms, buffers " << bufferMilliseconds
+        << " ms (" << bufferBytes / 1024 << " KiB), geometry " << geometryMilliseconds << " ms (" << vertexBytes / 1024
+        << " KiB), images " << imageMilliseconds << " ms, total " << totalMilliseconds << " ms";
+}
+
+bool GltfImporter::Load(std::string_view path, JobSystem& jobs, Scene& scene)
+{
+    scene = Scene{};
+    auto fail = [path](const std::string& reason){
+        std::cerr << "Error: " << path << " is not a valid glTF file, " << reason << std::endl;
+        return false;
+    };
+
+    // read
+    auto start{clock::now()};
+    MappedFile file{path};
+    if(!file.IsOpen()){
+        std::cerr << "Error: could not open " << path << std::endl;
+        return false;
+    }
+    std::string_view text{reinterpret_cast<const char*>(file.Data()), file.Size()};
+    const std::byte* binData{};
+    std::size_t binSize{};
+    if(file.Size() >= 12 && ReadValue<std::uint32_t>(file.Data()) == GlbMagic){
+        if(ReadValue<std::uint32_t>(file.Data() + 4) != 2 || ReadValue<std::uint32_t>(file.Data() + 8) > file.Size() || file.Size() < 20){
+            return fail("bad .glb header");
+        }
+        std::uint64_t jsonLength{ReadValue<std::uint32_t>(file.Data() + 12)};
+        if(ReadValue<std::uint32_t>(file.Data() + 16) != GlbJsonChunk || 20 + jsonLength > file.Size()){
+            return fail("bad JSON chunk");
+        }
+        text = std::string_view{reinterpret_cast<const char*>(file.Data() + 20), static_cast<std::size_t>(jsonLength)};
+        // chunks are 4 byte aligned, the BIN chunk is optional
+        auto binHeader{20 + jsonLength};
+        if(binHeader + 8 <= file.Size() && ReadValue<std::uint32_t>(file.Data() + binHeader + 4) == GlbBinChunk){
+            std::uint64_t binLength{ReadValue<std::uint32_t>(file.Data() + binHeader)};
+            if(binHeader + 8 + binLength > file.Size()){
+                return fail("bad BIN chunk");
+            }
+            binData = file.Data() + binHeader + 8;
+            binSize = static_cast<std::size_t>(binLength);
+        }
+    }
+    auto directoryEnd{path.find_last_of("/\\")};
+    auto directory{directoryEnd == std::string_view::npos ? std::string_view{} : path.substr(0, directoryEnd + 1)};
+    auto read{clock::now()};
+
+    // parse
+    JsonValue document;
+    std::string error;
+    if(!JsonValue::Parse(text, document, error)){
+        return fail(error);
+    }
+    if(document["asset"]["version"].AsString().compare(0, 2, "2.") != 0){
+        return fail("only version 2 is supported");
+    }
+    if(document["extensionsRequired"].Size() != 0){
+        return fail("requires extension " + document["extensionsRequired"][0].AsString());
+    }
+    auto parsed{clock::now()};
+
+    // buffers, the first one without uri is the .glb BIN chunk
+    const auto& bufferList{document["buffers"]};
+    std::vector<Buffer> buffers(bufferList.Size());
+    std::vector<char> bufferOk(buffers.size());
+    {
+        JobCounter counter;
+        for(std::size_t i{}; i < buffers.size(); ++i){
+            jobs.Run([&, i](){
+                bufferOk[i] = LoadBuffer(bufferList[i], directory, i == 0 ? binData : nullptr, i == 0 ? binSize : 0, buffers[i]);
+            }, &counter);
+        }
+        jobs.Wait(counter);
+    }
+    for(std::size_t i{}; i < buffers.size(); ++i){
+        if(!bufferOk[i]){
+            return fail("buffer " + std::to_string(i) + " could not be loaded");
+        }
+        scene.timings.bufferBytes += buffers[i].size;
+    }
+    auto buffered{clock::now()};
+
+    // images run as jobs while this thread helps converting the geometry
+    const auto& imageList{document["images"]};
+    scene.images.resize(imageList.Size());
+    std::vector<char> imageOk(scene.images.size());
+    std::atomic<std::int64_t> imagesFinished{};
+    JobCounter imageCounter;
+    for(std::size_t i{}; i < scene.images.size(); ++i){
+        jobs.Run([&, i](){
+            imageOk[i] = DecodeImage(document, buffers, imageList[i], directory, scene.images[i]);
+            auto finished{std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - buffered).count()};
+            auto latest{imagesFinished.load(std::memory_order_relaxed)};
+            while(finished > latest && !imagesFinished.compare_exchange_weak(latest, finished, std::memory_order_relaxed)){
+            }
+        }, &imageCounter);
+    }
+
+    // geometry, one work item per primitive
+    const auto& meshList{document["meshes"]};
+    scene.meshes.resize(meshList.Size());
+    std::vector<std::pair<std::size_t, std::size_t>> work;
+    for(std::size_t m{}; m < meshList.Size(); ++m){
+        scene.meshes[m].name = meshList[m]["name"].AsString();
+        const auto& primitives{meshList[m]["primitives"]};
+        for(std::size_t p{}; p < primitives.Size(); ++p){
+            if(primitives[p]["mode"].AsInt(GL_TRIANGLES) != GL_TRIANGLES){
+                std::cerr << "Warning: " << path << " mesh " << m << " primitive " << p << " is not a triangle list, skipped" << std::endl;
+                continue;
+            }
+            work.emplace_back(m, p);
+        }
+        scene.meshes[m].primitives.resize(primitives.Size());
+    }
+    std::vector<char> primitiveOk(work.size());
+    jobs.ParallelFor(0, work.size(), 1, [&](std::size_t begin, std::size_t end){
+        for(auto i{begin}; i < end; ++i){
+            auto [m, p] = work[i];
+            primitiveOk[i] = ReadPrimitive(document, buffers, meshList[m]["primitives"][p], scene.meshes[m].primitives[p]);
+        }
+    });
+    auto converted{clock::now()};
+    jobs.Wait(imageCounter);
+
+    for(std::size_t i{}; i < work.size(); ++i){
+        if(!primitiveOk[i]){
+            return fail("mesh " + std::to_string(work[i].first) + " primitive " + std::to_string(work[i].second) + " has bad accessors");
+        }
+    }
+    for(auto& mesh : scene.meshes){
+        // skipped primitives left empty slots
+        std::erase_if(mesh.primitives, [](const Primitive& primitive){ return primitive.geometry.vertices.empty(); });
+        for(const auto& primitive : mesh.primitives){
+            scene.timings.vertexBytes += primitive.geometry.vertices.size() + primitive.geometry.indices.size() * sizeof(std::uint32_t);
+        }
+    }
+    for(std::size_t i{}; i < scene.images.size(); ++i){
+        if(!imageOk[i]){
+            // the texture stays black, geometry is still usable
+            std::cerr << "Warning: " << path << " image " << i << " could not be decoded" << std::endl;
+        }
+    }
+
+    FlattenNodes(document, scene.instances);
+    if(document["nodes"].Size() == 0){
+        // a file of bare meshes, show each once
+        for(std::size_t m{}; m < scene.meshes.size(); ++m){
+            scene.instances.push_back(Instance{m, glm::mat4{1.0f}});
+        }
+    }
+    auto finished{clock::now()};
+
+    auto& timings{scene.timings};
+    timings.readMilliseconds = Milliseconds(start, read);
+    timings.parseMilliseconds = Milliseconds(read, parsed);
+    timings.bufferMilliseconds = Milliseconds(parsed, buffered);
+    timings.geometryMilliseconds = Milliseconds(buffered, converted);
+    timings.imageMilliseconds = static_cast<double>(imagesFinished.load()) / 1.0e6;
+    timings.totalMilliseconds = Milliseconds(start, finished);
+    return true;
+}
@@ -0,0 +1,86 @@
+#ifndef GLTF_IMPORTER_H_10192026
+#define GLTF_IMPORTER_H_10192026
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "jobSystem.h"
+#include "meshOptimizer.h"
+#include "texture2D.h"
+
+/*
+glTF 2.0 reader, .gltf with external or base64 data: URI buffers and binary .glb.
+Load() runs in phases, each timed in Timings:
+read      the file is mapped, the JSON chunk split off a .glb
+parse     JSON into a JsonValue document
+buffers   every buffer is mapped or base64 decoded, one job per buffer
+geometry  every primitive's accessors are converted into PositionTexCoordNormalLayout vertices and
+          32 bit indices, primitives are spread over the JobSystem with ParallelFor
+images    Texture2D::Decode() of every image, one job each, started right after the buffers so they
+          overlap the geometry phase, their time is from start to the last finished decode
+Only triangle list primitives are read, accessors of any component type are converted to float
+(normalized ones scaled like the GPU would), sparse accessors and extensions listed as required are
+rejected. Missing texture coordinates or normals are zero, missing indices are generated.
+The base color texture of a primitive's material selects its image, glTF's top left texture origin
+already matches how the vertices sample, so images are not flipped.
+Node hierarchies of the default scene are flattened into one Instance with a world matrix per node
+that references a mesh.
+Load() needs no GL context, GltfModel turns the Scene into GL objects.
+*/
+class GltfImporter
+{
+public:
+    struct Timings
+    {
+        double readMilliseconds{};
+        double parseMilliseconds{};
+        double bufferMilliseconds{};
+        double geometryMilliseconds{};
+        double imageMilliseconds{};
+        double totalMilliseconds{};
+        std::uint64_t bufferBytes{};    // all buffers after decoding
+        std::uint64_t vertexBytes{};    // converted vertices and indices
+
+        void Print(std::ostream& os) const;
+    };
+
+    struct Primitive
+    {
+        MeshOptimizer::WeldResult geometry;     // PositionTexCoordNormalLayout vertices
+        glm::vec3 boundsMin{};
+        glm::vec3 boundsMax{};
+        int image{-1};                          // index into Scene::images, -1 without texture
+    };
+
+    struct MeshData
+    {
+        std::string name;
+        std::vector<Primitive> primitives;
+    };
+
+    struct Instance
+    {
+        std::size_t mesh;
+        glm::mat4 world;
+    };
+
+    struct Scene
+    {
+        std::vector<MeshData> meshes;
+        std::vector<Texture2D::ImageData> images;
+        std::vector<Instance> instances;
+        Timings timings;
+    };
+
+    static bool Load(std::string_view path, JobSystem& jobs, Scene& scene);
+
+    GltfImporter() = delete;
+};
+
+#endif // !GLTF_IMPORTER_H_10192026
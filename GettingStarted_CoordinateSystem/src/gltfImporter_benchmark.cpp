@@ -0,0 +1,282 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <SOIL2/stb_image_write.h>
+
+#include "benchmarkMeshes.h"
+#include "gltfImporter.h"
+#include "jobSystem.h"
+
+// settings
+constexpr std::size_t MESH_COUNT{64};
+constexpr std::size_t RINGS{64};
+constexpr std::size_t SEGMENTS{128};
+constexpr std::size_t IMAGE_COUNT{16};
+constexpr int IMAGE_SIZE{512};
+constexpr int ITERATIONS{5};
+
+namespace
+{
+    struct Corpus
+    {
+        std::vector<std::uint8_t> buffer;
+        std::string json;   // without the buffers and images entries, they differ per container
+        std::vector<std::size_t> viewOffsets, viewSizes;
+        std::size_t geometryViews{};
+        std::vector<std::vector<std::uint8_t>> images;
+    };
+
+    template<typename T>
+    void Append(std::vector<std::uint8_t>& buffer, const T& value)
+    {
+        const auto* bytes{reinterpret_cast<const std::uint8_t*>(&value)};
+        buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+    }
+
+    void Align(std::vector<std::uint8_t>& buffer)
+    {
+        buffer.resize((buffer.size() + 3) / 4 * 4);
+    }
+
+    std::string EncodeBase64(const std::vector<std::uint8_t>& data)
+    {
+        const char* alphabet{"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"};
+        std::string out;
+        out.reserve((data.size() + 2) / 3 * 4);
+        for(std::size_t i{}; i < data.size(); i += 3){
+            std::uint32_t bits{static_cast<std::uint32_t>(data[i]) << 16};
+            if(i + 1 < data.size()){
+                bits |= static_cast<std::uint32_t>(data[i + 1]) << 8;
+            }
+            if(i + 2 < data.size()){
+                bits |= data[i + 2];
+            }
+            out += alphabet[(bits >> 18) & 63];
+            out += alphabet[(bits >> 12) & 63];
+            out += i + 1 < data.size() ? alphabet[(bits >> 6) & 63] : '=';
+            out += i + 2 < data.size() ? alphabet[bits & 63] : '=';
+        }
+        return out;
+    }
+
+    std::vector<std::uint8_t> ReadFile(const std::string& path)
+    {
+        std::ifstream file{path, std::ios::binary};
+        return std::vector<std::uint8_t>{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+    }
+
+    Corpus Generate()
+    {
+        Corpus corpus;
+        std::ostringstream json;
+
+        // every mesh gets its own sphere data so no accessor is read twice
+        const auto sphere{MakeUvSphere(RINGS, SEGMENTS)};
+        const auto vertexCount{sphere.positions.size()};
+        std::ostringstream accessors, meshes;
+        for(std::size_t m{}; m < MESH_COUNT; ++m){
+            auto radius{0.5f + 0.01f * static_cast<float>(m)};
+            auto firstView{corpus.viewOffsets.size()};
+            // positions, normals, texture coordinates, indices
+            std::vector<std::uint8_t> positions, normals, texCoords, indices;
+            glm::vec3 boundsMin{std::numeric_limits<float>::max()}, boundsMax{std::numeric_limits<float>::lowest()};
+            for(std::size_t v{}; v < vertexCount; ++v){
+                const auto& normal{sphere.positions[v]};
+                auto position{normal * radius};
+                boundsMin = glm::min(boundsMin, position);
+                boundsMax = glm::max(boundsMax, position);
+                Append(positions, position);
+                Append(normals, normal);
+                Append(texCoords, static_cast<std::uint16_t>(65535.0f * sphere.texCoords[v].x + 0.5f));
+                Append(texCoords, static_cast<std::uint16_t>(65535.0f * sphere.texCoords[v].y + 0.5f));
+            }
+            for(auto index : sphere.indices){
+                Append(indices, static_cast<std::uint16_t>(index));
+            }
+            for(auto* stream : {&positions, &normals, &texCoords, &indices}){
+                corpus.viewOffsets.push_back(corpus.buffer.size());
+                corpus.viewSizes.push_back(stream->size());
+                corpus.buffer.insert(corpus.buffer.end(), stream->begin(), stream->end());
+                Align(corpus.buffer);
+            }
+            auto indexCount{RINGS * SEGMENTS * 6};
+            accessors << (m ? "," : "")
+                << "{\"bufferView\":" << firstView << ",\"componentType\":5126,\"count\":" << vertexCount
+                << ",\"type\":\"VEC3\",\"min\":[" << boundsMin.x << "," << boundsMin.y << "," << boundsMin.z
+                << "],\"max\":[" << boundsMax.x << "," << boundsMax.y << "," << boundsMax.z << "]},"
+                << "{\"bufferView\":" << firstView + 1 << ",\"componentType\":5126,\"count\":" << vertexCount << ",\"type\":\"VEC3\"},"
+                << "{\"bufferView\":" << firstView + 2 << ",\"componentType\":5123,\"normalized\":true,\"count\":" << vertexCount
+                << ",\"type\":\"VEC2\"},"
+                << "{\"bufferView\":" << firstView + 3 << ",\"componentType\":5123,\"count\":" << indexCount << ",\"type\":\"SCALAR\"}";
+            meshes << (m ? "," : "") << "{\"name\":\"sphere" << m << "\",\"primitives\":[{\"attributes\":{\"POSITION\":" << firstView
+                << ",\"NORMAL\":" << firstView + 1 << ",\"TEXCOORD_0\":" << firstView + 2 << "},\"indices\":" << firstView + 3
+                << ",\"material\":" << m % IMAGE_COUNT << "}]}";
+        }
+        corpus.geometryViews = corpus.viewOffsets.size();
+
+        // checker images as PNG files, their bytes are kept for the embedded and binary variants
+        for(std::size_t i{}; i < IMAGE_COUNT; ++i){
+            std::vector<std::uint8_t> pixels(IMAGE_SIZE * IMAGE_SIZE * 4);
+            for(int y{}; y < IMAGE_SIZE; ++y){
+                for(int x{}; x < IMAGE_SIZE; ++x){
+                    auto* pixel{&pixels[(y * IMAGE_SIZE + x) * 4]};
+                    bool odd{((x / 32) + (y / 32)) % 2 != 0};
+                    pixel[0] = static_cast<std::uint8_t>(odd ? 255 : 16 * i);
+                    pixel[1] = static_cast<std::uint8_t>(x * 255 / IMAGE_SIZE);
+                    pixel[2] = static_cast<std::uint8_t>(y * 255 / IMAGE_SIZE);
+                    pixel[3] = 255;
+                }
+            }
+            auto path{"gltfImporter_benchmark_" + std::to_string(i) + ".png"};
+            stbi_write_png(path.c_str(), IMAGE_SIZE, IMAGE_SIZE, 4, pixels.data(), IMAGE_SIZE * 4);
+            corpus.images.push_back(ReadFile(path));
+        }
+
+        // root node with a child per mesh in a ring around it
+        constexpr float pi{3.14159265358979f};
+        std::ostringstream nodes, children, materials, textures;
+        for(std::size_t m{}; m < MESH_COUNT; ++m){
+            auto angle{2.0f * pi * static_cast<float>(m) / MESH_COUNT};
+            nodes << ",{\"mesh\":" << m << ",\"translation\":[" << 10.0f * std::cos(angle) << ",0," << 10.0f * std::sin(angle)
+                << "],\"rotation\":[0," << std::sin(angle / 2.0f) << ",0," << std::cos(angle / 2.0f) << "]}";
+            children << (m ? "," : "") << m + 1;
+        }
+        for(std::size_t i{}; i < IMAGE_COUNT; ++i){
+            materials << (i ? "," : "") << "{\"pbrMetallicRoughness\":{\"baseColorTexture\":{\"index\":" << i << "}}}";
+            textures << (i ? "," : "") << "{\"source\":" << i << "}";
+        }
+        json << "\"asset\":{\"version\":\"2.0\",\"generator\":\"gltfImporter_benchmark\"},\"scene\":0,"
+            << "\"scenes\":[{\"nodes\":[0]}],\"nodes\":[{\"scale\":[2,2,2],\"children\":[" << children.str() << "]}"
+            << nodes.str() << "],\"meshes\":[" << meshes.str() << "],\"materials\":[" << materials.str()
+            << "],\"textures\":[" << textures.str() << "],\"accessors\":[" << accessors.str() << "]";
+        corpus.json = json.str();
+        return corpus;
+    }
+
+    std::string BufferViews(const Corpus& corpus, std::size_t count)
+    {
+        std::ostringstream views;
+        for(std::size_t i{}; i < count; ++i){
+            views << (i ? "," : "") << "{\"buffer\":0,\"byteOffset\":" << corpus.viewOffsets[i] << ",\"byteLength\":" << corpus.viewSizes[i] << "}";
+        }
+        return views.str();
+    }
+
+    void WriteSplit(const Corpus& corpus, const std::string& path)
+    {
+        std::ofstream{"gltfImporter_benchmark.bin", std::ios::binary}.write(reinterpret_cast<const char*>(corpus.buffer.data()),
+                                                                            static_cast<std::streamsize>(corpus.buffer.size()));
+        std::ostringstream images;
+        for(std::size_t i{}; i < IMAGE_COUNT; ++i){
+            images << (i ? "," : "") << "{\"uri\":\"gltfImporter_benchmark_" << i << ".png\"}";
+        }
+        std::ofstream{path} << "{" << corpus.json << ",\"buffers\":[{\"uri\":\"gltfImporter_benchmark.bin\",\"byteLength\":"
+            << corpus.buffer.size() << "}],\"bufferViews\":[" << BufferViews(corpus, corpus.geometryViews) << "],\"images\":["
+            << images.str() << "]}";
+    }
+
+    void WriteEmbedded(const Corpus& corpus, const std::string& path)
+    {
+        std::ostringstream images;
+        for(std::size_t i{}; i < IMAGE_COUNT; ++i){
+            images << (i ? "," : "") << "{\"uri\":\"data:image/png;base64," << EncodeBase64(corpus.images[i]) << "\"}";
+        }
+        std::ofstream{path} << "{" << corpus.json << ",\"buffers\":[{\"uri\":\"data:application/octet-stream;base64,"
+            << EncodeBase64(corpus.buffer) << "\",\"byteLength\":" << corpus.buffer.size() << "}],\"bufferViews\":["
+            << BufferViews(corpus, corpus.geometryViews) << "],\"images\":[" << images.str() << "]}";
+    }
+
+    void WriteBinary(Corpus corpus, const std::string& path)
+    {
+        std::ostringstream images;
+        for(std::size_t i{}; i < IMAGE_COUNT; ++i){
+            corpus.viewOffsets.push_back(corpus.buffer.size());
+            corpus.viewSizes.push_back(corpus.images[i].size());
+            corpus.buffer.insert(corpus.buffer.end(), corpus.images[i].begin(), corpus.images[i].end());
+            Align(corpus.buffer);
+            images << (i ? "," : "") << "{\"bufferView\":" << corpus.geometryViews + i << ",\"mimeType\":\"image/png\"}";
+        }
+        std::string json{"{" + corpus.json + ",\"buffers\":[{\"byteLength\":" + std::to_string(corpus.buffer.size()) +
+                         "}],\"bufferViews\":[" + BufferViews(corpus, corpus.viewOffsets.size()) + "],\"images\":[" +
+                         images.str() + "]}"};
+        // chunks are padded to 4 bytes, JSON with spaces
+        json.resize((json.size() + 3) / 4 * 4, ' ');
+        std::vector<std::uint8_t> glb;
+        Append(glb, std::uint32_t{0x46546c67});
+        Append(glb, std::uint32_t{2});
+        Append(glb, static_cast<std::uint32_t>(12 + 8 + json.size() + 8 + corpus.buffer.size()));
+        Append(glb, static_cast<std::uint32_t>(json.size()));
+        Append(glb, std::uint32_t{0x4e4f534a});
+        glb.insert(glb.end(), json.begin(), json.end());
+        Append(glb, static_cast<std::uint32_t>(corpus.buffer.size()));
+        Append(glb, std::uint32_t{0x004e4942});
+        glb.insert(glb.end(), corpus.buffer.begin(), corpus.buffer.end());
+        std::ofstream{path, std::ios::binary}.write(reinterpret_cast<const char*>(glb.data()), static_cast<std::streamsize>(glb.size()));
+    }
+}
+
+/*
+Generates a corpus of the same scene stored three ways and measures how fast GltfImporter brings
+each in on one thread and on all of them:
+split     .gltf with an external .bin buffer and external .png images
+embedded  .gltf with the buffer and images as base64 data: URIs
+binary    .glb with buffer and images in the BIN chunk
+The scene has MESH_COUNT UV spheres of RINGS * SEGMENTS quads under a two level node hierarchy,
+positions and normals are floats, texture coordinates normalized unsigned shorts and indices 16 bit,
+so the accessor conversion does real work. Every mesh uses one of IMAGE_COUNT checker textures.
+The phases of the fastest of ITERATIONS imports are reported.
+*/
+int main()
+{
+    auto corpus{Generate()};
+    const char* split{"gltfImporter_benchmark_split.gltf"};
+    const char* embedded{"gltfImporter_benchmark_embedded.gltf"};
+    const char* binary{"gltfImporter_benchmark.glb"};
+    WriteSplit(corpus, split);
+    WriteEmbedded(corpus, embedded);
+    WriteBinary(corpus, binary);
+
+    auto triangles{MESH_COUNT * RINGS * SEGMENTS * 2};
+    std::cout << MESH_COUNT << " meshes, " << triangles << " triangles, " << IMAGE_COUNT << " images of " << IMAGE_SIZE
+        << "x" << IMAGE_SIZE << ", " << std::thread::hardware_concurrency() << " hardware threads\n";
+
+    bool ok{true};
+    for(const char* path : {split, embedded, binary}){
+        for(unsigned int threads : {1u, std::max(std::thread::hardware_concurrency(), 1u)}){
+            JobSystem jobs{threads};
+            GltfImporter::Timings best{};
+            for(int iteration{}; iteration < ITERATIONS; ++iteration){
+                GltfImporter::Scene scene;
+                if(!GltfImporter::Load(path, jobs, scene) || scene.instances.size() != MESH_COUNT){
+                    ok = false;
+                    break;
+                }
+                if(iteration == 0 || scene.timings.totalMilliseconds < best.totalMilliseconds){
+                    best = scene.timings;
+                }
+            }
+            std::cout << path << ", " << threads << " threads: ";
+            best.Print(std::cout);
+            std::cout << ", " << static_cast<double>(triangles) / best.totalMilliseconds / 1000.0 << " M triangles/s\n";
+        }
+    }
+
+    std::remove(split);
+    std::remove(embedded);
+    std::remove(binary);
+    std::remove("gltfImporter_benchmark.bin");
+    for(std::size_t i{}; i < IMAGE_COUNT; ++i){
+        std::remove(("gltfImporter_benchmark_" + std::to_string(i) + ".png").c_str());
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,37 @@
+#include "gltfModel.h"
+#include <chrono>
+
+GltfModel::GltfModel(VertexArrayCache& vertexArrays, const GltfImporter::Scene& scene)
+    : m_uploadMilliseconds{}
+{
+    auto start{std::chrono::steady_clock::now()};
+
+    for(const auto& image : scene.images){
+        m_textures.push_back(std::make_unique<Texture2D>(image, GL_REPEAT, GL_REPEAT, GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR));
+    }
+
+    // meshes of glTF mesh m start at firstMesh[m]
+    std::vector<std::size_t> firstMesh;
+    for(const auto& meshData : scene.meshes){
+        firstMesh.push_back(m_meshes.size());
+        for(const auto& primitive : meshData.primitives){
+            const auto& geometry{primitive.geometry};
+            auto indices{MeshOptimizer::PackIndices(geometry.indices, geometry.VertexCount())};
+            m_meshes.push_back(std::make_unique<Mesh>(vertexArrays, PositionTexCoordNormalLayout{}, geometry.vertices.data(),
+                                                      geometry.VertexCount(), VertexStorage::Interleaved,
+                                                      indices.data.data(), indices.count, indices.type));
+        }
+    }
+
+    for(const auto& instance : scene.instances){
+        const auto& primitives{scene.meshes[instance.mesh].primitives};
+        for(std::size_t p{}; p < primitives.size(); ++p){
+            const auto& primitive{primitives[p]};
+            m_drawItems.push_back(DrawItem{m_meshes[firstMesh[instance.mesh] + p].get(),
+                                           primitive.image >= 0 ? m_textures[primitive.image].get() : nullptr,
+                                           instance.world, primitive.boundsMin, primitive.boundsMax});
+        }
+    }
+
+    m_uploadMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
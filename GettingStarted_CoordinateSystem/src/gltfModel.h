@@ -0,0 +1,50 @@
+#ifndef GLTF_MODEL_H_10192026
+#define GLTF_MODEL_H_10192026
+
+#include <memory>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "gltfImporter.h"
+#include "mesh.h"
+#include "texture2D.h"
+#include "vertexArrayCache.h"
+
+/*
+GL objects of an imported glTF scene, created on the GL thread from GltfImporter::Scene.
+Every primitive becomes a Mesh with 16 bit indices where they fit, every decoded image a Texture2D.
+GetDrawItems() lists one entry per primitive of every instance with its world matrix and object
+space bounds, ready for FrustumCuller and DrawPacket. texture is null for untextured primitives.
+*/
+class GltfModel
+{
+public:
+    struct DrawItem
+    {
+        const Mesh* mesh;
+        Texture2D* texture;
+        glm::mat4 world;
+        glm::vec3 boundsMin;
+        glm::vec3 boundsMax;
+    };
+
+    GltfModel(VertexArrayCache& vertexArrays, const GltfImporter::Scene& scene);
+
+    inline const std::vector<DrawItem>& GetDrawItems() const { return m_drawItems; }
+    inline double GetUploadMilliseconds() const { return m_uploadMilliseconds; }
+
+    GltfModel() = delete;
+    GltfModel(const GltfModel&) = delete;
+    GltfModel(GltfModel&&) = delete;
+    GltfModel& operator=(const GltfModel&) = delete;
+    GltfModel& operator=(GltfModel&&) = delete;
+
+private:
+    std::vector<std::unique_ptr<Mesh>> m_meshes;
+    std::vector<std::unique_ptr<Texture2D>> m_textures;
+    std::vector<DrawItem> m_drawItems;
+    double m_uploadMilliseconds;
+};
+
+#endif // !GLTF_MODEL_H_10192026
@@ -0,0 +1,154 @@
+#include "gpuCuller.h"
+#include "glStateCache.h"
+#include <cassert>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+#include "frustumCuller.h"
+
+GpuCuller::GpuCuller(const ComputeProgram& cullProgram, std::size_t maxObjects)
+    : m_cullProgram{cullProgram}, m_maxObjects{maxObjects}, m_objectCount{},
+    m_objectBuffer{}, m_commandBuffer{}, m_countBuffer{}, m_objectIndexBuffer{},
+    m_indexCount{}, m_firstIndex{}, m_baseVertex{}, m_hiZ{},
+    m_hasIndirectCount{glMultiDrawElementsIndirectCount != nullptr}
+{
+    if(!m_hasIndirectCount){
+        std::cerr << "glMultiDrawElementsIndirectCount not available, drawing every command slot" << std::endl;
+    }
+
+    glGenBuffers(1, &m_objectBuffer);
+    GLStateCache::Current().BindBuffer(GL_SHADER_STORAGE_BUFFER, m_objectBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, maxObjects * sizeof(GpuObject), nullptr, GL_DYNAMIC_DRAW);
+
+    glGenBuffers(1, &m_commandBuffer);
+    GLStateCache::Current().BindBuffer(GL_SHADER_STORAGE_BUFFER, m_commandBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, maxObjects * sizeof(DrawElementsIndirectCommand), nullptr, GL_DYNAMIC_COPY);
+
+    glGenBuffers(1, &m_countBuffer);
+    GLStateCache::Current().BindBuffer(GL_SHADER_STORAGE_BUFFER, m_countBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(Stats), nullptr, GL_DYNAMIC_COPY);
+    GLStateCache::Current().BindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    // 0, 1, 2 ... read per instance, the draw's baseInstance selects the object
+    std::vector<unsigned int> objectIndices(maxObjects);
+    std::iota(objectIndices.begin(), objectIndices.end(), 0u);
+    glGenBuffers(1, &m_objectIndexBuffer);
+    GLStateCache::Current().BindBuffer(GL_ARRAY_BUFFER, m_objectIndexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, objectIndices.size() * sizeof(objectIndices.front()), objectIndices.data(), GL_STATIC_DRAW);
+    GLStateCache::Current().BindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+GpuCuller::~GpuCuller()
+{
+    GLStateCache::Current().DeleteBuffer(m_objectBuffer);
+    GLStateCache::Current().DeleteBuffer(m_commandBuffer);
+    GLStateCache::Current().DeleteBuffer(m_countBuffer);
+    GLStateCache::Current().DeleteBuffer(m_objectIndexBuffer);
+}
+
+void GpuCuller::SetObjects(const GpuObject* objects, std::size_t count)
+{
+    assert(count <= m_maxObjects);
+    m_objectCount = count;
+    GLStateCache::Current().BindBuffer(GL_SHADER_STORAGE_BUFFER, m_objectBuffer);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, count * sizeof(GpuObject), objects);
+    GLStateCache::Current().BindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void GpuCuller::SetMesh(unsigned int indexCount, unsigned int firstIndex, int baseVertex)
+{
+    m_indexCount = indexCount;
+    m_firstIndex = firstIndex;
+    m_baseVertex = baseVertex;
+}
+
+void GpuCuller::EnableObjectIndexAttribute(unsigned int vao, unsigned int location) const
+{
+    GLStateCache::Current().BindVertexArray(vao);
+    GLStateCache::Current().BindBuffer(GL_ARRAY_BUFFER, m_objectIndexBuffer);
+    glVertexAttribIPointer(location, 1, GL_UNSIGNED_INT, sizeof(unsigned int), reinterpret_cast<void*>(0));
+    glVertexAttribDivisor(location, 1);
+    glEnableVertexAttribArray(location);
+    GLStateCache::Current().BindBuffer(GL_ARRAY_BUFFER, 0);
+    GLStateCache::Current().BindVertexArray(0);
+}
+
+void GpuCuller::Cull(const glm::mat4& viewProjection)
+{
+    const unsigned int zero{};
+    GLStateCache::Current().BindBuffer(GL_SHADER_STORAGE_BUFFER, m_countBuffer);
+    glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+    if(!m_hasIndirectCount){
+        // stale commands from the last frame must not draw anything
+        GLStateCache::Current().BindBuffer(GL_SHADER_STORAGE_BUFFER, m_commandBuffer);
+        glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+    }
+    GLStateCache::Current().BindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    auto planes{FrustumCuller::ExtractPlanes(viewProjection)};
+
+    m_cullProgram.Bind();
+    glUniform4fv(m_cullProgram.GetUniformLocation("planes[0]"), static_cast<GLsizei>(planes.size()), &planes[0].x);
+    glUniform1ui(m_cullProgram.GetUniformLocation("objectCount"), static_cast<unsigned int>(m_objectCount));
+    glUniform1ui(m_cullProgram.GetUniformLocation("indexCount"), m_indexCount);
+    glUniform1ui(m_cullProgram.GetUniformLocation("firstIndex"), m_firstIndex);
+    glUniform1i(m_cullProgram.GetUniformLocation("baseVertex"), m_baseVertex);
+
+    bool occlusion{m_hiZ != nullptr && m_hiZ->IsBuilt()};
+    glUniform1i(m_cullProgram.GetUniformLocation("occlusion"), occlusion);
+    if(occlusion){
+        m_hiZ->Bind();
+        // the planes are of this frame, the boxes are projected like the pyramid's depth was
+        glUniformMatrix4fv(m_cullProgram.GetUniformLocation("hiZViewProjection"), 1, GL_FALSE,
+                           glm::value_ptr(m_hiZ->GetViewProjection()));
+        glUniform1i(m_cullProgram.GetUniformLocation("hiZ"), HiZPyramid::TextureUnit);
+        glUniform2i(m_cullProgram.GetUniformLocation("hiZSize"), m_hiZ->GetWidth(), m_hiZ->GetHeight());
+        glUniform1i(m_cullProgram.GetUniformLocation("hiZLevels"), m_hiZ->GetLevelCount());
+    }
+
+    GLStateCache::Current().BindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_objectBuffer);
+    GLStateCache::Current().BindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_commandBuffer);
+    GLStateCache::Current().BindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_countBuffer);
+
+    m_cullProgram.DispatchThreads(static_cast<unsigned int>(m_objectCount));
+
+    // the commands and count are read by the draw, the objects by the vertex shader
+    ComputeProgram::Barrier(ComputeProgram::Command | ComputeProgram::StorageBuffer);
+}
+
+void GpuCuller::Draw(GLenum indexType) const
+{
+    // the vertex shader reads the models from binding 0
+    GLStateCache::Current().BindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_objectBuffer);
+    GLStateCache::Current().BindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+    if(m_hasIndirectCount){
+        GLStateCache::Current().BindBuffer(GL_PARAMETER_BUFFER, m_countBuffer);
+        glMultiDrawElementsIndirectCount(GL_TRIANGLES, indexType, nullptr, 0,
+                                         static_cast<GLsizei>(m_objectCount), sizeof(DrawElementsIndirectCommand));
+        GLStateCache::Current().BindBuffer(GL_PARAMETER_BUFFER, 0);
+    }
+    else{
+        glMultiDrawElementsIndirect(GL_TRIANGLES, indexType, nullptr,
+                                    static_cast<GLsizei>(m_objectCount), sizeof(DrawElementsIndirectCommand));
+    }
+    GLStateCache::Current().BindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+unsigned int GpuCuller::ReadVisibleCount() const
+{
+    unsigned int count{};
+    GLStateCache::Current().BindBuffer(GL_SHADER_STORAGE_BUFFER, m_countBuffer);
+    glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(count), &count);
+    GLStateCache::Current().BindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    return count;
+}
+
+GpuCuller::Stats GpuCuller::ReadStats() const
+{
+    Stats stats{};
+    GLStateCache::Current().BindBuffer(GL_SHADER_STORAGE_BUFFER, m_countBuffer);
+    glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(stats), &stats);
+    GLStateCache::Current().BindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    return stats;
+}
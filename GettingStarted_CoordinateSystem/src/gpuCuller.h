@@ -0,0 +1,93 @@
+#ifndef GPU_CULLER_H_10192026
+#define GPU_CULLER_H_10192026
+
+#include <cstddef>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "computeProgram.h"
+#include "hiZPyramid.h"
+
+// std430 layout of an object in cull.comp and coordinate_indirect.vert
+struct GpuObject
+{
+    glm::mat4 model;
+    glm::vec4 bounds;   // local bounding sphere, center in xyz and radius in w
+};
+
+// layout glMultiDrawElementsIndirect expects
+struct DrawElementsIndirectCommand
+{
+    unsigned int count;
+    unsigned int instanceCount;
+    unsigned int firstIndex;
+    int baseVertex;
+    unsigned int baseInstance;
+};
+
+/*
+Frustum culling on the GPU feeding indirect draws.
+Object models and bounds live in a shader storage buffer, the cull.comp program tests every object
+against the frustum planes and atomically appends a DrawElementsIndirectCommand for each visible one.
+Draw() submits them with glMultiDrawElementsIndirectCount using the count the shader wrote,
+without the count ever coming back to the CPU.
+Each command's baseInstance is the object index, EnableObjectIndexAttribute() adds a per instance
+attribute to a VAO so the vertex shader can fetch its model from the same storage buffer (binding 0).
+With SetOcclusion() the objects passing the frustum are also tested against a HiZPyramid of the
+previous frame, projected with that frame's view projection, the shader counts how many objects each test rejected for ReadStats().
+Without GL 4.6 / ARB_indirect_parameters the command buffer is zeroed every frame and
+all slots are drawn with glMultiDrawElementsIndirect, unused slots have no instances.
+*/
+class GpuCuller
+{
+public:
+    // layout of the DrawCount buffer in cull.comp
+    struct Stats
+    {
+        unsigned int visible;
+        unsigned int frustumCulled;
+        unsigned int occlusionCulled;
+    };
+
+    explicit GpuCuller(const ComputeProgram& cullProgram, std::size_t maxObjects);
+    ~GpuCuller();
+
+    void SetObjects(const GpuObject* objects, std::size_t count);
+    void SetMesh(unsigned int indexCount, unsigned int firstIndex = 0, int baseVertex = 0);
+    void EnableObjectIndexAttribute(unsigned int vao, unsigned int location) const;
+    // nullptr turns the occlusion test off, the pyramid is only used once it was built
+    inline void SetOcclusion(const HiZPyramid* pyramid) { m_hiZ = pyramid; }
+
+    void Cull(const glm::mat4& viewProjection);
+    void Draw(GLenum indexType = GL_UNSIGNED_INT) const;
+
+    // reads the visible count back, stalls until the cull pass finished so only use it for statistics
+    unsigned int ReadVisibleCount() const;
+    Stats ReadStats() const;
+    inline std::size_t GetObjectCount() const { return m_objectCount; }
+
+    GpuCuller(const GpuCuller&) = delete;
+    GpuCuller(GpuCuller&&) = delete;
+    GpuCuller& operator=(const GpuCuller&) = delete;
+    GpuCuller& operator=(GpuCuller&&) = delete;
+
+private:
+    const ComputeProgram& m_cullProgram;
+    std::size_t m_maxObjects;
+    std::size_t m_objectCount;
+
+    unsigned int m_objectBuffer;
+    unsigned int m_commandBuffer;
+    unsigned int m_countBuffer;
+    unsigned int m_objectIndexBuffer;
+
+    unsigned int m_indexCount;
+    unsigned int m_firstIndex;
+    int m_baseVertex;
+
+    const HiZPyramid* m_hiZ;
+    bool m_hasIndirectCount;
+};
+
+#endif // !GPU_CULLER_H_10192026
@@ -0,0 +1,57 @@
+#ifndef GPU_TIMER_H_10192026
+#define GPU_TIMER_H_10192026
+
+#include <glad/glad.h>
+
+/*
+GL_TIME_ELAPSED query around a block of GL commands.
+Two queries alternate so the result read in Begin() belongs to the frame before the last one
+and is normally ready, GetMilliseconds() lags the measured work by two frames.
+Timer queries can not nest, only one GpuTimer may be between Begin() and End() at a time.
+*/
+class GpuTimer
+{
+public:
+    GpuTimer()
+        : m_queries{}, m_pending{}, m_current{}, m_milliseconds{}
+    {
+        glGenQueries(2, m_queries);
+    }
+
+    ~GpuTimer()
+    {
+        glDeleteQueries(2, m_queries);
+    }
+
+    inline void Begin()
+    {
+        if(m_pending[m_current]){
+            GLuint64 nanoseconds{};
+            glGetQueryObjectui64v(m_queries[m_current], GL_QUERY_RESULT, &nanoseconds);
+            m_milliseconds = static_cast<double>(nanoseconds) / 1.0e6;
+        }
+        glBeginQuery(GL_TIME_ELAPSED, m_queries[m_current]);
+    }
+
+    inline void End()
+    {
+        glEndQuery(GL_TIME_ELAPSED);
+        m_pending[m_current] = true;
+        m_current ^= 1;
+    }
+
+    inline double GetMilliseconds() const { return m_milliseconds; }
+
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer(GpuTimer&&) = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+    GpuTimer& operator=(GpuTimer&&) = delete;
+
+private:
+    unsigned int m_queries[2];
+    bool m_pending[2];
+    unsigned int m_current;
+    double m_milliseconds;
+};
+
+#endif // !GPU_TIMER_H_10192026
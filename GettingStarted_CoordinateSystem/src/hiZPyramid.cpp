@@ -0,0 +1,90 @@
+#include "hiZPyramid.h"
+#include "glStateCache.h"
+#include <algorithm>
+#include <cassert>
+
+HiZPyramid::HiZPyramid(const ComputeProgram& copyProgram, const ComputeProgram& downsampleProgram)
+    : m_copyProgram{copyProgram}, m_downsampleProgram{downsampleProgram},
+    m_depthTexture{}, m_pyramidTexture{}, m_width{}, m_height{}, m_levelCount{}, m_viewProjection{1.0f}, m_built{}
+{}
+
+HiZPyramid::~HiZPyramid()
+{
+    Release();
+}
+
+void HiZPyramid::Build(int width, int height, const glm::mat4& viewProjection)
+{
+    assert(width > 0 && height > 0);
+    if(width != m_width || height != m_height){
+        Resize(width, height);
+    }
+
+    GLStateCache::Current().BindTexture(TextureUnit, GL_TEXTURE_2D, m_depthTexture);
+    glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, m_width, m_height);
+
+    m_copyProgram.Bind();
+    glUniform1i(m_copyProgram.GetUniformLocation("depthTexture"), TextureUnit);
+    glBindImageTexture(0, m_pyramidTexture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RG32F);
+    m_copyProgram.DispatchThreads(m_width, m_height);
+
+    for(int level{1}; level < m_levelCount; ++level){
+        // the previous level has to be written before it is read
+        ComputeProgram::Barrier(ComputeProgram::ImageAccess);
+        glBindImageTexture(0, m_pyramidTexture, level - 1, GL_FALSE, 0, GL_READ_ONLY, GL_RG32F);
+        glBindImageTexture(1, m_pyramidTexture, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_RG32F);
+        m_downsampleProgram.DispatchThreads(std::max(m_width >> level, 1), std::max(m_height >> level, 1));
+    }
+
+    // the cull pass fetches the pyramid as a texture
+    ComputeProgram::Barrier(ComputeProgram::TextureFetch);
+    GLStateCache::Current().BindTexture(TextureUnit, GL_TEXTURE_2D, m_pyramidTexture);
+    m_viewProjection = viewProjection;
+    m_built = true;
+}
+
+void HiZPyramid::Bind() const
+{
+    GLStateCache::Current().BindTexture(TextureUnit, GL_TEXTURE_2D, m_pyramidTexture);
+}
+
+void HiZPyramid::Resize(int width, int height)
+{
+    Release();
+    m_width = width;
+    m_height = height;
+    m_levelCount = 1;
+    while((std::max(m_width, m_height) >> m_levelCount) > 0){
+        ++m_levelCount;
+    }
+
+    glGenTextures(1, &m_depthTexture);
+    GLStateCache::Current().BindTexture(TextureUnit, GL_TEXTURE_2D, m_depthTexture);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_DEPTH_COMPONENT24, m_width, m_height);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_NONE);
+
+    glGenTextures(1, &m_pyramidTexture);
+    GLStateCache::Current().BindTexture(TextureUnit, GL_TEXTURE_2D, m_pyramidTexture);
+    glTexStorage2D(GL_TEXTURE_2D, m_levelCount, GL_RG32F, m_width, m_height);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    GLStateCache::Current().BindTexture(TextureUnit, GL_TEXTURE_2D, 0);
+
+    m_built = false;
+}
+
+void HiZPyramid::Release()
+{
+    if(m_depthTexture){
+        GLStateCache::Current().DeleteTexture(m_depthTexture);
+        m_depthTexture = 0;
+    }
+    if(m_pyramidTexture){
+        GLStateCache::Current().DeleteTexture(m_pyramidTexture);
+        m_pyramidTexture = 0;
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef HIZ_PYRAMID_H_10192026
+#define HIZ_PYRAMID_H_10192026
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "computeProgram.h"
+
+/*
+Hierarchical depth pyramid for occlusion culling.
+Build() copies the depth buffer of the current read framebuffer, call it after the scene was drawn
+and before the buffers are swapped, with the view projection the scene was drawn with. hiz_copy.comp writes it to level 0 of an RG32F texture and
+hiz_downsample.comp reduces every level into the next one, keeping the nearest depth in r and
+the farthest in g. Odd sized levels fold their last row/column into the last texel of the next
+level, so level n texel (x >> n, y >> n) clamped to the level size covers level 0 texel (x, y).
+The pyramid of frame N is tested against in frame N + 1, objects have to be projected with
+GetViewProjection(), the matrix of frame N, for their box to land on the depth that was behind
+them then. Objects uncovered by a fast camera move can still be missing for one frame.
+*/
+class HiZPyramid
+{
+public:
+    // texture unit used while building and for sampling in the cull pass
+    static constexpr unsigned int TextureUnit{15};
+
+    explicit HiZPyramid(const ComputeProgram& copyProgram, const ComputeProgram& downsampleProgram);
+    ~HiZPyramid();
+
+    void Build(int width, int height, const glm::mat4& viewProjection);
+    void Bind() const;
+
+    inline bool IsBuilt() const { return m_built; }
+    inline int GetWidth() const { return m_width; }
+    inline int GetHeight() const { return m_height; }
+    inline int GetLevelCount() const { return m_levelCount; }
+    inline const glm::mat4& GetViewProjection() const { return m_viewProjection; }
+
+    HiZPyramid(const HiZPyramid&) = delete;
+    HiZPyramid(HiZPyramid&&) = delete;
+    HiZPyramid& operator=(const HiZPyramid&) = delete;
+    HiZPyramid& operator=(HiZPyramid&&) = delete;
+
+private:
+    void Resize(int width, int height);
+    void Release();
+
+    const ComputeProgram& m_copyProgram;
+    const ComputeProgram& m_downsampleProgram;
+
+    unsigned int m_depthTexture;
+    unsigned int m_pyramidTexture;
+    int m_width;
+    int m_height;
+    int m_levelCount;
+    glm::mat4 m_viewProjection;
+    bool m_built;
+};
+
+#endif // !HIZ_PYRAMID_H_10192026
@@ -0,0 +1,86 @@
+#include "imageDiff.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // YIQ distance of black and white, the largest one possible
+    constexpr float MaxDelta{35215.0f};
+
+    struct Yiq
+    {
+        float y, i, q;
+    };
+
+    Yiq ToYiq(const unsigned char* pixel)
+    {
+        // blended over white, transparent pixels look the same whatever their color
+        auto alpha{pixel[3] / 255.0f};
+        auto r{255.0f + (pixel[0] - 255.0f) * alpha};
+        auto g{255.0f + (pixel[1] - 255.0f) * alpha};
+        auto b{255.0f + (pixel[2] - 255.0f) * alpha};
+        return Yiq{r * 0.29889531f + g * 0.58662247f + b * 0.11448223f,
+                   r * 0.59597799f - g * 0.27417610f - b * 0.32180189f,
+                   r * 0.21147017f - g * 0.52261711f + b * 0.31114694f};
+    }
+}
+
+float ImageDiff::PixelDistance(const unsigned char* a, const unsigned char* b)
+{
+    if(a[0] == b[0] && a[1] == b[1] && a[2] == b[2] && a[3] == b[3]){
+        return 0.0f;
+    }
+    auto first{ToYiq(a)};
+    auto second{ToYiq(b)};
+    auto y{first.y - second.y};
+    auto i{first.i - second.i};
+    auto q{first.q - second.q};
+    auto delta{0.5053f * y * y + 0.299f * i * i + 0.1957f * q * q};
+    return std::min(std::sqrt(delta / MaxDelta), 1.0f);
+}
+
+ImageDiff::Result ImageDiff::Compare(const Texture2D::ImageData& expected, const Texture2D::ImageData& actual,
+                                     const Tolerance& tolerance, Texture2D::ImageData* diff)
+{
+    Result result{};
+    if(expected.width != actual.width || expected.height != actual.height ||
+       expected.pixels.size() != actual.pixels.size()){
+        result.sizeMismatch = true;
+        return result;
+    }
+
+    const auto pixelCount{static_cast<std::size_t>(expected.width) * static_cast<std::size_t>(expected.height)};
+    if(diff != nullptr){
+        diff->width = expected.width;
+        diff->height = expected.height;
+        diff->pixels.resize(pixelCount * 4);
+    }
+
+    for(std::size_t p{}; p < pixelCount; ++p){
+        const auto* a{&expected.pixels[p * 4]};
+        const auto* b{&actual.pixels[p * 4]};
+        auto distance{PixelDistance(a, b)};
+        result.maxDistance = std::max(result.maxDistance, distance);
+        bool different{distance > tolerance.threshold};
+        result.differentPixels += different ? 1 : 0;
+
+        if(diff != nullptr){
+            auto* out{&diff->pixels[p * 4]};
+            if(different){
+                out[0] = 255;
+                out[1] = 0;
+                out[2] = 0;
+            }
+            else{
+                // brightness of the expected pixel, faded toward white
+                auto grey{static_cast<unsigned char>(255.0f - (255.0f - ToYiq(a).y) * 0.25f)};
+                out[0] = out[1] = out[2] = grey;
+            }
+            out[3] = 255;
+        }
+    }
+
+    result.differentFraction = pixelCount != 0 ? static_cast<double>(result.differentPixels) / static_cast<double>(pixelCount) : 0.0;
+    result.matches = result.differentFraction <= tolerance.maxDifferentPixels;
+    return result;
+}
@@ -0,0 +1,45 @@
+#ifndef IMAGE_DIFF_H_10192026
+#define IMAGE_DIFF_H_10192026
+
+#include <cstddef>
+
+#include "texture2D.h"
+
+/*
+Compares two RGBA8 images the way a person would see the difference.
+Every pixel is blended over white by its alpha and converted to YIQ, the weighted distance between
+the two pixels (brightness counts most) is scaled to 0..1, black against white is close to 1.
+A pixel differs when its distance is above Tolerance::threshold, the images match when at most
+Tolerance::maxDifferentPixels of all pixels differ, which lets a few edge pixels rasterized differently
+by another driver pass while a wrong color anywhere still fails.
+Compare() can also fill a diff image, the expected image faded to grey with differing pixels in red.
+Images of different sizes never match.
+*/
+class ImageDiff
+{
+public:
+    struct Tolerance
+    {
+        float threshold{0.1f};              // per pixel distance, 0 exact
+        double maxDifferentPixels{0.001};   // fraction of all pixels
+    };
+
+    struct Result
+    {
+        std::size_t differentPixels{};
+        double differentFraction{};
+        float maxDistance{};
+        bool sizeMismatch{};
+        bool matches{};
+    };
+
+    static Result Compare(const Texture2D::ImageData& expected, const Texture2D::ImageData& actual,
+                          const Tolerance& tolerance, Texture2D::ImageData* diff = nullptr);
+
+    // 0..1 YIQ distance of two RGBA8 pixels
+    static float PixelDistance(const unsigned char* a, const unsigned char* b);
+
+    ImageDiff() = delete;
+};
+
+#endif // !IMAGE_DIFF_H_10192026
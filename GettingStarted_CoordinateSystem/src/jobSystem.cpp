@@ -0,0 +1,287 @@
+#include "jobSystem.h"
+#include <cassert>
+#include <iomanip>
+
+namespace
+{
+    // which JobSystem thread the calling thread is, set for thread 0 and the workers
+    thread_local const JobSystem* t_system{};
+    thread_local unsigned int t_thread{};
+
+    // failed attempts to find work before a worker goes to sleep
+    constexpr int SpinCount{64};
+}
+
+WorkStealingDeque::WorkStealingDeque(std::size_t capacity)
+    : m_top{}, m_bottom{}, m_buffer(capacity)
+{
+    assert(capacity > 0 && (capacity & (capacity - 1)) == 0);
+}
+
+bool WorkStealingDeque::Push(Job* job)
+{
+    auto bottom{m_bottom.load(std::memory_order_relaxed)};
+    auto top{m_top.load(std::memory_order_acquire)};
+    if(bottom - top >= static_cast<std::int64_t>(m_buffer.size())){
+        return false;
+    }
+    m_buffer[bottom & (m_buffer.size() - 1)].store(job, std::memory_order_relaxed);
+    // publishes the job to thieves reading m_bottom with acquire
+    m_bottom.store(bottom + 1, std::memory_order_release);
+    return true;
+}
+
+Job* WorkStealingDeque::Pop()
+{
+    auto bottom{m_bottom.load(std::memory_order_relaxed) - 1};
+    m_bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto top{m_top.load(std::memory_order_relaxed)};
+
+    if(top > bottom){
+        // empty
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    auto* job{m_buffer[bottom & (m_buffer.size() - 1)].load(std::memory_order_relaxed)};
+    if(top == bottom){
+        // last job, race the thieves for it
+        if(!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)){
+            job = nullptr;
+        }
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return job;
+}
+
+Job* WorkStealingDeque::Steal()
+{
+    auto top{m_top.load(std::memory_order_acquire)};
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto bottom{m_bottom.load(std::memory_order_acquire)};
+    if(top >= bottom){
+        return nullptr;
+    }
+
+    auto* job{m_buffer[top & (m_buffer.size() - 1)].load(std::memory_order_relaxed)};
+    if(!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)){
+        return nullptr;
+    }
+    return job;
+}
+
+JobSystem::JobSystem(unsigned int threadCount)
+    : m_stop{}, m_queued{}, m_sleeping{}, m_statsStart{std::chrono::steady_clock::now()}
+{
+    threadCount = std::max(threadCount, 1u);
+    for(unsigned int i{}; i < threadCount; ++i){
+        m_threads.push_back(std::make_unique<ThreadData>());
+    }
+
+    assert(t_system == nullptr && "one JobSystem per thread");
+    t_system = this;
+    t_thread = 0;
+
+    m_workers.reserve(threadCount - 1);
+    for(unsigned int i{1}; i < threadCount; ++i){
+        m_workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock{m_sleepMutex};
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for(auto& worker : m_workers){
+        worker.join();
+    }
+    t_system = nullptr;
+}
+
+void JobSystem::Run(std::function<void()> function, JobCounter* signal, JobCounter* dependency)
+{
+    auto thread{CurrentThread()};
+    auto* job{Allocate(thread)};
+    job->function = std::move(function);
+    job->signal = signal;
+    if(signal){
+        signal->m_count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if(dependency){
+        std::lock_guard<std::mutex> lock{dependency->m_mutex};
+        if(!dependency->IsDone()){
+            // pushed by whoever finishes the last job of the dependency
+            dependency->m_waiting.push_back(job);
+            return;
+        }
+    }
+    Push(thread, job);
+}
+
+void JobSystem::Wait(const JobCounter& counter)
+{
+    auto thread{CurrentThread()};
+    while(!counter.IsDone()){
+        if(!ExecuteOne(thread)){
+            std::this_thread::yield();
+        }
+    }
+    // the thread finishing the last job may still hold the lock
+    std::lock_guard<std::mutex> lock{counter.m_mutex};
+}
+
+JobSystem::ThreadStats JobSystem::GetThreadStats(unsigned int thread) const
+{
+    const auto& data{*m_threads[thread]};
+    return ThreadStats{data.executed.load(std::memory_order_relaxed), data.stolen.load(std::memory_order_relaxed),
+                       static_cast<double>(data.busyNanoseconds.load(std::memory_order_relaxed)) / 1.0e6};
+}
+
+void JobSystem::ResetStats()
+{
+    for(auto& data : m_threads){
+        data->executed = 0;
+        data->stolen = 0;
+        data->busyNanoseconds = 0;
+    }
+    m_statsStart = std::chrono::steady_clock::now();
+}
+
+void JobSystem::PrintUtilization(std::ostream& os) const
+{
+    constexpr int BarWidth{40};
+    auto flags{os.flags()};
+    auto precision{os.precision()};
+    auto elapsed{std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_statsStart).count()};
+    for(unsigned int thread{}; thread < GetThreadCount(); ++thread){
+        auto stats{GetThreadStats(thread)};
+        auto busy{elapsed > 0.0 ? std::min(stats.busyMilliseconds / elapsed, 1.0) : 0.0};
+        auto filled{static_cast<int>(busy * BarWidth + 0.5)};
+        os << "thread " << std::setw(2) << thread << " [" << std::string(filled, '#') << std::string(BarWidth - filled, '.')
+            << "] " << std::setw(5) << std::fixed << std::setprecision(1) << busy * 100.0 << "% "
+            << stats.jobs << " jobs, " << stats.stolen << " stolen\n";
+    }
+    os.flags(flags);
+    os.precision(precision);
+}
+
+void JobSystem::WorkerLoop(unsigned int index)
+{
+    t_system = this;
+    t_thread = index;
+
+    int idle{};
+    while(!m_stop.load(std::memory_order_relaxed)){
+        if(ExecuteOne(index)){
+            idle = 0;
+            continue;
+        }
+        if(++idle < SpinCount){
+            std::this_thread::yield();
+            continue;
+        }
+
+        // the timeout covers a job pushed between the check and the wait
+        std::unique_lock<std::mutex> lock{m_sleepMutex};
+        ++m_sleeping;
+        m_wake.wait_for(lock, std::chrono::milliseconds{1}, [this](){
+            return m_stop.load(std::memory_order_relaxed) || m_queued.load(std::memory_order_relaxed) > 0;
+        });
+        --m_sleeping;
+        idle = 0;
+    }
+}
+
+unsigned int JobSystem::CurrentThread() const
+{
+    assert(t_system == this && "jobs can only be started from the JobSystem's own threads");
+    return t_thread;
+}
+
+Job* JobSystem::Allocate(unsigned int thread)
+{
+    auto& data{*m_threads[thread]};
+    auto* job{&data.jobs[data.nextJob++ & (data.jobs.size() - 1)]};
+    // the slot comes around again while its job is still queued or running, help until it is done
+    while(!job->finished.load(std::memory_order_acquire)){
+        if(!ExecuteOne(thread)){
+            std::this_thread::yield();
+        }
+    }
+    job->finished.store(false, std::memory_order_relaxed);
+    return job;
+}
+
+void JobSystem::Push(unsigned int thread, Job* job)
+{
+    if(!m_threads[thread]->deque.Push(job)){
+        // full, no one else would get to it sooner than this thread
+        Execute(thread, job);
+        return;
+    }
+    m_queued.fetch_add(1, std::memory_order_relaxed);
+    if(m_sleeping.load(std::memory_order_relaxed) > 0){
+        m_wake.notify_one();
+    }
+}
+
+bool JobSystem::ExecuteOne(unsigned int thread)
+{
+    auto& data{*m_threads[thread]};
+    auto* job{data.deque.Pop()};
+    if(!job){
+        // try every other thread once, starting where the last steal succeeded
+        auto count{static_cast<std::uint32_t>(m_threads.size())};
+        for(std::uint32_t attempt{}; attempt < count && !job; ++attempt){
+            auto victim{(data.victim + attempt) % count};
+            if(victim == thread){
+                continue;
+            }
+            job = m_threads[victim]->deque.Steal();
+            if(job){
+                data.victim = victim;
+                data.stolen.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        if(!job){
+            return false;
+        }
+    }
+    m_queued.fetch_sub(1, std::memory_order_relaxed);
+    Execute(thread, job);
+    return true;
+}
+
+void JobSystem::Execute(unsigned int thread, Job* job)
+{
+    auto& data{*m_threads[thread]};
+    auto start{std::chrono::steady_clock::now()};
+    job->function();
+    auto nanoseconds{std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()};
+    data.busyNanoseconds.fetch_add(static_cast<std::uint64_t>(nanoseconds), std::memory_order_relaxed);
+    data.executed.fetch_add(1, std::memory_order_relaxed);
+
+    auto* signal{job->signal};
+    job->function = nullptr;
+    job->finished.store(true, std::memory_order_release);
+
+    if(signal){
+        // decrement under the lock, Wait() takes it too before the counter may go out of scope
+        std::vector<Job*> waiting;
+        {
+            std::lock_guard<std::mutex> lock{signal->m_mutex};
+            if(signal->m_count.fetch_sub(1, std::memory_order_acq_rel) == 1){
+                waiting.swap(signal->m_waiting);
+            }
+        }
+        // last job of the counter, start everything that waited for it
+        for(auto* next : waiting){
+            Push(thread, next);
+        }
+    }
+}
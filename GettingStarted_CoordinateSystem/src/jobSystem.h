@@ -0,0 +1,176 @@
+#ifndef JOB_SYSTEM_H_10192026
+#define JOB_SYSTEM_H_10192026
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+class JobSystem;
+struct Job;
+
+/*
+Counts unfinished jobs. Run() increments it for every job that signals it, the job decrements it when
+it finished. Jobs started with a counter as dependency are held back until it reaches zero.
+Wait() for a counter before it goes out of scope.
+*/
+class JobCounter
+{
+public:
+    JobCounter() = default;
+
+    inline bool IsDone() const { return m_count.load(std::memory_order_acquire) == 0; }
+
+    JobCounter(const JobCounter&) = delete;
+    JobCounter(JobCounter&&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+    JobCounter& operator=(JobCounter&&) = delete;
+
+private:
+    friend class JobSystem;
+
+    std::atomic<int> m_count{};
+    mutable std::mutex m_mutex;
+    std::vector<Job*> m_waiting;   // jobs depending on this counter
+};
+
+struct Job
+{
+    std::function<void()> function;
+    JobCounter* signal{};
+    std::atomic<bool> finished{true};
+};
+
+/*
+Chase-Lev work stealing deque of a fixed capacity, memory orders after Le, Pop, Cohen, Nardelli 2013.
+Only the owning thread calls Push() and Pop() at the bottom, any thread may Steal() from the top.
+*/
+class WorkStealingDeque
+{
+public:
+    explicit WorkStealingDeque(std::size_t capacity);
+
+    // false when the deque is full
+    bool Push(Job* job);
+    Job* Pop();
+    Job* Steal();
+
+    inline std::size_t Capacity() const { return m_buffer.size(); }
+
+private:
+    alignas(64) std::atomic<std::int64_t> m_top;
+    alignas(64) std::atomic<std::int64_t> m_bottom;
+    std::vector<std::atomic<Job*>> m_buffer;
+};
+
+/*
+Fiber free work stealing job system.
+Every thread has its own deque, jobs are pushed to and popped from the deque of the thread that started
+them, idle threads steal the oldest job of another thread. The thread constructing the JobSystem is
+thread 0 and only runs jobs while it waits, the others are workers that sleep when there is nothing
+to take. Run() may be called from thread 0 and from inside jobs.
+Wait() executes other jobs until a counter reaches zero, so nested waits inside jobs don't dead lock.
+ParallelFor() splits an index range into chunks of at least grainSize and waits for all of them.
+Each thread counts executed and stolen jobs and the time spent inside jobs,
+PrintUtilization() shows the busy share of every thread since the last ResetStats().
+*/
+class JobSystem
+{
+public:
+    struct ThreadStats
+    {
+        std::uint64_t jobs;
+        std::uint64_t stolen;
+        double busyMilliseconds;
+    };
+
+    explicit JobSystem(unsigned int threadCount = std::thread::hardware_concurrency());
+    ~JobSystem();
+
+    void Run(std::function<void()> function, JobCounter* signal = nullptr, JobCounter* dependency = nullptr);
+    void Wait(const JobCounter& counter);
+
+    // body(begin, end) is called for consecutive chunks of [first, last)
+    template<typename Body>
+    void ParallelFor(std::size_t first, std::size_t last, std::size_t grainSize, Body&& body);
+
+    inline unsigned int GetThreadCount() const { return static_cast<unsigned int>(m_threads.size()); }
+    ThreadStats GetThreadStats(unsigned int thread) const;
+    void ResetStats();
+    void PrintUtilization(std::ostream& os) const;
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem(JobSystem&&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+    JobSystem& operator=(JobSystem&&) = delete;
+
+private:
+    static constexpr std::size_t JobsPerThread{4096};
+
+    struct alignas(64) ThreadData
+    {
+        ThreadData() : deque{JobsPerThread}, jobs(JobsPerThread) {}
+
+        WorkStealingDeque deque;
+        std::vector<Job> jobs;      // ring of job slots, reused once their job finished
+        std::size_t nextJob{};
+        std::uint32_t victim{};     // where stealing starts next time
+        std::atomic<std::uint64_t> executed{};
+        std::atomic<std::uint64_t> stolen{};
+        std::atomic<std::uint64_t> busyNanoseconds{};
+    };
+
+    void WorkerLoop(unsigned int index);
+    unsigned int CurrentThread() const;
+    Job* Allocate(unsigned int thread);
+    void Push(unsigned int thread, Job* job);
+    // runs one job from the own deque or a stolen one, false when there was none
+    bool ExecuteOne(unsigned int thread);
+    void Execute(unsigned int thread, Job* job);
+
+    std::vector<std::unique_ptr<ThreadData>> m_threads;
+    std::vector<std::thread> m_workers;
+
+    std::atomic<bool> m_stop;
+    std::atomic<std::int64_t> m_queued;     // jobs in any deque, lets sleeping workers know when to wake
+    std::atomic<int> m_sleeping;
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wake;
+
+    std::chrono::steady_clock::time_point m_statsStart;
+};
+
+template<typename Body>
+inline void JobSystem::ParallelFor(std::size_t first, std::size_t last, std::size_t grainSize, Body&& body)
+{
+    if(first >= last){
+        return;
+    }
+    grainSize = grainSize ? grainSize : 1;
+    auto count{last - first};
+    // a few chunks per thread so stealing can even out uneven chunks
+    auto chunks{std::min((count + grainSize - 1) / grainSize, std::size_t{GetThreadCount()} * 4)};
+    if(chunks <= 1){
+        body(first, last);
+        return;
+    }
+
+    JobCounter counter;
+    for(std::size_t chunk{1}; chunk < chunks; ++chunk){
+        auto begin{first + count * chunk / chunks};
+        auto end{first + count * (chunk + 1) / chunks};
+        Run([&body, begin, end](){ body(begin, end); }, &counter);
+    }
+    body(first, first + count / chunks);
+    Wait(counter);
+}
+
+#endif // !JOB_SYSTEM_H_10192026
@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "frustumCuller.h"
+#include "jobSystem.h"
+
+// settings
+constexpr std::size_t OBJECT_COUNT{2'000'000};
+constexpr std::size_t GRAIN_SIZE{4096};
+constexpr int ITERATIONS{10};
+constexpr unsigned int SCR_WIDTH{800};
+constexpr unsigned int SCR_HEIGHT{600};
+
+/*
+Scaling of the job system on 1, 2, 4, 8 and 16 threads with two engine style workloads:
+building OBJECT_COUNT model matrices with ParallelFor, and frustum culling them in chunk jobs whose
+visible counts are summed by a job depending on the chunk counter.
+Thread counts above the number of cores are still run, they show the cost of oversubscription.
+*/
+int main()
+{
+    std::mt19937 rng{5};
+    std::uniform_real_distribution<float> position{-200.0f, 200.0f};
+    std::uniform_real_distribution<float> angle{0.0f, 6.28f};
+
+    std::vector<glm::vec3> positions;
+    std::vector<float> angles;
+    FrustumCuller culler{OBJECT_COUNT};
+    for(std::size_t i{}; i < OBJECT_COUNT; ++i){
+        positions.emplace_back(position(rng), position(rng), position(rng));
+        angles.push_back(angle(rng));
+        culler.Add(positions.back(), glm::vec3{0.5f});
+    }
+    std::vector<glm::mat4> models(OBJECT_COUNT);
+
+    auto projection{glm::perspective(glm::radians(45.0f), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f)};
+    auto view{glm::lookAt(glm::vec3{0.0f, 0.0f, 3.0f}, glm::vec3{10.0f, 2.0f, -20.0f}, glm::vec3{0.0f, 1.0f, 0.0f})};
+    auto planes{FrustumCuller::ExtractPlanes(projection * view)};
+    auto reference{culler.Cull(projection * view).size()};
+
+    std::cout << std::thread::hardware_concurrency() << " hardware threads\n";
+
+    using clock = std::chrono::steady_clock;
+    double modelBaseline{}, cullBaseline{};
+    for(unsigned int threads : {1u, 2u, 4u, 8u, 16u}){
+        JobSystem jobs{threads};
+
+        auto modelTime{std::chrono::duration<double, std::milli>::max()};
+        auto cullTime{std::chrono::duration<double, std::milli>::max()};
+        std::size_t visibleCount{};
+        jobs.ResetStats();
+        for(int iteration{}; iteration < ITERATIONS; ++iteration){
+            auto start{clock::now()};
+            jobs.ParallelFor(0, OBJECT_COUNT, GRAIN_SIZE, [&](std::size_t first, std::size_t last){
+                for(auto i{first}; i < last; ++i){
+                    auto model{glm::translate(glm::mat4{1.0f}, positions[i])};
+                    models[i] = glm::rotate(model, angles[i], glm::vec3(1.0f, 0.3f, 0.5f));
+                }
+            });
+            modelTime = std::min<std::chrono::duration<double, std::milli>>(modelTime, clock::now() - start);
+
+            start = clock::now();
+            // chunks start on the culler's batch boundaries
+            constexpr std::size_t chunkSize{GRAIN_SIZE / FrustumCuller::BatchWidth * FrustumCuller::BatchWidth};
+            auto chunkCount{(OBJECT_COUNT + chunkSize - 1) / chunkSize};
+            std::vector<std::vector<std::uint32_t>> visible(chunkCount);
+            JobCounter culled;
+            for(std::size_t chunk{}; chunk < chunkCount; ++chunk){
+                jobs.Run([&, chunk](){
+                    culler.CullRange(planes, chunk * chunkSize, std::min((chunk + 1) * chunkSize, OBJECT_COUNT), visible[chunk]);
+                }, &culled);
+            }
+            JobCounter summed;
+            jobs.Run([&](){
+                visibleCount = 0;
+                for(const auto& list : visible){
+                    visibleCount += list.size();
+                }
+            }, &summed, &culled);
+            jobs.Wait(summed);
+            jobs.Wait(culled);
+            cullTime = std::min<std::chrono::duration<double, std::milli>>(cullTime, clock::now() - start);
+        }
+
+        if(threads == 1){
+            modelBaseline = modelTime.count();
+            cullBaseline = cullTime.count();
+        }
+        std::cout << threads << " threads: models " << modelTime.count() << " ms (" << modelBaseline / modelTime.count()
+            << "x), cull " << cullTime.count() << " ms (" << cullBaseline / cullTime.count() << "x), visible "
+            << visibleCount << (visibleCount == reference ? "" : " MISMATCH") << "\n";
+        jobs.PrintUtilization(std::cout);
+    }
+
+    return 0;
+}
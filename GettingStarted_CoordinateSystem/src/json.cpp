@@ -0,0 +1,328 @@
+#include "json.h"
+#include <charconv>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    const JsonValue& Null()
+    {
+        static const JsonValue null;
+        return null;
+    }
+
+    void AppendUtf8(std::string& out, unsigned int codePoint)
+    {
+        if(codePoint < 0x80){
+            out += static_cast<char>(codePoint);
+        }
+        else if(codePoint < 0x800){
+            out += static_cast<char>(0xc0 | (codePoint >> 6));
+            out += static_cast<char>(0x80 | (codePoint & 0x3f));
+        }
+        else if(codePoint < 0x10000){
+            out += static_cast<char>(0xe0 | (codePoint >> 12));
+            out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f));
+            out += static_cast<char>(0x80 | (codePoint & 0x3f));
+        }
+        else{
+            out += static_cast<char>(0xf0 | (codePoint >> 18));
+            out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3f));
+            out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f));
+            out += static_cast<char>(0x80 | (codePoint & 0x3f));
+        }
+    }
+}
+
+// recursive descent over the text, nesting is limited so hostile files can't exhaust the stack
+class JsonParser
+{
+public:
+    explicit JsonParser(std::string_view text)
+        : m_text{text}, m_position{}
+    {}
+
+    bool ParseDocument(JsonValue& document, std::string& error)
+    {
+        SkipWhitespace();
+        if(!ParseValue(document, 0)){
+            error = m_error + " at offset " + std::to_string(m_position);
+            return false;
+        }
+        SkipWhitespace();
+        if(m_position != m_text.size()){
+            error = "trailing characters at offset " + std::to_string(m_position);
+            return false;
+        }
+        return true;
+    }
+
+private:
+    static constexpr int MaxDepth{128};
+
+    bool Fail(const char* message)
+    {
+        m_error = message;
+        return false;
+    }
+
+    void SkipWhitespace()
+    {
+        while(m_position < m_text.size() &&
+              (m_text[m_position] == ' ' || m_text[m_position] == '\t' || m_text[m_position] == '\n' || m_text[m_position] == '\r')){
+            ++m_position;
+        }
+    }
+
+    bool Consume(std::string_view literal)
+    {
+        if(m_text.substr(m_position, literal.size()) != literal){
+            return false;
+        }
+        m_position += literal.size();
+        return true;
+    }
+
+    bool ParseValue(JsonValue& value, int depth)
+    {
+        if(depth > MaxDepth){
+            return Fail("nested too deeply");
+        }
+        if(m_position >= m_text.size()){
+            return Fail("unexpected end");
+        }
+        switch(m_text[m_position]){
+            case '{':
+                return ParseObject(value, depth);
+            case '[':
+                return ParseArray(value, depth);
+            case '"':
+                value.m_type = JsonValue::Type::String;
+                return ParseString(value.m_string);
+            case 't':
+                value.m_type = JsonValue::Type::Bool;
+                value.m_bool = true;
+                return Consume("true") || Fail("invalid literal");
+            case 'f':
+                value.m_type = JsonValue::Type::Bool;
+                value.m_bool = false;
+                return Consume("false") || Fail("invalid literal");
+            case 'n':
+                value.m_type = JsonValue::Type::Null;
+                return Consume("null") || Fail("invalid literal");
+            default:
+                return ParseNumber(value);
+        }
+    }
+
+    bool ParseObject(JsonValue& value, int depth)
+    {
+        value.m_type = JsonValue::Type::Object;
+        ++m_position;
+        SkipWhitespace();
+        if(Consume("}")){
+            return true;
+        }
+        while(true){
+            SkipWhitespace();
+            if(m_position >= m_text.size() || m_text[m_position] != '"'){
+                return Fail("expected a member name");
+            }
+            auto& member{value.m_members.emplace_back()};
+            if(!ParseString(member.first)){
+                return false;
+            }
+            SkipWhitespace();
+            if(!Consume(":")){
+                return Fail("expected ':'");
+            }
+            SkipWhitespace();
+            if(!ParseValue(member.second, depth + 1)){
+                return false;
+            }
+            SkipWhitespace();
+            if(Consume("}")){
+                return true;
+            }
+            if(!Consume(",")){
+                return Fail("expected ',' or '}'");
+            }
+        }
+    }
+
+    bool ParseArray(JsonValue& value, int depth)
+    {
+        value.m_type = JsonValue::Type::Array;
+        ++m_position;
+        SkipWhitespace();
+        if(Consume("]")){
+            return true;
+        }
+        while(true){
+            SkipWhitespace();
+            if(!ParseValue(value.m_elements.emplace_back(), depth + 1)){
+                return false;
+            }
+            SkipWhitespace();
+            if(Consume("]")){
+                return true;
+            }
+            if(!Consume(",")){
+                return Fail("expected ',' or ']'");
+            }
+        }
+    }
+
+    bool ParseHex4(unsigned int& value)
+    {
+        if(m_position + 4 > m_text.size()){
+            return Fail("truncated escape");
+        }
+        auto [next, error] = std::from_chars(m_text.data() + m_position, m_text.data() + m_position + 4, value, 16);
+        if(error != std::errc{} || next != m_text.data() + m_position + 4){
+            return Fail("invalid \\u escape");
+        }
+        m_position += 4;
+        return true;
+    }
+
+    bool ParseString(std::string& out)
+    {
+        ++m_position;
+        while(m_position < m_text.size()){
+            // copy runs without escapes at once, base64 buffers are megabytes of them
+            auto run{m_position};
+            while(run < m_text.size() && m_text[run] != '"' && m_text[run] != '\\' && static_cast<unsigned char>(m_text[run]) >= 0x20){
+                ++run;
+            }
+            out.append(m_text.substr(m_position, run - m_position));
+            m_position = run;
+            if(m_position == m_text.size()){
+                break;
+            }
+            auto c{m_text[m_position++]};
+            if(c == '"'){
+                return true;
+            }
+            if(static_cast<unsigned char>(c) < 0x20){
+                return Fail("control character in string");
+            }
+            if(m_position >= m_text.size()){
+                break;
+            }
+            switch(m_text[m_position++]){
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/': out += '/'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u':
+                {
+                    unsigned int codePoint{};
+                    if(!ParseHex4(codePoint)){
+                        return false;
+                    }
+                    // a high surrogate has to be followed by its low half
+                    if(codePoint >= 0xd800 && codePoint < 0xdc00){
+                        unsigned int low{};
+                        if(!Consume("\\u") || !ParseHex4(low) || low < 0xdc00 || low >= 0xe000){
+                            return Fail("unpaired surrogate");
+                        }
+                        codePoint = 0x10000 + ((codePoint - 0xd800) << 10) + (low - 0xdc00);
+                    }
+                    AppendUtf8(out, codePoint);
+                }
+                break;
+                default:
+                    return Fail("invalid escape");
+            }
+        }
+        return Fail("unterminated string");
+    }
+
+    bool ParseNumber(JsonValue& value)
+    {
+        value.m_type = JsonValue::Type::Number;
+        const auto* first{m_text.data() + m_position};
+        const auto* last{m_text.data() + m_text.size()};
+        // from_chars would also take inf and nan, JSON numbers start with '-' or a digit
+        if(*first != '-' && (*first < '0' || *first > '9')){
+            return Fail("invalid value");
+        }
+        auto [next, error] = std::from_chars(first, last, value.m_number);
+        if(error != std::errc{} || next == first){
+            return Fail("invalid value");
+        }
+        m_position += static_cast<std::size_t>(next - first);
+        return true;
+    }
+
+    std::string_view m_text;
+    std::size_t m_position;
+    std::string m_error;
+};
+
+bool JsonValue::Parse(std::string_view text, JsonValue& document, std::string& error)
+{
+    document = JsonValue{};
+    JsonParser parser{text};
+    return parser.ParseDocument(document, error);
+}
+
+bool JsonValue::AsBool(bool fallback) const
+{
+    return m_type == Type::Bool ? m_bool : fallback;
+}
+
+double JsonValue::AsNumber(double fallback) const
+{
+    return m_type == Type::Number ? m_number : fallback;
+}
+
+int JsonValue::AsInt(int fallback) const
+{
+    if(m_type != Type::Number || !std::isfinite(m_number) ||
+       m_number < std::numeric_limits<int>::min() || m_number > std::numeric_limits<int>::max()){
+        return fallback;
+    }
+    return static_cast<int>(m_number);
+}
+
+const std::string& JsonValue::AsString() const
+{
+    static const std::string empty;
+    return m_type == Type::String ? m_string : empty;
+}
+
+std::size_t JsonValue::Size() const
+{
+    return m_type == Type::Array ? m_elements.size() : m_type == Type::Object ? m_members.size() : 0;
+}
+
+const JsonValue& JsonValue::operator[](std::size_t index) const
+{
+    return m_type == Type::Array && index < m_elements.size() ? m_elements[index] : Null();
+}
+
+const JsonValue& JsonValue::operator[](std::string_view key) const
+{
+    for(const auto& [name, value] : m_members){
+        if(name == key){
+            return value;
+        }
+    }
+    return Null();
+}
+
+bool JsonValue::Has(std::string_view key) const
+{
+    for(const auto& member : m_members){
+        if(member.first == key){
+            return true;
+        }
+    }
+    return false;
+}
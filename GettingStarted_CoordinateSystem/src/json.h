@@ -0,0 +1,65 @@
+#ifndef JSON_H_10192026
+#define JSON_H_10192026
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/*
+Small read only JSON document, enough for glTF.
+Parse() builds the whole tree, lookups of missing members or out of range elements return a shared
+null value, so chains like json["a"][0]["b"].AsNumber(1.0) never fail and fall back to the default.
+Object members keep their file order, lookup is linear, which is fast for the handful of keys
+glTF objects have.
+*/
+class JsonValue
+{
+public:
+    enum class Type
+    {
+        Null,
+        Bool,
+        Number,
+        String,
+        Array,
+        Object
+    };
+
+    JsonValue() = default;
+
+    // returns false and describes the first error in error when the text isn't valid JSON
+    static bool Parse(std::string_view text, JsonValue& document, std::string& error);
+
+    inline Type GetType() const { return m_type; }
+    inline bool IsNull() const { return m_type == Type::Null; }
+    inline bool IsNumber() const { return m_type == Type::Number; }
+    inline bool IsString() const { return m_type == Type::String; }
+    inline bool IsArray() const { return m_type == Type::Array; }
+    inline bool IsObject() const { return m_type == Type::Object; }
+
+    bool AsBool(bool fallback = false) const;
+    double AsNumber(double fallback = 0.0) const;
+    int AsInt(int fallback = 0) const;
+    const std::string& AsString() const;
+
+    // elements of an array or members of an object, 0 for anything else
+    std::size_t Size() const;
+    const JsonValue& operator[](std::size_t index) const;
+    const JsonValue& operator[](std::string_view key) const;
+    bool Has(std::string_view key) const;
+    inline const std::vector<std::pair<std::string, JsonValue>>& GetMembers() const { return m_members; }
+
+private:
+    friend class JsonParser;
+
+    Type m_type{Type::Null};
+    bool m_bool{};
+    double m_number{};
+    std::string m_string;
+    std::vector<JsonValue> m_elements;
+    std::vector<std::pair<std::string, JsonValue>> m_members;
+};
+
+#endif // !JSON_H_10192026
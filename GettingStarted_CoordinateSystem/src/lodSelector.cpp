@@ -0,0 +1,37 @@
+#include "lodSelector.h"
+#include <limits>
+
+LodSelector::LodSelector(const glm::mat4& projection, float viewportHeight, float maxPixelError)
+    : m_pixelsPerUnit{}, m_perspective{}, m_maxPixelError{maxPixelError}
+{
+    SetProjection(projection, viewportHeight);
+}
+
+void LodSelector::SetProjection(const glm::mat4& projection, float viewportHeight)
+{
+    m_pixelsPerUnit = projection[1][1] * viewportHeight * 0.5f;
+    // a perspective projection puts -z into w
+    m_perspective = projection[2][3] != 0.0f;
+}
+
+float LodSelector::ProjectedRadius(float radius, float viewDepth) const
+{
+    if(!m_perspective){
+        return radius * m_pixelsPerUnit;
+    }
+    // the camera inside the sphere sees it at full detail
+    return viewDepth > radius ? radius * m_pixelsPerUnit / viewDepth : std::numeric_limits<float>::max();
+}
+
+std::size_t LodSelector::Select(std::span<const MeshLod> lods, float radius, float viewDepth) const
+{
+    auto projectedRadius{ProjectedRadius(radius, viewDepth)};
+    std::size_t selected{};
+    for(std::size_t i{1}; i < lods.size(); ++i){
+        if(lods[i].error * projectedRadius > m_maxPixelError){
+            break;
+        }
+        selected = i;
+    }
+    return selected;
+}
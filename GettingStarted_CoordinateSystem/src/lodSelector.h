@@ -0,0 +1,39 @@
+#ifndef LOD_SELECTOR_H_10192026
+#define LOD_SELECTOR_H_10192026
+
+#include <cstddef>
+#include <span>
+
+#include <glm/glm.hpp>
+
+#include "meshFile.h"
+
+/*
+Picks a level of detail per object from how large its simplification error would look on screen.
+A sphere of radius r at view depth d covers r * projection[1][1] / d * viewportHeight / 2 pixels with a
+perspective projection and r * projection[1][1] * viewportHeight / 2 with an orthographic one.
+LOD errors are relative to the mesh radius (MeshOptimizer::GenerateLods), so a LOD's error in pixels
+is its error times the projected radius. Select() returns the coarsest LOD staying under
+maxPixelError, LODs are expected coarsest last like MeshFile stores them.
+Select() only reads the selector and can be called from several jobs at once.
+*/
+class LodSelector
+{
+public:
+    LodSelector(const glm::mat4& projection, float viewportHeight, float maxPixelError = 1.0f);
+
+    void SetProjection(const glm::mat4& projection, float viewportHeight);
+    inline void SetMaxPixelError(float maxPixelError) { m_maxPixelError = maxPixelError; }
+    inline float GetMaxPixelError() const { return m_maxPixelError; }
+
+    // pixels covered by radius at viewDepth in front of the camera
+    float ProjectedRadius(float radius, float viewDepth) const;
+    std::size_t Select(std::span<const MeshLod> lods, float radius, float viewDepth) const;
+
+private:
+    float m_pixelsPerUnit;     // projected pixels of one unit at depth 1, or at any depth when orthographic
+    bool m_perspective;
+    float m_maxPixelError;
+};
+
+#endif // !LOD_SELECTOR_H_10192026
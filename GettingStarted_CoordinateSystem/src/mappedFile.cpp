@@ -0,0 +1,89 @@
+#include "mappedFile.h"
+#include <iostream>
+#include <string>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+MappedFile::MappedFile(std::string_view path)
+    : m_data{}, m_size{}, m_file{INVALID_HANDLE_VALUE}, m_mapping{}
+{
+    std::string name{path};
+    m_file = CreateFileA(name.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                         FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    LARGE_INTEGER size{};
+    if(m_file == INVALID_HANDLE_VALUE || !GetFileSizeEx(m_file, &size)){
+        std::cerr << "Error: could not open " << path << std::endl;
+        return;
+    }
+    m_size = static_cast<std::size_t>(size.QuadPart);
+    if(m_size == 0){
+        return;
+    }
+    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if(m_mapping != nullptr){
+        m_data = static_cast<const std::byte*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    }
+    if(m_data == nullptr){
+        std::cerr << "Error: could not map " << path << std::endl;
+        m_size = 0;
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    if(m_data != nullptr){
+        UnmapViewOfFile(m_data);
+    }
+    if(m_mapping != nullptr){
+        CloseHandle(m_mapping);
+    }
+    if(m_file != INVALID_HANDLE_VALUE){
+        CloseHandle(m_file);
+    }
+}
+#else
+MappedFile::MappedFile(std::string_view path)
+    : m_data{}, m_size{}
+{
+    std::string name{path};
+    auto file{open(name.c_str(), O_RDONLY)};
+    struct stat status{};
+    if(file < 0 || fstat(file, &status) != 0){
+        std::cerr << "Error: could not open " << path << std::endl;
+        if(file >= 0){
+            close(file);
+        }
+        return;
+    }
+    m_size = static_cast<std::size_t>(status.st_size);
+    if(m_size != 0){
+        auto* data{mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0)};
+        if(data == MAP_FAILED){
+            std::cerr << "Error: could not map " << path << std::endl;
+            m_size = 0;
+        }
+        else{
+            m_data = static_cast<const std::byte*>(data);
+        }
+    }
+    // the mapping keeps its own reference to the file
+    close(file);
+}
+
+MappedFile::~MappedFile()
+{
+    if(m_data != nullptr){
+        munmap(const_cast<std::byte*>(m_data), m_size);
+    }
+}
+#endif
@@ -0,0 +1,38 @@
+#ifndef MAPPED_FILE_H_10192026
+#define MAPPED_FILE_H_10192026
+
+#include <cstddef>
+#include <string_view>
+
+/*
+Read only memory mapping of a whole file, the pages are loaded by the OS on first access
+instead of being copied through a read buffer.
+Data() is page aligned and stays valid until the MappedFile is destroyed.
+Uses CreateFileMapping/MapViewOfFile on Windows and mmap everywhere else.
+*/
+class MappedFile
+{
+public:
+    explicit MappedFile(std::string_view path);
+    ~MappedFile();
+
+    inline bool IsOpen() const { return m_data != nullptr; }
+    inline const std::byte* Data() const { return m_data; }
+    inline std::size_t Size() const { return m_size; }
+
+    MappedFile() = delete;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile(MappedFile&&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile& operator=(MappedFile&&) = delete;
+
+private:
+    const std::byte* m_data;
+    std::size_t m_size;
+#ifdef _WIN32
+    void* m_file;
+    void* m_mapping;
+#endif
+};
+
+#endif // !MAPPED_FILE_H_10192026
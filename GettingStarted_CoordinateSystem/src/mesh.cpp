@@ -0,0 +1,121 @@
+#include "mesh.h"
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+#include "glStateCache.h"
+
+namespace
+{
+    // streams start on 16 bytes so every attribute type is aligned
+    constexpr std::size_t StreamAlignment{16};
+}
+
+Mesh::Mesh(VertexArrayCache& vertexArrays, const VertexLayoutDescriptor& layout, const void* vertices, std::size_t vertexCount,
+           VertexStorage storage, const void* indices, std::size_t indexCount, GLenum indexType)
+    : m_vertexArray{vertexArrays.Get(layout, storage)}, m_storage{storage},
+    m_vertexBuffer{}, m_indexBuffer{},
+    m_vertexCount{vertexCount}, m_indexCount{indices != nullptr ? indexCount : 0}, m_indexType{indexType},
+    m_vertexBytes{}, m_indexBytes{}
+{
+    assert(vertices != nullptr && vertexCount > 0);
+    const auto* source{static_cast<const std::uint8_t*>(vertices)};
+
+    if(storage == VertexStorage::Interleaved){
+        m_vertexBytes = vertexCount * layout.stride;
+        m_vertexBuffer = CreateBuffer(source, m_vertexBytes);
+        m_streams.push_back({0, static_cast<GLsizei>(layout.stride)});
+    }
+    else{
+        // split the interleaved input, stream i holds attribute i of every vertex back to back
+        for(const auto& attribute : layout.attributes){
+            m_vertexBytes = (m_vertexBytes + StreamAlignment - 1) / StreamAlignment * StreamAlignment;
+            m_streams.push_back({static_cast<GLintptr>(m_vertexBytes), static_cast<GLsizei>(attribute.size)});
+            m_vertexBytes += vertexCount * attribute.size;
+        }
+        std::vector<std::uint8_t> streams(m_vertexBytes);
+        for(std::size_t i{}; i < layout.attributes.size(); ++i){
+            const auto& attribute{layout.attributes[i]};
+            auto* destination{streams.data() + m_streams[i].offset};
+            for(std::size_t vertex{}; vertex < vertexCount; ++vertex){
+                std::memcpy(destination + vertex * attribute.size, source + vertex * layout.stride + attribute.offset, attribute.size);
+            }
+        }
+        m_vertexBuffer = CreateBuffer(streams.data(), m_vertexBytes);
+    }
+
+    if(m_indexCount != 0){
+        m_indexBytes = m_indexCount * IndexSize(indexType);
+        m_indexBuffer = CreateBuffer(indices, m_indexBytes);
+    }
+}
+
+Mesh::~Mesh()
+{
+    // a new mesh at this address must not look attached
+    if(m_vertexArray.attached == this){
+        m_vertexArray.attached = nullptr;
+    }
+    auto& stateCache{GLStateCache::Current()};
+    stateCache.DeleteBuffer(m_vertexBuffer);
+    if(m_indexBuffer != 0){
+        stateCache.DeleteBuffer(m_indexBuffer);
+    }
+}
+
+void Mesh::Bind() const
+{
+    auto& stateCache{GLStateCache::Current()};
+    stateCache.BindVertexArray(m_vertexArray.name);
+    if(m_vertexArray.attached == this){
+        return;
+    }
+
+    for(std::size_t i{}; i < m_streams.size(); ++i){
+        glBindVertexBuffer(static_cast<unsigned int>(i), m_vertexBuffer, m_streams[i].offset, m_streams[i].stride);
+    }
+    // part of the vertex array state, bind it even when 0 so the previous mesh's indices don't stick
+    stateCache.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+    m_vertexArray.attached = this;
+}
+
+void Mesh::Draw(GLenum mode) const
+{
+    Bind();
+    if(m_indexCount != 0){
+        glDrawElements(mode, static_cast<GLsizei>(m_indexCount), m_indexType, nullptr);
+    }
+    else{
+        glDrawArrays(mode, 0, static_cast<GLsizei>(m_vertexCount));
+    }
+}
+
+unsigned int Mesh::CreateBuffer(const void* data, std::size_t size)
+{
+    // uploaded through the copy write target, binding GL_ELEMENT_ARRAY_BUFFER here would change
+    // whatever vertex array happens to be bound
+    unsigned int buffer{};
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    if(glBufferStorage != nullptr){
+        glBufferStorage(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(size), data, 0);
+    }
+    else{
+        glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(size), data, GL_STATIC_DRAW);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    return buffer;
+}
+
+std::size_t Mesh::IndexSize(GLenum indexType)
+{
+    switch(indexType){
+        case GL_UNSIGNED_BYTE:
+            return 1;
+        case GL_UNSIGNED_SHORT:
+            return 2;
+        default:
+            assert(indexType == GL_UNSIGNED_INT);
+            return 4;
+    }
+}
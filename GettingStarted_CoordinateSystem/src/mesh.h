@@ -0,0 +1,84 @@
+#ifndef MESH_H_10192026
+#define MESH_H_10192026
+
+#include <cstddef>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "vertexArrayCache.h"
+#include "vertexLayout.h"
+
+/*
+Vertex and optional index data of a drawable in immutable buffers.
+vertices are always given interleaved in the layout's format, with VertexStorage::Deinterleaved
+they are split into one tightly packed stream per attribute in the same buffer, which lets passes
+that only need positions (depth, shadows) fetch a fraction of the bytes.
+The vertex array comes from a VertexArrayCache, meshes with the same layout and storage share it and
+Bind() only attaches this mesh's buffers with glBindVertexBuffer.
+Buffers are created with glBufferStorage (GL 4.4 / ARB_buffer_storage) when the context has it,
+glBufferData otherwise. indexType is GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT or GL_UNSIGNED_INT.
+*/
+class Mesh
+{
+public:
+    template<typename Layout>
+    Mesh(VertexArrayCache& vertexArrays, Layout, const void* vertices, std::size_t vertexCount,
+         VertexStorage storage = VertexStorage::Interleaved,
+         const void* indices = nullptr, std::size_t indexCount = 0, GLenum indexType = GL_UNSIGNED_INT);
+    Mesh(VertexArrayCache& vertexArrays, const VertexLayoutDescriptor& layout, const void* vertices, std::size_t vertexCount,
+         VertexStorage storage = VertexStorage::Interleaved,
+         const void* indices = nullptr, std::size_t indexCount = 0, GLenum indexType = GL_UNSIGNED_INT);
+    ~Mesh();
+
+    void Bind() const;
+    // draws every vertex, or every index of an indexed mesh
+    void Draw(GLenum mode = GL_TRIANGLES) const;
+
+    inline unsigned int GetVertexArray() const { return m_vertexArray.name; }
+    inline std::size_t GetVertexCount() const { return m_vertexCount; }
+    inline std::size_t GetIndexCount() const { return m_indexCount; }
+    // count Draw() submits, indices when the mesh has them, vertices otherwise
+    inline std::size_t GetDrawCount() const { return m_indexCount != 0 ? m_indexCount : m_vertexCount; }
+    // 0 for meshes drawn without indices, matches DrawPacket::indexType
+    inline GLenum GetIndexType() const { return m_indexCount != 0 ? m_indexType : 0; }
+    inline VertexStorage GetStorage() const { return m_storage; }
+    // bytes in the vertex and index buffers
+    inline std::size_t GetMemorySize() const { return m_vertexBytes + m_indexBytes; }
+
+    Mesh() = delete;
+    Mesh(const Mesh&) = delete;
+    Mesh(Mesh&&) = delete;
+    Mesh& operator=(const Mesh&) = delete;
+    Mesh& operator=(Mesh&&) = delete;
+
+private:
+    // where the vertex buffer binding of each stream points, one entry when interleaved
+    struct Stream
+    {
+        GLintptr offset;
+        GLsizei stride;
+    };
+
+    static unsigned int CreateBuffer(const void* data, std::size_t size);
+    static std::size_t IndexSize(GLenum indexType);
+
+    VertexArrayCache::VertexArray& m_vertexArray;
+    VertexStorage m_storage;
+    std::vector<Stream> m_streams;
+    unsigned int m_vertexBuffer;
+    unsigned int m_indexBuffer;
+    std::size_t m_vertexCount;
+    std::size_t m_indexCount;
+    GLenum m_indexType;
+    std::size_t m_vertexBytes;
+    std::size_t m_indexBytes;
+};
+
+template<typename Layout>
+inline Mesh::Mesh(VertexArrayCache& vertexArrays, Layout, const void* vertices, std::size_t vertexCount,
+                  VertexStorage storage, const void* indices, std::size_t indexCount, GLenum indexType)
+    : Mesh{vertexArrays, Layout::Descriptor(), vertices, vertexCount, storage, indices, indexCount, indexType}
+{}
+
+#endif // !MESH_H_10192026
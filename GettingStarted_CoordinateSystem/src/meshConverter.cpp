@@ -0,0 +1,170 @@
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <string_view>
+
+#include "gltfImporter.h"
+#include "jobSystem.h"
+#include "meshFile.h"
+#include "meshOptimizer.h"
+#include "objImporter.h"
+#include "vertexQuantizer.h"
+
+namespace
+{
+    // every instance of the default scene baked into one mesh in world space
+    bool LoadGltf(std::string_view path, MeshOptimizer::WeldResult& mesh)
+    {
+        JobSystem jobs;
+        GltfImporter::Scene scene;
+        if(!GltfImporter::Load(path, jobs, scene)){
+            return false;
+        }
+        scene.timings.Print(std::cout);
+        std::cout << "\n";
+
+        constexpr auto stride{PositionTexCoordNormalLayout::Stride};
+        mesh = MeshOptimizer::WeldResult{};
+        mesh.stride = stride;
+        for(const auto& instance : scene.instances){
+            glm::mat3 normalMatrix{glm::transpose(glm::inverse(glm::mat3{instance.world}))};
+            for(const auto& primitive : scene.meshes[instance.mesh].primitives){
+                const auto& geometry{primitive.geometry};
+                auto first{static_cast<std::uint32_t>(mesh.VertexCount())};
+                for(auto index : geometry.indices){
+                    mesh.indices.push_back(first + index);
+                }
+                for(std::size_t v{}; v < geometry.VertexCount(); ++v){
+                    float vertex[8];
+                    std::memcpy(vertex, geometry.vertices.data() + v * stride, stride);
+                    glm::vec3 position{instance.world * glm::vec4{vertex[0], vertex[1], vertex[2], 1.0f}};
+                    glm::vec3 normal{normalMatrix * glm::vec3{vertex[5], vertex[6], vertex[7]}};
+                    if(glm::dot(normal, normal) > 0.0f){
+                        normal = glm::normalize(normal);
+                    }
+                    std::memcpy(vertex, &position, sizeof(position));
+                    std::memcpy(vertex + 5, &normal, sizeof(normal));
+                    const auto* bytes{reinterpret_cast<const std::uint8_t*>(vertex)};
+                    mesh.vertices.insert(mesh.vertices.end(), bytes, bytes + stride);
+                }
+                mesh.originalVertexCount += geometry.indices.size();
+            }
+        }
+        return !mesh.indices.empty();
+    }
+}
+
+/*
+Offline converter from OBJ or glTF to the binary .mesh format.
+usage: meshConverter input.obj|input.gltf|input.glb output.mesh [--quantize] [--no-optimize] [--no-lods]
+glTF scenes are flattened, every mesh instance is transformed into world space and merged, texture
+references are dropped since the mesh format has none.
+The mesh is welded, reordered for the vertex caches and stored with 16 bit indices when it fits.
+--quantize stores snorm16 positions, unorm16 texture coordinates and octahedral normals (16 bytes
+per vertex instead of 32), the decode transform goes into the header.
+Unless --no-lods is given up to MeshFileHeader::MaxLods levels of detail are simplified from the
+optimized mesh, each with half the triangles of the one before, and stored after it in the index blob.
+*/
+int main(int argc, char* argv[])
+{
+    if(argc < 3){
+        std::cerr << "usage: meshConverter input.obj|input.gltf|input.glb output.mesh [--quantize] [--no-optimize] [--no-lods]" << std::endl;
+        return 1;
+    }
+    std::string_view input{argv[1]};
+    std::string_view output{argv[2]};
+    bool quantize{false};
+    bool optimize{true};
+    bool generateLods{true};
+    for(int i{3}; i < argc; ++i){
+        std::string_view option{argv[i]};
+        if(option == "--quantize"){
+            quantize = true;
+        }
+        else if(option == "--no-optimize"){
+            optimize = false;
+        }
+        else if(option == "--no-lods"){
+            generateLods = false;
+        }
+        else{
+            std::cerr << "unknown option " << option << std::endl;
+            return 1;
+        }
+    }
+
+    using clock = std::chrono::steady_clock;
+    auto start{clock::now()};
+    MeshOptimizer::WeldResult mesh;
+    bool gltf{input.ends_with(".gltf") || input.ends_with(".glb")};
+    if(!(gltf ? LoadGltf(input, mesh) : ObjImporter::Load(input, mesh))){
+        return 1;
+    }
+    auto imported{clock::now()};
+    if(optimize){
+        MeshOptimizer::Optimize(mesh);
+    }
+    auto optimized{clock::now()};
+    auto fullIndexCount{mesh.indices.size()};
+    std::vector<MeshOptimizer::Lod> lods;
+    if(generateLods){
+        lods = MeshOptimizer::GenerateLods(mesh, MeshFileHeader::MaxLods);
+    }
+    auto simplified{clock::now()};
+
+    MeshFileData data;
+    data.boundsMin = glm::vec3{std::numeric_limits<float>::max()};
+    data.boundsMax = glm::vec3{std::numeric_limits<float>::lowest()};
+    for(std::size_t v{}; v < mesh.VertexCount(); ++v){
+        glm::vec3 position;
+        std::memcpy(&position, mesh.vertices.data() + v * mesh.stride, sizeof(position));
+        data.boundsMin = glm::min(data.boundsMin, position);
+        data.boundsMax = glm::max(data.boundsMax, position);
+    }
+    if(quantize){
+        auto quantized{VertexQuantizer::Quantize(mesh.vertices.data(), mesh.VertexCount(), mesh.stride,
+                                                 0, 3 * sizeof(float), 5 * sizeof(float))};
+        // the quantized layout keeps the normal at location 2 like the float one
+        const auto& formats{QuantizedPositionTexCoordNormalLayout::Formats};
+        data.attributes.assign(formats.begin(), formats.end());
+        data.stride = QuantizedPositionTexCoordNormalLayout::Stride;
+        data.vertices = std::move(quantized.vertices);
+        data.positionScale = quantized.transform.scale;
+        data.positionBias = quantized.transform.bias;
+        std::cout << "quantized, position error max " << quantized.error.maxPosition << ", texture coordinate error max "
+            << quantized.error.maxTexCoord << ", normal error max " << quantized.error.maxNormalDegrees << " degrees\n";
+    }
+    else{
+        const auto& formats{PositionTexCoordNormalLayout::Formats};
+        data.attributes.assign(formats.begin(), formats.end());
+        data.stride = PositionTexCoordNormalLayout::Stride;
+        data.vertices = mesh.vertices;
+    }
+    auto indices{MeshOptimizer::PackIndices(mesh.indices, mesh.VertexCount())};
+    data.indices = std::move(indices.data);
+    data.indexType = indices.type;
+    for(const auto& lod : lods){
+        data.lods.push_back(MeshLod{static_cast<std::uint32_t>(lod.firstIndex), static_cast<std::uint32_t>(lod.indexCount), lod.error, 0});
+    }
+
+    if(!MeshFile::Write(output, data)){
+        return 1;
+    }
+    auto written{clock::now()};
+
+    auto cache{MeshOptimizer::AnalyzeVertexCache(mesh.indices.data(), fullIndexCount, mesh.VertexCount())};
+    auto milliseconds = [](clock::time_point from, clock::time_point to){
+        return std::chrono::duration<double, std::milli>(to - from).count();
+    };
+    std::cout << input << " -> " << output << ": " << mesh.originalVertexCount << " corners welded to "
+        << mesh.VertexCount() << " vertices, " << fullIndexCount / 3 << " triangles, ACMR " << cache.acmr << "\n";
+    for(std::size_t i{1}; i < lods.size(); ++i){
+        std::cout << "LOD " << i << ": " << lods[i].indexCount / 3 << " triangles, error " << lods[i].error << " of the radius\n";
+    }
+    std::cout << "import " << milliseconds(start, imported) << " ms, optimize " << milliseconds(imported, optimized)
+        << " ms, simplify " << milliseconds(optimized, simplified) << " ms, write " << milliseconds(simplified, written)
+        << " ms" << std::endl;
+
+    return 0;
+}
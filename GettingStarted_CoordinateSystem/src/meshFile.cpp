@@ -0,0 +1,159 @@
+#include "meshFile.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace
+{
+    inline std::uint64_t AlignBlob(std::uint64_t offset)
+    {
+        return (offset + MeshFileHeader::BlobAlignment - 1) / MeshFileHeader::BlobAlignment * MeshFileHeader::BlobAlignment;
+    }
+
+    inline std::uint64_t IndexSize(std::uint32_t indexType)
+    {
+        switch(indexType){
+            case GL_UNSIGNED_SHORT:
+                return 2;
+            case GL_UNSIGNED_INT:
+                return 4;
+            default:
+                return 0;
+        }
+    }
+}
+
+MeshFile::MeshFile(std::string_view path)
+    : m_file{path}, m_header{}, m_layoutKey{}
+{
+    if(!Validate(path)){
+        return;
+    }
+    m_header = reinterpret_cast<const MeshFileHeader*>(m_file.Data());
+    m_layoutKey = VertexLayoutDetail::MakeKey(std::span<const AttributeFormat>{m_header->attributes, m_header->attributeCount});
+}
+
+VertexLayoutDescriptor MeshFile::GetLayout() const
+{
+    return VertexLayoutDescriptor{std::span<const AttributeFormat>{m_header->attributes, m_header->attributeCount},
+                                  m_header->stride, m_layoutKey};
+}
+
+glm::mat4 MeshFile::GetDecodeMatrix() const
+{
+    glm::vec3 scale{m_header->positionScale[0], m_header->positionScale[1], m_header->positionScale[2]};
+    glm::vec3 bias{m_header->positionBias[0], m_header->positionBias[1], m_header->positionBias[2]};
+    return glm::scale(glm::translate(glm::mat4{1.0f}, bias), scale);
+}
+
+bool MeshFile::Validate(std::string_view path) const
+{
+    if(!m_file.IsOpen()){
+        return false;
+    }
+    auto fail = [path](const char* reason){
+        std::cerr << "Error: " << path << " is not a valid mesh file, " << reason << std::endl;
+        return false;
+    };
+    if(m_file.Size() < sizeof(MeshFileHeader)){
+        return fail("too small for the header");
+    }
+    const auto* header{reinterpret_cast<const MeshFileHeader*>(m_file.Data())};
+    if(header->magic != MeshFileHeader::Magic){
+        return fail("bad magic");
+    }
+    if(header->version != MeshFileHeader::Version || header->headerSize != sizeof(MeshFileHeader)){
+        return fail("unsupported version");
+    }
+    if(header->attributeCount == 0 || header->attributeCount > MeshFileHeader::MaxAttributes ||
+       header->lodCount == 0 || header->lodCount > MeshFileHeader::MaxLods || header->stride == 0){
+        return fail("bad layout");
+    }
+    for(std::uint32_t i{}; i < header->attributeCount; ++i){
+        const auto& attribute{header->attributes[i]};
+        if(std::uint64_t{attribute.offset} + attribute.size > header->stride || attribute.components < 1 || attribute.components > 4){
+            return fail("attribute outside the vertex");
+        }
+    }
+    auto inFile = [this](std::uint64_t offset, std::uint64_t size){
+        return offset % MeshFileHeader::BlobAlignment == 0 && offset <= m_file.Size() && size <= m_file.Size() - offset;
+    };
+    if(header->vertexCount == 0 || header->vertexSize != std::uint64_t{header->vertexCount} * header->stride ||
+       !inFile(header->vertexOffset, header->vertexSize)){
+        return fail("vertex data out of range");
+    }
+    if(header->indexCount != 0 &&
+       (IndexSize(header->indexType) == 0 || header->indexSize != header->indexCount * IndexSize(header->indexType) ||
+        !inFile(header->indexOffset, header->indexSize))){
+        return fail("index data out of range");
+    }
+    for(std::uint32_t i{}; i < header->lodCount; ++i){
+        const auto& lod{header->lods[i]};
+        if(std::uint64_t{lod.firstIndex} + lod.indexCount > header->indexCount){
+            return fail("LOD outside the indices");
+        }
+    }
+    return true;
+}
+
+bool MeshFile::Write(std::string_view path, const MeshFileData& data)
+{
+    if(data.attributes.empty() || data.attributes.size() > MeshFileHeader::MaxAttributes ||
+       data.lods.size() > MeshFileHeader::MaxLods || data.stride == 0 || data.vertices.size() % data.stride != 0 ||
+       (!data.indices.empty() && IndexSize(data.indexType) == 0)){
+        std::cerr << "Error: mesh data for " << path << " does not fit the mesh file format" << std::endl;
+        return false;
+    }
+
+    MeshFileHeader header{};
+    header.magic = MeshFileHeader::Magic;
+    header.version = MeshFileHeader::Version;
+    header.headerSize = sizeof(MeshFileHeader);
+    header.attributeCount = static_cast<std::uint32_t>(data.attributes.size());
+    header.stride = data.stride;
+    header.vertexCount = static_cast<std::uint32_t>(data.vertices.size() / data.stride);
+    header.indexType = data.indices.empty() ? 0 : data.indexType;
+    header.indexCount = data.indices.empty() ? 0 : static_cast<std::uint32_t>(data.indices.size() / IndexSize(data.indexType));
+    for(int axis{}; axis < 3; ++axis){
+        header.boundsMin[axis] = data.boundsMin[axis];
+        header.boundsMax[axis] = data.boundsMax[axis];
+        header.positionScale[axis] = data.positionScale[axis];
+        header.positionBias[axis] = data.positionBias[axis];
+    }
+    std::copy(data.attributes.begin(), data.attributes.end(), header.attributes);
+    if(data.lods.empty()){
+        header.lodCount = 1;
+        header.lods[0] = MeshLod{0, header.indexCount, 0.0f, 0};
+    }
+    else{
+        header.lodCount = static_cast<std::uint32_t>(data.lods.size());
+        std::copy(data.lods.begin(), data.lods.end(), header.lods);
+    }
+    header.vertexOffset = AlignBlob(sizeof(MeshFileHeader));
+    header.vertexSize = data.vertices.size();
+    header.indexOffset = AlignBlob(header.vertexOffset + header.vertexSize);
+    header.indexSize = data.indices.size();
+
+    std::ofstream file{std::string{path}, std::ios::binary | std::ios::trunc};
+    if(!file){
+        std::cerr << "Error: could not create " << path << std::endl;
+        return false;
+    }
+    const char padding[MeshFileHeader::BlobAlignment]{};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(padding, static_cast<std::streamsize>(header.vertexOffset - sizeof(header)));
+    file.write(reinterpret_cast<const char*>(data.vertices.data()), static_cast<std::streamsize>(data.vertices.size()));
+    if(!data.indices.empty()){
+        file.write(padding, static_cast<std::streamsize>(header.indexOffset - header.vertexOffset - header.vertexSize));
+        file.write(reinterpret_cast<const char*>(data.indices.data()), static_cast<std::streamsize>(data.indices.size()));
+    }
+    if(!file){
+        std::cerr << "Error: could not write " << path << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,120 @@
+#ifndef MESH_FILE_H_10192026
+#define MESH_FILE_H_10192026
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "mappedFile.h"
+#include "vertexLayout.h"
+
+// range of the index blob drawing one level of detail, error is what the simplifier gave up
+struct MeshLod
+{
+    std::uint32_t firstIndex;
+    std::uint32_t indexCount;
+    float error;
+    std::uint32_t reserved;
+};
+
+/*
+on disk header of a .mesh file, all values little endian
+the vertex blob is interleaved in the stored layout, the index blob holds every LOD back to back,
+both start on BlobAlignment bytes so they can go to the GPU straight from the mapping
+*/
+struct MeshFileHeader
+{
+    static constexpr std::uint32_t Magic{0x4853454du};      // "MESH"
+    static constexpr std::uint32_t Version{1};
+    static constexpr std::size_t MaxAttributes{8};
+    static constexpr std::size_t MaxLods{8};
+    static constexpr std::size_t BlobAlignment{64};
+
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint32_t headerSize;
+    std::uint32_t attributeCount;
+    std::uint32_t stride;
+    std::uint32_t vertexCount;
+    std::uint32_t indexCount;
+    std::uint32_t indexType;        // GL_UNSIGNED_SHORT, GL_UNSIGNED_INT or 0 without indices
+    std::uint32_t lodCount;
+    std::uint32_t reserved;
+    float boundsMin[3];
+    float boundsMax[3];
+    float positionScale[3];         // quantized positions decode to stored * scale + bias
+    float positionBias[3];
+    std::uint64_t vertexOffset;
+    std::uint64_t vertexSize;
+    std::uint64_t indexOffset;
+    std::uint64_t indexSize;
+    AttributeFormat attributes[MaxAttributes];
+    MeshLod lods[MaxLods];
+};
+
+static_assert(std::is_trivially_copyable_v<AttributeFormat> && sizeof(AttributeFormat) == 24, "attribute record changed size");
+static_assert(std::is_trivially_copyable_v<MeshFileHeader> && sizeof(MeshFileHeader) % 8 == 0, "header has to be plain data");
+
+// everything MeshFile::Write stores, vertices interleaved in the attributes' layout
+struct MeshFileData
+{
+    std::vector<AttributeFormat> attributes;
+    unsigned int stride{};
+    std::vector<std::uint8_t> vertices;
+    std::vector<std::uint8_t> indices;
+    GLenum indexType{};
+    glm::vec3 boundsMin{};
+    glm::vec3 boundsMax{};
+    glm::vec3 positionScale{1.0f};
+    glm::vec3 positionBias{};
+    std::vector<MeshLod> lods;      // empty stores a single LOD covering every index
+};
+
+/*
+Binary mesh container read without parsing: the file is memory mapped, the header is validated
+and the vertex and index blobs are handed to Mesh, and through it glBufferStorage, as they are.
+Loading is bound by I/O, a converter (meshConverter.cpp) builds the files offline from OBJ.
+The data stays valid as long as the MeshFile lives, Mesh copies it into its buffers on construction.
+*/
+class MeshFile
+{
+public:
+    explicit MeshFile(std::string_view path);
+
+    inline bool IsValid() const { return m_header != nullptr; }
+    inline const MeshFileHeader& GetHeader() const { return *m_header; }
+
+    // the attributes point into the mapping
+    VertexLayoutDescriptor GetLayout() const;
+    inline const void* GetVertices() const { return m_file.Data() + m_header->vertexOffset; }
+    inline std::size_t GetVertexCount() const { return m_header->vertexCount; }
+    inline const void* GetIndices() const { return m_header->indexCount != 0 ? m_file.Data() + m_header->indexOffset : nullptr; }
+    inline std::size_t GetIndexCount() const { return m_header->indexCount; }
+    inline GLenum GetIndexType() const { return m_header->indexType; }
+    inline std::span<const MeshLod> GetLods() const { return {m_header->lods, m_header->lodCount}; }
+    // model space from stored positions, identity for float positions
+    glm::mat4 GetDecodeMatrix() const;
+
+    static bool Write(std::string_view path, const MeshFileData& data);
+
+    MeshFile() = delete;
+    MeshFile(const MeshFile&) = delete;
+    MeshFile(MeshFile&&) = delete;
+    MeshFile& operator=(const MeshFile&) = delete;
+    MeshFile& operator=(MeshFile&&) = delete;
+
+private:
+    bool Validate(std::string_view path) const;
+
+    MappedFile m_file;
+    const MeshFileHeader* m_header;
+    std::uint64_t m_layoutKey;
+};
+
+#endif // !MESH_FILE_H_10192026
@@ -0,0 +1,100 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include "benchmarkMeshes.h"
+#include "meshFile.h"
+#include "meshOptimizer.h"
+#include "objImporter.h"
+
+// settings
+constexpr std::size_t RINGS{500};
+constexpr std::size_t SEGMENTS{1000};
+constexpr const char* OBJ_PATH{"meshFile_benchmark.obj"};
+constexpr const char* MESH_PATH{"meshFile_benchmark.mesh"};
+
+/*
+Write a UV sphere of RINGS * SEGMENTS quads as OBJ triangles and as .mesh, then compare how long each takes
+to become GPU ready data: parsing and welding the OBJ against mapping the mesh file and touching
+every byte, which is what glBufferStorage would do with it.
+*/
+int main()
+{
+    {
+        auto sphere{MakeUvSphere(RINGS, SEGMENTS)};
+        std::ofstream obj{OBJ_PATH};
+        for(std::size_t v{}; v < sphere.positions.size(); ++v){
+            const auto& normal{sphere.positions[v]};
+            obj << "v " << normal.x << " " << normal.y << " " << normal.z << "\n"
+                << "vt " << sphere.texCoords[v].x << " " << sphere.texCoords[v].y << "\n"
+                << "vn " << normal.x << " " << normal.y << " " << normal.z << "\n";
+        }
+        // OBJ indices start at 1
+        for(std::size_t i{}; i < sphere.indices.size(); i += 3){
+            obj << "f";
+            for(std::size_t corner{}; corner < 3; ++corner){
+                auto index{sphere.indices[i + corner] + 1};
+                obj << " " << index << "/" << index << "/" << index;
+            }
+            obj << "\n";
+        }
+    }
+
+    using clock = std::chrono::steady_clock;
+    auto start{clock::now()};
+    MeshOptimizer::WeldResult mesh;
+    if(!ObjImporter::Load(OBJ_PATH, mesh)){
+        return 1;
+    }
+    auto objMilliseconds{std::chrono::duration<double, std::milli>(clock::now() - start).count()};
+
+    MeshFileData data;
+    const auto& formats{PositionTexCoordNormalLayout::Formats};
+    data.attributes.assign(formats.begin(), formats.end());
+    data.stride = PositionTexCoordNormalLayout::Stride;
+    data.vertices = mesh.vertices;
+    data.boundsMin = glm::vec3{-1.0f};
+    data.boundsMax = glm::vec3{1.0f};
+    auto indices{MeshOptimizer::PackIndices(mesh.indices, mesh.VertexCount())};
+    data.indices = std::move(indices.data);
+    data.indexType = indices.type;
+    if(!MeshFile::Write(MESH_PATH, data)){
+        return 1;
+    }
+
+    start = clock::now();
+    std::uint64_t checksum{};
+    std::size_t bytes{};
+    {
+        MeshFile file{MESH_PATH};
+        if(!file.IsValid()){
+            return 1;
+        }
+        // fault every page in, a driver copying the blobs reads them the same way
+        const auto* vertices{static_cast<const std::uint8_t*>(file.GetVertices())};
+        const auto* indexData{static_cast<const std::uint8_t*>(file.GetIndices())};
+        auto vertexBytes{file.GetVertexCount() * file.GetHeader().stride};
+        auto indexBytes{file.GetHeader().indexSize};
+        for(std::size_t i{}; i < vertexBytes; i += 64){
+            checksum += vertices[i];
+        }
+        for(std::size_t i{}; i < indexBytes; i += 64){
+            checksum += indexData[i];
+        }
+        bytes = vertexBytes + indexBytes;
+    }
+    auto meshMilliseconds{std::chrono::duration<double, std::milli>(clock::now() - start).count()};
+
+    std::cout << mesh.VertexCount() << " vertices, " << mesh.indices.size() / 3 << " triangles, "
+        << bytes / (1024 * 1024) << " MB of GPU data\n"
+        << "OBJ parse and weld " << objMilliseconds << " ms\n"
+        << "mesh file map and read " << meshMilliseconds << " ms, " << objMilliseconds / meshMilliseconds
+        << "x faster (checksum " << checksum << ")" << std::endl;
+
+    std::remove(OBJ_PATH);
+    std::remove(MESH_PATH);
+    return 0;
+}
@@ -0,0 +1,634 @@
+#include "meshOptimizer.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include <glm/glm.hpp>
+
+namespace
+{
+    // FNV-1a over the vertex bytes
+    inline std::uint32_t HashVertex(const std::uint8_t* vertex, std::size_t stride)
+    {
+        std::uint32_t hash{2166136261u};
+        for(std::size_t i{}; i < stride; ++i){
+            hash = (hash ^ vertex[i]) * 16777619u;
+        }
+        return hash;
+    }
+
+    inline std::size_t TableSize(std::size_t count)
+    {
+        // power of two at least twice the count keeps linear probing chains short
+        std::size_t size{16};
+        while(size < count * 2){
+            size *= 2;
+        }
+        return size;
+    }
+
+    // sum of squared distances to a set of area weighted planes, Garland and Heckbert 1997
+    struct Quadric
+    {
+        double a00, a11, a22, a01, a02, a12;
+        double b0, b1, b2;
+        double c;
+        double weight;
+
+        void AddPlane(const glm::dvec3& normal, double distance, double area)
+        {
+            a00 += area * normal.x * normal.x;
+            a11 += area * normal.y * normal.y;
+            a22 += area * normal.z * normal.z;
+            a01 += area * normal.x * normal.y;
+            a02 += area * normal.x * normal.z;
+            a12 += area * normal.y * normal.z;
+            b0 += area * normal.x * distance;
+            b1 += area * normal.y * distance;
+            b2 += area * normal.z * distance;
+            c += area * distance * distance;
+            weight += area;
+        }
+
+        Quadric& operator+=(const Quadric& other)
+        {
+            a00 += other.a00; a11 += other.a11; a22 += other.a22;
+            a01 += other.a01; a02 += other.a02; a12 += other.a12;
+            b0 += other.b0; b1 += other.b1; b2 += other.b2;
+            c += other.c;
+            weight += other.weight;
+            return *this;
+        }
+
+        // mean squared distance of p to the planes
+        double Error(const glm::dvec3& p) const
+        {
+            double error{a00 * p.x * p.x + a11 * p.y * p.y + a22 * p.z * p.z +
+                         2.0 * (a01 * p.x * p.y + a02 * p.x * p.z + a12 * p.y * p.z) +
+                         2.0 * (b0 * p.x + b1 * p.y + b2 * p.z) + c};
+            return weight > 0.0 ? std::abs(error) / weight : 0.0;
+        }
+    };
+}
+
+MeshOptimizer::WeldResult MeshOptimizer::Weld(const void* vertices, std::size_t vertexCount, std::size_t stride)
+{
+    assert(stride > 0);
+    const auto* source{static_cast<const std::uint8_t*>(vertices)};
+    WeldResult result;
+    result.stride = stride;
+    result.originalVertexCount = vertexCount;
+    result.indices.resize(vertexCount);
+    result.vertices.reserve(vertexCount * stride);
+
+    constexpr auto empty{std::numeric_limits<std::uint32_t>::max()};
+    std::vector<std::uint32_t> table(TableSize(vertexCount), empty);
+    const auto mask{table.size() - 1};
+
+    std::uint32_t unique{};
+    for(std::size_t i{}; i < vertexCount; ++i){
+        const auto* vertex{source + i * stride};
+        auto slot{HashVertex(vertex, stride) & mask};
+        while(table[slot] != empty && std::memcmp(result.vertices.data() + table[slot] * stride, vertex, stride) != 0){
+            slot = (slot + 1) & mask;
+        }
+        if(table[slot] == empty){
+            table[slot] = unique++;
+            result.vertices.insert(result.vertices.end(), vertex, vertex + stride);
+        }
+        result.indices[i] = table[slot];
+    }
+    return result;
+}
+
+MeshOptimizer::IndexBuffer MeshOptimizer::PackIndices(const std::vector<std::uint32_t>& indices, std::size_t vertexCount)
+{
+    IndexBuffer buffer;
+    buffer.count = indices.size();
+    if(vertexCount <= std::size_t{std::numeric_limits<std::uint16_t>::max()} + 1){
+        buffer.type = GL_UNSIGNED_SHORT;
+        buffer.data.resize(indices.size() * sizeof(std::uint16_t));
+        auto* destination{reinterpret_cast<std::uint16_t*>(buffer.data.data())};
+        std::transform(indices.begin(), indices.end(), destination, [](std::uint32_t index){
+            return static_cast<std::uint16_t>(index);
+        });
+    }
+    else{
+        buffer.type = GL_UNSIGNED_INT;
+        buffer.data.resize(indices.size() * sizeof(std::uint32_t));
+        std::memcpy(buffer.data.data(), indices.data(), buffer.data.size());
+    }
+    return buffer;
+}
+
+MeshOptimizer::CacheStats MeshOptimizer::AnalyzeVertexCache(const std::uint32_t* indices, std::size_t indexCount,
+                                                            std::size_t vertexCount, std::size_t cacheSize)
+{
+    assert(cacheSize > 0);
+    CacheStats stats;
+    stats.indices = indexCount;
+
+    // FIFO cache, a vertex stays in it until cacheSize newer vertices were shaded
+    std::vector<std::size_t> shadedAt(vertexCount, std::numeric_limits<std::size_t>::max());
+    for(std::size_t i{}; i < indexCount; ++i){
+        auto index{indices[i]};
+        assert(index < vertexCount);
+        if(shadedAt[index] != std::numeric_limits<std::size_t>::max() && stats.misses - shadedAt[index] <= cacheSize){
+            ++stats.hits;
+        }
+        else{
+            shadedAt[index] = stats.misses++;
+        }
+    }
+
+    if(indexCount >= 3){
+        stats.acmr = static_cast<double>(stats.misses) / static_cast<double>(indexCount / 3);
+    }
+    if(vertexCount != 0){
+        stats.atvr = static_cast<double>(stats.misses) / static_cast<double>(vertexCount);
+    }
+    return stats;
+}
+
+namespace
+{
+    // scoring from Tom Forsyth, "Linear-Speed Vertex Cache Optimisation"
+    constexpr std::size_t ForsythCacheSize{32};
+    constexpr float CacheDecayPower{1.5f};
+    constexpr float LastTriangleScore{0.75f};
+    constexpr float ValenceBoostScale{2.0f};
+    constexpr float ValenceBoostPower{0.5f};
+
+    float VertexScore(int cachePosition, std::uint32_t remainingTriangles)
+    {
+        if(remainingTriangles == 0){
+            return -1.0f;
+        }
+        float score{};
+        if(cachePosition >= 0){
+            if(cachePosition < 3){
+                // the vertices of the last triangle get a fixed score so its neighbours don't win too easily
+                score = LastTriangleScore;
+            }
+            else{
+                constexpr float scaler{1.0f / (ForsythCacheSize - 3)};
+                score = std::pow(1.0f - static_cast<float>(cachePosition - 3) * scaler, CacheDecayPower);
+            }
+        }
+        // favour vertices with few triangles left, finishing them frees their cache slot
+        score += ValenceBoostScale * std::pow(static_cast<float>(remainingTriangles), -ValenceBoostPower);
+        return score;
+    }
+}
+
+void MeshOptimizer::OptimizeVertexCache(std::vector<std::uint32_t>& indices, std::size_t vertexCount)
+{
+    const auto triangleCount{indices.size() / 3};
+    if(triangleCount == 0){
+        return;
+    }
+
+    // triangles of each vertex, vertex v owns adjacency[offsets[v], offsets[v] + remaining[v])
+    std::vector<std::uint32_t> remaining(vertexCount);
+    for(auto index : indices){
+        assert(index < vertexCount);
+        ++remaining[index];
+    }
+    std::vector<std::uint32_t> offsets(vertexCount + 1);
+    for(std::size_t v{}; v < vertexCount; ++v){
+        offsets[v + 1] = offsets[v] + remaining[v];
+    }
+    std::vector<std::uint32_t> adjacency(indices.size());
+    {
+        auto fill{offsets};
+        for(std::size_t i{}; i < indices.size(); ++i){
+            adjacency[fill[indices[i]]++] = static_cast<std::uint32_t>(i / 3);
+        }
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for(std::size_t v{}; v < vertexCount; ++v){
+        vertexScore[v] = VertexScore(-1, remaining[v]);
+    }
+    std::vector<bool> emitted(triangleCount);
+    std::vector<std::uint32_t> output;
+    output.reserve(indices.size());
+    // three extra slots hold the vertices pushed out by the newest triangle
+    std::vector<std::uint32_t> cache, nextCache;
+    cache.reserve(ForsythCacheSize + 3);
+    nextCache.reserve(ForsythCacheSize + 3);
+
+    std::size_t cursor{};
+    auto best{std::numeric_limits<std::size_t>::max()};
+    for(std::size_t emittedCount{}; emittedCount < triangleCount; ++emittedCount){
+        if(best == std::numeric_limits<std::size_t>::max()){
+            // nothing in the cache has triangles left, continue with the next unused triangle in input order
+            while(emitted[cursor]){
+                ++cursor;
+            }
+            best = cursor;
+        }
+
+        const auto triangle{best};
+        emitted[triangle] = true;
+        nextCache.clear();
+        for(int corner{}; corner < 3; ++corner){
+            auto v{indices[triangle * 3 + corner]};
+            output.push_back(v);
+            // take the triangle out of the vertex's list
+            auto* first{adjacency.data() + offsets[v]};
+            auto* last{first + remaining[v]};
+            *std::find(first, last, static_cast<std::uint32_t>(triangle)) = *(last - 1);
+            --remaining[v];
+            if(std::find(nextCache.begin(), nextCache.end(), v) == nextCache.end()){
+                nextCache.push_back(v);
+            }
+        }
+        for(auto v : cache){
+            if(std::find(nextCache.begin(), nextCache.end(), v) == nextCache.end()){
+                nextCache.push_back(v);
+            }
+        }
+        std::swap(cache, nextCache);
+
+        // rescore everything that moved in the cache, including what just fell out of it
+        for(std::size_t position{}; position < cache.size(); ++position){
+            auto v{cache[position]};
+            cachePosition[v] = position < ForsythCacheSize ? static_cast<int>(position) : -1;
+            vertexScore[v] = VertexScore(cachePosition[v], remaining[v]);
+        }
+        best = std::numeric_limits<std::size_t>::max();
+        float bestScore{-1.0f};
+        for(auto v : cache){
+            for(auto i{offsets[v]}; i < offsets[v] + remaining[v]; ++i){
+                auto t{adjacency[i]};
+                auto score{vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]]};
+                if(score > bestScore){
+                    bestScore = score;
+                    best = t;
+                }
+            }
+        }
+        if(cache.size() > ForsythCacheSize){
+            cache.resize(ForsythCacheSize);
+        }
+    }
+    indices = std::move(output);
+}
+
+void MeshOptimizer::OptimizeOverdraw(std::vector<std::uint32_t>& indices, const void* vertices, std::size_t vertexCount,
+                                     std::size_t stride, std::size_t positionOffset, std::size_t minClusterTriangles)
+{
+    const auto triangleCount{indices.size() / 3};
+    if(triangleCount == 0){
+        return;
+    }
+    const auto* source{static_cast<const std::uint8_t*>(vertices)};
+    auto position = [&](std::uint32_t index){
+        float xyz[3];
+        std::memcpy(xyz, source + index * stride + positionOffset, sizeof(xyz));
+        return glm::vec3{xyz[0], xyz[1], xyz[2]};
+    };
+
+    // a cluster ends where the cache order jumped, a triangle sharing no vertex with the cache
+    std::vector<std::size_t> clusterStarts{0};
+    {
+        std::vector<std::size_t> shadedAt(vertexCount, std::numeric_limits<std::size_t>::max());
+        std::size_t misses{};
+        for(std::size_t t{}; t < triangleCount; ++t){
+            int triangleMisses{};
+            for(int corner{}; corner < 3; ++corner){
+                auto v{indices[t * 3 + corner]};
+                if(shadedAt[v] == std::numeric_limits<std::size_t>::max() || misses - shadedAt[v] > DefaultCacheSize){
+                    shadedAt[v] = misses++;
+                    ++triangleMisses;
+                }
+            }
+            if(triangleMisses == 3 && t - clusterStarts.back() >= minClusterTriangles){
+                clusterStarts.push_back(t);
+            }
+        }
+    }
+    clusterStarts.push_back(triangleCount);
+
+    // area weighted centroid and normal of each cluster and of the whole mesh
+    struct Cluster
+    {
+        std::size_t first;
+        std::size_t last;
+        float sortKey;
+    };
+    std::vector<Cluster> clusters;
+    std::vector<glm::vec3> centroids, normals;
+    glm::vec3 meshCentroid{};
+    float meshArea{};
+    for(std::size_t c{}; c + 1 < clusterStarts.size(); ++c){
+        glm::vec3 centroid{}, normal{};
+        float area{};
+        for(auto t{clusterStarts[c]}; t < clusterStarts[c + 1]; ++t){
+            auto a{position(indices[t * 3])}, b{position(indices[t * 3 + 1])}, d{position(indices[t * 3 + 2])};
+            auto cross{glm::cross(b - a, d - a)};
+            auto triangleArea{glm::length(cross)};
+            centroid += (a + b + d) * (triangleArea / 3.0f);
+            normal += cross;
+            area += triangleArea;
+        }
+        meshCentroid += centroid;
+        meshArea += area;
+        centroids.push_back(area > 0.0f ? centroid / area : centroid);
+        normals.push_back(glm::length(normal) > 0.0f ? glm::normalize(normal) : normal);
+        clusters.push_back({clusterStarts[c], clusterStarts[c + 1], 0.0f});
+    }
+    if(meshArea > 0.0f){
+        meshCentroid /= meshArea;
+    }
+    for(std::size_t c{}; c < clusters.size(); ++c){
+        clusters[c].sortKey = glm::dot(centroids[c] - meshCentroid, normals[c]);
+    }
+    std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& a, const Cluster& b){
+        return a.sortKey > b.sortKey;
+    });
+
+    std::vector<std::uint32_t> output;
+    output.reserve(indices.size());
+    for(const auto& cluster : clusters){
+        output.insert(output.end(), indices.begin() + cluster.first * 3, indices.begin() + cluster.last * 3);
+    }
+    indices = std::move(output);
+}
+
+std::size_t MeshOptimizer::OptimizeVertexFetch(std::vector<std::uint32_t>& indices, void* vertices, std::size_t vertexCount,
+                                               std::size_t stride)
+{
+    constexpr auto unused{std::numeric_limits<std::uint32_t>::max()};
+    std::vector<std::uint32_t> remap(vertexCount, unused);
+    std::uint32_t next{};
+    for(auto& index : indices){
+        assert(index < vertexCount);
+        if(remap[index] == unused){
+            remap[index] = next++;
+        }
+        index = remap[index];
+    }
+
+    auto* data{static_cast<std::uint8_t*>(vertices)};
+    std::vector<std::uint8_t> reordered(next * stride);
+    for(std::size_t v{}; v < vertexCount; ++v){
+        if(remap[v] != unused){
+            std::memcpy(reordered.data() + remap[v] * stride, data + v * stride, stride);
+        }
+    }
+    std::memcpy(data, reordered.data(), reordered.size());
+    return next;
+}
+
+void MeshOptimizer::Optimize(WeldResult& mesh, std::size_t positionOffset)
+{
+    OptimizeVertexCache(mesh.indices, mesh.VertexCount());
+    OptimizeOverdraw(mesh.indices, mesh.vertices.data(), mesh.VertexCount(), mesh.stride, positionOffset);
+    auto vertexCount{OptimizeVertexFetch(mesh.indices, mesh.vertices.data(), mesh.VertexCount(), mesh.stride)};
+    mesh.vertices.resize(vertexCount * mesh.stride);
+}
+
+std::vector<std::uint32_t> MeshOptimizer::Simplify(const std::vector<std::uint32_t>& indices, const void* vertices,
+                                                   std::size_t vertexCount, std::size_t stride, std::size_t targetIndexCount,
+                                                   float targetError, float* resultError, std::size_t positionOffset)
+{
+    if(resultError){
+        *resultError = 0.0f;
+    }
+    std::vector<std::uint32_t> current{indices};
+    if(current.size() <= targetIndexCount || vertexCount == 0){
+        return current;
+    }
+    const auto* source{static_cast<const std::uint8_t*>(vertices)};
+    std::vector<glm::vec3> positions(vertexCount);
+    glm::vec3 boundsMin{std::numeric_limits<float>::max()}, boundsMax{std::numeric_limits<float>::lowest()};
+    for(std::size_t v{}; v < vertexCount; ++v){
+        std::memcpy(&positions[v], source + v * stride + positionOffset, sizeof(glm::vec3));
+        boundsMin = glm::min(boundsMin, positions[v]);
+        boundsMax = glm::max(boundsMax, positions[v]);
+    }
+    // errors are relative to the bounding sphere radius
+    const double radius{std::max(0.5 * glm::length(glm::dvec3{boundsMax - boundsMin}), 1e-12)};
+
+    // vertices split only by texture coordinates or normals share a position and its quadric
+    constexpr auto empty{std::numeric_limits<std::uint32_t>::max()};
+    std::vector<std::uint32_t> positionOf(vertexCount);
+    std::vector<std::uint32_t> wedges(vertexCount);
+    {
+        std::vector<std::uint32_t> table(TableSize(vertexCount), empty);
+        const auto mask{table.size() - 1};
+        for(std::uint32_t v{}; v < vertexCount; ++v){
+            const auto* bytes{reinterpret_cast<const std::uint8_t*>(&positions[v])};
+            auto slot{HashVertex(bytes, sizeof(glm::vec3)) & mask};
+            while(table[slot] != empty && std::memcmp(&positions[table[slot]], bytes, sizeof(glm::vec3)) != 0){
+                slot = (slot + 1) & mask;
+            }
+            if(table[slot] == empty){
+                table[slot] = v;
+            }
+            positionOf[v] = table[slot];
+            ++wedges[table[slot]];
+        }
+    }
+
+    // attribute seams and open borders stay where they are so the silhouette and the UV layout hold
+    std::vector<bool> locked(vertexCount);
+    {
+        std::vector<std::uint64_t> edges;
+        edges.reserve(current.size());
+        for(std::size_t t{}; t + 2 < current.size(); t += 3){
+            for(int e{}; e < 3; ++e){
+                std::uint64_t a{positionOf[current[t + e]]}, b{positionOf[current[t + (e + 1) % 3]]};
+                edges.push_back(std::min(a, b) << 32 | std::max(a, b));
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+        for(std::size_t i{}; i < edges.size();){
+            auto j{i};
+            while(j < edges.size() && edges[j] == edges[i]){
+                ++j;
+            }
+            if(j - i == 1){
+                locked[edges[i] >> 32] = true;
+                locked[edges[i] & 0xffffffffu] = true;
+            }
+            i = j;
+        }
+        for(std::size_t v{}; v < vertexCount; ++v){
+            if(wedges[positionOf[v]] > 1){
+                locked[positionOf[v]] = true;
+            }
+        }
+    }
+
+    std::vector<Quadric> quadrics(vertexCount, Quadric{});
+    for(std::size_t t{}; t + 2 < current.size(); t += 3){
+        glm::dvec3 a{positions[current[t]]}, b{positions[current[t + 1]]}, c{positions[current[t + 2]]};
+        auto normal{glm::cross(b - a, c - a)};
+        auto length{glm::length(normal)};
+        if(length == 0.0){
+            continue;
+        }
+        normal /= length;
+        for(auto v : {current[t], current[t + 1], current[t + 2]}){
+            quadrics[positionOf[v]].AddPlane(normal, -glm::dot(normal, a), 0.5 * length);
+        }
+    }
+
+    struct Collapse
+    {
+        double error;
+        std::uint32_t from;
+        std::uint32_t to;
+    };
+    std::vector<Collapse> collapses;
+    std::vector<std::uint32_t> triangleStart(vertexCount + 1), triangleList;
+    std::vector<std::uint32_t> target(vertexCount);
+    std::vector<bool> touched(vertexCount);
+    double maxError{};
+
+    // each pass collapses the cheapest edges whose neighborhoods don't overlap, then rebuilds
+    while(current.size() > targetIndexCount){
+        std::fill(triangleStart.begin(), triangleStart.end(), 0u);
+        for(auto v : current){
+            ++triangleStart[v + 1];
+        }
+        for(std::size_t v{}; v < vertexCount; ++v){
+            triangleStart[v + 1] += triangleStart[v];
+        }
+        triangleList.resize(current.size());
+        {
+            auto fill{triangleStart};
+            for(std::size_t i{}; i < current.size(); ++i){
+                triangleList[fill[current[i]]++] = static_cast<std::uint32_t>(i / 3);
+            }
+        }
+
+        collapses.clear();
+        for(std::size_t t{}; t + 2 < current.size(); t += 3){
+            for(int e{}; e < 3; ++e){
+                auto a{current[t + e]}, b{current[t + (e + 1) % 3]};
+                // the cheaper direction of the edge, only unlocked vertices move
+                Collapse best{std::numeric_limits<double>::max(), 0, 0};
+                for(auto [from, to] : {std::pair{a, b}, std::pair{b, a}}){
+                    if(locked[positionOf[from]]){
+                        continue;
+                    }
+                    auto quadric{quadrics[positionOf[from]]};
+                    quadric += quadrics[positionOf[to]];
+                    auto error{quadric.Error(glm::dvec3{positions[to]})};
+                    if(error < best.error){
+                        best = Collapse{error, from, to};
+                    }
+                }
+                if(best.error != std::numeric_limits<double>::max()){
+                    collapses.push_back(best);
+                }
+            }
+        }
+        if(collapses.empty()){
+            break;
+        }
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b){ return a.error < b.error; });
+
+        // a collapse removes about two triangles, stop near the target so the cost order stays accurate
+        auto budget{(current.size() - targetIndexCount) / 6 + 1};
+        std::fill(touched.begin(), touched.end(), false);
+        for(std::uint32_t v{}; v < vertexCount; ++v){
+            target[v] = v;
+        }
+        std::size_t applied{};
+        for(const auto& collapse : collapses){
+            if(applied == budget){
+                break;
+            }
+            auto error{std::sqrt(collapse.error) / radius};
+            if(error > targetError){
+                break;
+            }
+            auto from{collapse.from}, to{collapse.to};
+            if(touched[from] || touched[to]){
+                continue;
+            }
+            // reject collapses that fold a remaining triangle over
+            bool flips{false};
+            for(auto i{triangleStart[from]}; i < triangleStart[from + 1] && !flips; ++i){
+                const auto* triangle{&current[triangleList[i] * 3]};
+                if(triangle[0] == to || triangle[1] == to || triangle[2] == to){
+                    continue;
+                }
+                glm::vec3 corners[3], moved[3];
+                for(int c{}; c < 3; ++c){
+                    corners[c] = positions[triangle[c]];
+                    moved[c] = triangle[c] == from ? positions[to] : corners[c];
+                }
+                auto before{glm::cross(corners[1] - corners[0], corners[2] - corners[0])};
+                auto after{glm::cross(moved[1] - moved[0], moved[2] - moved[0])};
+                flips = glm::dot(before, after) <= 0.25f * glm::length(before) * glm::length(after);
+            }
+            if(flips){
+                continue;
+            }
+            // everything around from changes shape, keep it out of this pass
+            for(auto i{triangleStart[from]}; i < triangleStart[from + 1]; ++i){
+                for(int c{}; c < 3; ++c){
+                    touched[current[triangleList[i] * 3 + c]] = true;
+                }
+            }
+            touched[to] = true;
+            target[from] = to;
+            quadrics[positionOf[to]] += quadrics[positionOf[from]];
+            maxError = std::max(maxError, error);
+            ++applied;
+        }
+        if(applied == 0){
+            break;
+        }
+
+        std::size_t kept{};
+        for(std::size_t t{}; t + 2 < current.size(); t += 3){
+            auto a{target[current[t]]}, b{target[current[t + 1]]}, c{target[current[t + 2]]};
+            if(a != b && b != c && a != c){
+                current[kept++] = a;
+                current[kept++] = b;
+                current[kept++] = c;
+            }
+        }
+        current.resize(kept);
+    }
+
+    if(resultError){
+        *resultError = static_cast<float>(maxError);
+    }
+    return current;
+}
+
+std::vector<MeshOptimizer::Lod> MeshOptimizer::GenerateLods(WeldResult& mesh, std::size_t maxLods, float reduction,
+                                                             float maxError, std::size_t positionOffset)
+{
+    std::vector<Lod> lods{{0, mesh.indices.size(), 0.0f}};
+    std::vector<std::uint32_t> previous{mesh.indices};
+    float error{};
+    while(lods.size() < maxLods){
+        auto targetCount{static_cast<std::size_t>(static_cast<float>(previous.size()) * reduction) / 3 * 3};
+        float lodError{};
+        auto simplified{Simplify(previous, mesh.vertices.data(), mesh.VertexCount(), mesh.stride, targetCount,
+                                 maxError - error, &lodError, positionOffset)};
+        // levels that barely shrink only cost index memory
+        if(simplified.empty() || simplified.size() * 10 > previous.size() * 9){
+            break;
+        }
+        OptimizeVertexCache(simplified, mesh.VertexCount());
+        // each level starts from the one before, their errors add up
+        error += lodError;
+        lods.push_back(Lod{mesh.indices.size(), simplified.size(), error});
+        mesh.indices.insert(mesh.indices.end(), simplified.begin(), simplified.end());
+        previous = std::move(simplified);
+    }
+    return lods;
+}
@@ -0,0 +1,95 @@
+#ifndef MESH_OPTIMIZER_H_10192026
+#define MESH_OPTIMIZER_H_10192026
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glad/glad.h>
+
+/*
+CPU passes preparing triangle lists for the GPU, none of them touch GL so they run offline or at load time.
+Weld() turns a triangle soup into unique vertices plus a 32 bit index list, vertices are equal when
+all their bytes are, so 0.0f and -0.0f stay apart.
+PackIndices() narrows an index list to 16 bits whenever the vertex count allows it.
+AnalyzeVertexCache() replays the indices through a FIFO post-transform cache and reports how many
+vertices the GPU would shade.
+The reordering passes are meant to run in this order, Optimize() does all three:
+OptimizeVertexCache()  Forsyth's linear-speed vertex cache optimization, reorders triangles so
+                       recently shaded vertices are reused, works for any cache size
+OptimizeOverdraw()     cuts the cache optimized order into clusters where it jumped to a new region and
+                       draws outward facing clusters far from the center first, so they occlude the rest
+OptimizeVertexFetch()  renumbers vertices in order of first use, vertex fetch then walks memory forward
+Simplify() collapses edges in order of their quadric error onto one of their vertices, so coarser index
+lists reuse the same vertex buffer. Vertices on open borders and attribute seams are never moved,
+errors are relative to the radius of the mesh bounds. GenerateLods() chains Simplify() into levels of
+detail appended to the index list.
+*/
+class MeshOptimizer
+{
+public:
+    struct WeldResult
+    {
+        std::vector<std::uint8_t> vertices;     // unique vertices, interleaved with the input stride
+        std::vector<std::uint32_t> indices;
+        std::size_t stride{};
+        std::size_t originalVertexCount{};
+
+        inline std::size_t VertexCount() const { return stride != 0 ? vertices.size() / stride : 0; }
+    };
+
+    struct IndexBuffer
+    {
+        std::vector<std::uint8_t> data;
+        std::size_t count{};
+        GLenum type{GL_UNSIGNED_INT};   // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+    };
+
+    struct CacheStats
+    {
+        std::size_t indices{};
+        std::size_t hits{};
+        std::size_t misses{};   // vertex shader invocations
+        double acmr{};          // average cache miss ratio, shaded vertices per triangle, 0.5 at best
+        double atvr{};          // average transformed vertex ratio, shaded vertices per vertex, 1.0 at best
+    };
+
+    // range of mesh.indices holding one level, error relative to the bounds radius
+    struct Lod
+    {
+        std::size_t firstIndex;
+        std::size_t indexCount;
+        float error;
+    };
+
+    // typical size of the post-transform cache of current GPUs
+    static constexpr std::size_t DefaultCacheSize{16};
+
+    static WeldResult Weld(const void* vertices, std::size_t vertexCount, std::size_t stride);
+    static IndexBuffer PackIndices(const std::vector<std::uint32_t>& indices, std::size_t vertexCount);
+    static CacheStats AnalyzeVertexCache(const std::uint32_t* indices, std::size_t indexCount, std::size_t vertexCount,
+                                         std::size_t cacheSize = DefaultCacheSize);
+
+    static void OptimizeVertexCache(std::vector<std::uint32_t>& indices, std::size_t vertexCount);
+    // positions are 3 floats at positionOffset inside each vertex, clusters are merged until they hold
+    // at least minClusterTriangles so the cache order inside them survives
+    static void OptimizeOverdraw(std::vector<std::uint32_t>& indices, const void* vertices, std::size_t vertexCount,
+                                 std::size_t stride, std::size_t positionOffset = 0, std::size_t minClusterTriangles = 64);
+    // reorders vertices in place and drops unreferenced ones, returns the new vertex count
+    static std::size_t OptimizeVertexFetch(std::vector<std::uint32_t>& indices, void* vertices, std::size_t vertexCount,
+                                           std::size_t stride);
+    static void Optimize(WeldResult& mesh, std::size_t positionOffset = 0);
+
+    // stops at targetIndexCount or when the next collapse would exceed targetError
+    static std::vector<std::uint32_t> Simplify(const std::vector<std::uint32_t>& indices, const void* vertices,
+                                               std::size_t vertexCount, std::size_t stride, std::size_t targetIndexCount,
+                                               float targetError, float* resultError = nullptr, std::size_t positionOffset = 0);
+    // level 0 is the current index list, every next one aims for reduction of the triangles of the one
+    // before, the chain ends at maxLods, at maxError or when a level shrinks by less than 10%
+    static std::vector<Lod> GenerateLods(WeldResult& mesh, std::size_t maxLods, float reduction = 0.5f,
+                                         float maxError = 0.25f, std::size_t positionOffset = 0);
+
+    MeshOptimizer() = delete;
+};
+
+#endif // !MESH_OPTIMIZER_H_10192026
@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "benchmarkMeshes.h"
+#include "meshOptimizer.h"
+
+// settings
+constexpr std::size_t RINGS{400};
+constexpr std::size_t SEGMENTS{800};
+
+/*
+bytes read through a direct mapped 16KB cache of 64 byte lines per byte of vertex data shaded,
+vertices that hit the post-transform cache are not fetched again
+*/
+double Overfetch(const std::vector<std::uint32_t>& indices, std::size_t stride)
+{
+    constexpr std::size_t lineSize{64};
+    std::vector<std::size_t> lines(256, std::numeric_limits<std::size_t>::max());
+    std::vector<std::size_t> shadedAt;
+    std::size_t misses{}, loaded{};
+    for(auto index : indices){
+        if(index >= shadedAt.size()){
+            shadedAt.resize(index + 1, std::numeric_limits<std::size_t>::max());
+        }
+        if(shadedAt[index] != std::numeric_limits<std::size_t>::max() && misses - shadedAt[index] <= MeshOptimizer::DefaultCacheSize){
+            continue;
+        }
+        shadedAt[index] = misses++;
+        for(auto line{index * stride / lineSize}; line <= (index * stride + stride - 1) / lineSize; ++line){
+            auto& slot{lines[line % lines.size()]};
+            if(slot != line){
+                slot = line;
+                loaded += lineSize;
+            }
+        }
+    }
+    return misses != 0 ? static_cast<double>(loaded) / static_cast<double>(misses * stride) : 0.0;
+}
+
+/*
+Build a UV sphere of RINGS * SEGMENTS quads, shuffle its triangles and vertices the way a careless
+exporter might, then run the optimization passes one after the other and report ACMR/ATVR after each.
+The overdraw pass only moves whole clusters that start with a cache flush, so ACMR should not change.
+*/
+int main()
+{
+    auto sphere{MakeUvSphere(RINGS, SEGMENTS)};
+    auto& positions{sphere.positions};
+    auto& indices{sphere.indices};
+
+    std::mt19937 rng{5};
+    std::vector<std::uint32_t> order(indices.size() / 3);
+    std::iota(order.begin(), order.end(), 0u);
+    std::shuffle(order.begin(), order.end(), rng);
+    std::vector<std::uint32_t> remap(positions.size());
+    std::iota(remap.begin(), remap.end(), 0u);
+    std::shuffle(remap.begin(), remap.end(), rng);
+    std::vector<glm::vec3> shuffledPositions(positions.size());
+    for(std::size_t v{}; v < positions.size(); ++v){
+        shuffledPositions[remap[v]] = positions[v];
+    }
+    std::vector<std::uint32_t> shuffled;
+    for(auto triangle : order){
+        for(int corner{}; corner < 3; ++corner){
+            shuffled.push_back(remap[indices[triangle * 3 + corner]]);
+        }
+    }
+    positions = std::move(shuffledPositions);
+
+    auto report = [&](const char* pass, const std::vector<std::uint32_t>& list, std::size_t vertexCount, double milliseconds){
+        auto stats{MeshOptimizer::AnalyzeVertexCache(list.data(), list.size(), vertexCount)};
+        std::cout << pass << ": ACMR " << stats.acmr << ", ATVR " << stats.atvr << ", " << milliseconds << " ms\n";
+    };
+    std::cout << positions.size() << " vertices, " << indices.size() / 3 << " triangles, "
+        << MeshOptimizer::DefaultCacheSize << " entry FIFO cache\n";
+    report("generated order", indices, positions.size(), 0.0);
+    report("shuffled", shuffled, positions.size(), 0.0);
+
+    using clock = std::chrono::steady_clock;
+    auto start{clock::now()};
+    MeshOptimizer::OptimizeVertexCache(shuffled, positions.size());
+    report("vertex cache", shuffled, positions.size(), std::chrono::duration<double, std::milli>(clock::now() - start).count());
+
+    start = clock::now();
+    MeshOptimizer::OptimizeOverdraw(shuffled, positions.data(), positions.size(), sizeof(glm::vec3));
+    report("overdraw", shuffled, positions.size(), std::chrono::duration<double, std::milli>(clock::now() - start).count());
+
+    auto before{Overfetch(shuffled, sizeof(glm::vec3))};
+    start = clock::now();
+    auto vertexCount{MeshOptimizer::OptimizeVertexFetch(shuffled, positions.data(), positions.size(), sizeof(glm::vec3))};
+    positions.resize(vertexCount);
+    report("vertex fetch", shuffled, positions.size(), std::chrono::duration<double, std::milli>(clock::now() - start).count());
+
+    std::cout << "overfetch before reordering vertices " << before << ", after " << Overfetch(shuffled, sizeof(glm::vec3)) << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,222 @@
+#include "meshletCuller.h"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "frustumCuller.h"
+
+namespace
+{
+    enum class Visibility : std::uint8_t
+    {
+        Visible,
+        Frustum,
+        Backface
+    };
+
+    // smallest meshlet range worth a job, culling one meshlet takes a few dozen instructions
+    constexpr std::size_t GrainSize{512};
+
+    void ComputeBounds(MeshletCuller::Meshlet& meshlet, const MeshletCuller::MeshletData& data, const std::uint32_t* indices,
+                       const glm::vec3* positions)
+    {
+        // sphere around the center of the box, a little looser than the smallest one but never too small
+        glm::vec3 low{std::numeric_limits<float>::max()};
+        glm::vec3 high{std::numeric_limits<float>::lowest()};
+        for(std::uint32_t v{}; v < meshlet.vertexCount; ++v){
+            low = glm::min(low, positions[data.vertices[meshlet.vertexOffset + v]]);
+            high = glm::max(high, positions[data.vertices[meshlet.vertexOffset + v]]);
+        }
+        auto center{(low + high) * 0.5f};
+        float radius{};
+        for(std::uint32_t v{}; v < meshlet.vertexCount; ++v){
+            radius = std::max(radius, glm::length(positions[data.vertices[meshlet.vertexOffset + v]] - center));
+        }
+        meshlet.sphere = glm::vec4{center, radius};
+
+        std::vector<glm::vec3> normals;
+        normals.reserve(meshlet.triangleCount);
+        glm::vec3 axis{};
+        for(std::uint32_t t{}; t < meshlet.triangleCount; ++t){
+            const auto& a{positions[indices[t * 3 + 0]]};
+            const auto& b{positions[indices[t * 3 + 1]]};
+            const auto& c{positions[indices[t * 3 + 2]]};
+            auto normal{glm::cross(b - a, c - a)};
+            auto length{glm::length(normal)};
+            // degenerate triangles never show, their facing doesn't matter
+            if(length > 0.0f){
+                normals.push_back(normal / length);
+                axis += normals.back();
+            }
+        }
+
+        // cutoff 1 can never pass the test, dot(view, axis) is at most |view|
+        meshlet.cone = glm::vec4{0.0f, 0.0f, 1.0f, 1.0f};
+        auto axisLength{glm::length(axis)};
+        if(normals.empty() || axisLength <= 0.0f){
+            return;
+        }
+        axis /= axisLength;
+        auto minDot{1.0f};
+        for(const auto& normal : normals){
+            minDot = std::min(minDot, glm::dot(normal, axis));
+        }
+        // normals spread by more than 90 degrees from the axis face the camera from any side
+        if(minDot <= 0.0f){
+            return;
+        }
+        // every triangle faces away when the view direction is within 90 degrees minus the spread of the axis
+        meshlet.cone = glm::vec4{axis, std::sqrt(1.0f - minDot * minDot)};
+    }
+}
+
+MeshletCuller::MeshletData MeshletCuller::Build(const std::vector<std::uint32_t>& indices, const void* vertices,
+                                                std::size_t vertexCount, std::size_t stride, std::size_t positionOffset)
+{
+    assert(indices.size() % 3 == 0);
+    MeshletData data;
+
+    std::vector<glm::vec3> positions(vertexCount);
+    const auto* source{static_cast<const std::uint8_t*>(vertices)};
+    for(std::size_t v{}; v < vertexCount; ++v){
+        std::memcpy(&positions[v], source + v * stride + positionOffset, sizeof(glm::vec3));
+    }
+
+    constexpr auto unused{std::numeric_limits<std::uint8_t>::max()};
+    static_assert(MaxVertices < unused, "local vertex indices have to fit 8 bits");
+    std::vector<std::uint8_t> local(vertexCount, unused);
+    std::size_t firstIndex{};
+    Meshlet meshlet{};
+
+    auto finish = [&](std::size_t endIndex){
+        if(meshlet.triangleCount == 0){
+            return;
+        }
+        ComputeBounds(meshlet, data, indices.data() + firstIndex, positions.data());
+        for(std::uint32_t v{}; v < meshlet.vertexCount; ++v){
+            local[data.vertices[meshlet.vertexOffset + v]] = unused;
+        }
+        data.meshlets.push_back(meshlet);
+        meshlet = Meshlet{};
+        meshlet.vertexOffset = static_cast<std::uint32_t>(data.vertices.size());
+        meshlet.triangleOffset = static_cast<std::uint32_t>(data.triangles.size());
+        firstIndex = endIndex;
+    };
+
+    for(std::size_t i{}; i < indices.size(); i += 3){
+        const std::uint32_t* triangle{&indices[i]};
+        assert(triangle[0] < vertexCount && triangle[1] < vertexCount && triangle[2] < vertexCount);
+        std::uint32_t newVertices{};
+        for(int corner{}; corner < 3; ++corner){
+            // a repeated vertex in a degenerate triangle is only new once
+            if(local[triangle[corner]] == unused && (corner < 1 || triangle[corner] != triangle[0]) &&
+               (corner < 2 || triangle[corner] != triangle[1])){
+                ++newVertices;
+            }
+        }
+        if(meshlet.vertexCount + newVertices > MaxVertices || meshlet.triangleCount + 1 > MaxTriangles){
+            finish(i);
+        }
+        for(int corner{}; corner < 3; ++corner){
+            auto& slot{local[triangle[corner]]};
+            if(slot == unused){
+                slot = static_cast<std::uint8_t>(meshlet.vertexCount++);
+                data.vertices.push_back(triangle[corner]);
+            }
+            data.triangles.push_back(slot);
+        }
+        ++meshlet.triangleCount;
+    }
+    finish(indices.size());
+
+    return data;
+}
+
+MeshletCuller::Stats MeshletCuller::Cull(const MeshletData& data, const glm::mat4& model, const glm::mat4& viewProjection,
+                                         const glm::vec3& cameraPosition, std::vector<std::uint32_t>& indices, JobSystem* jobs)
+{
+    auto start{std::chrono::steady_clock::now()};
+    const auto meshletCount{data.meshlets.size()};
+
+    // mesh space planes and camera, the bounds stay untransformed
+    const auto planes{FrustumCuller::ExtractPlanes(viewProjection * model)};
+    const glm::vec3 camera{glm::inverse(model) * glm::vec4{cameraPosition, 1.0f}};
+
+    std::vector<Visibility> visibility(meshletCount);
+    auto test = [&](std::size_t begin, std::size_t end){
+        for(auto m{begin}; m < end; ++m){
+            const auto& meshlet{data.meshlets[m]};
+            const glm::vec3 center{meshlet.sphere};
+            auto result{Visibility::Visible};
+            for(const auto& plane : planes){
+                if(glm::dot(glm::vec3{plane}, center) + plane.w < -meshlet.sphere.w){
+                    result = Visibility::Frustum;
+                    break;
+                }
+            }
+            // sphere based cone test, no apex needed, conservative for the camera anywhere around the sphere
+            auto view{center - camera};
+            if(result == Visibility::Visible && meshlet.cone.w < 1.0f &&
+               glm::dot(view, glm::vec3{meshlet.cone}) >= meshlet.cone.w * glm::length(view) + meshlet.sphere.w){
+                result = Visibility::Backface;
+            }
+            visibility[m] = result;
+        }
+    };
+    if(jobs != nullptr){
+        jobs->ParallelFor(0, meshletCount, GrainSize, test);
+    }
+    else{
+        test(0, meshletCount);
+    }
+
+    // exclusive prefix sum of the visible index counts keeps the output in meshlet order
+    Stats stats{};
+    stats.meshlets = meshletCount;
+    stats.triangles = data.TriangleCount();
+    std::vector<std::uint32_t> offsets(meshletCount);
+    std::uint32_t total{};
+    for(std::size_t m{}; m < meshletCount; ++m){
+        offsets[m] = total;
+        switch(visibility[m]){
+            case Visibility::Visible:
+                total += data.meshlets[m].triangleCount * 3;
+                break;
+            case Visibility::Frustum:
+                ++stats.frustumCulled;
+                break;
+            case Visibility::Backface:
+                ++stats.backfaceCulled;
+                break;
+        }
+    }
+    stats.visibleTriangles = total / 3;
+
+    indices.resize(total);
+    auto write = [&](std::size_t begin, std::size_t end){
+        for(auto m{begin}; m < end; ++m){
+            if(visibility[m] != Visibility::Visible){
+                continue;
+            }
+            const auto& meshlet{data.meshlets[m]};
+            const auto* vertices{data.vertices.data() + meshlet.vertexOffset};
+            const auto* triangles{data.triangles.data() + meshlet.triangleOffset};
+            auto* out{indices.data() + offsets[m]};
+            for(std::uint32_t i{}; i < meshlet.triangleCount * 3; ++i){
+                out[i] = vertices[triangles[i]];
+            }
+        }
+    };
+    if(jobs != nullptr){
+        jobs->ParallelFor(0, meshletCount, GrainSize, write);
+    }
+    else{
+        write(0, meshletCount);
+    }
+
+    stats.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
@@ -0,0 +1,79 @@
+#ifndef MESHLET_CULLER_H_10192026
+#define MESHLET_CULLER_H_10192026
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "jobSystem.h"
+
+/*
+Splits a triangle list into meshlets, small clusters of at most MaxVertices vertices and MaxTriangles
+triangles, and culls them one by one instead of the whole mesh.
+Build() scans the triangles in order and starts a new meshlet whenever the next triangle would not fit,
+so the index list should be vertex cache optimized first, that order keeps neighbouring triangles together.
+Every meshlet stores its own vertex list (indices into the mesh's vertices) and three 8 bit local
+indices per triangle, plus in mesh space
+sphere  center and radius around its vertices
+cone    average facing direction and the sine of the largest angle between it and any triangle normal,
+        1 when the normals spread over more than a half sphere so it never culls
+Cull() runs in mesh space, the frustum planes are taken from viewProjection * model and the camera is
+moved by the inverse model matrix, so it holds for any model matrix without mirroring.
+A meshlet is rejected when its sphere lies behind one plane, or when the camera sees the back of every
+triangle in it, counter clockwise triangles are front facing. The indices of the remaining meshlets are
+written as one compacted 32 bit index list in meshlet order, ready to upload and draw with the mesh's
+vertices. With a JobSystem the meshlets are tested and written in parallel.
+*/
+class MeshletCuller
+{
+public:
+    static constexpr std::size_t MaxVertices{64};
+    static constexpr std::size_t MaxTriangles{124};
+
+    struct Meshlet
+    {
+        std::uint32_t vertexOffset;     // first entry in MeshletData::vertices
+        std::uint32_t triangleOffset;   // first entry in MeshletData::triangles, 3 per triangle
+        std::uint32_t vertexCount;
+        std::uint32_t triangleCount;
+        glm::vec4 sphere;               // center in xyz, radius in w
+        glm::vec4 cone;                 // unit axis in xyz, cutoff in w
+    };
+
+    struct MeshletData
+    {
+        std::vector<Meshlet> meshlets;
+        std::vector<std::uint32_t> vertices;
+        std::vector<std::uint8_t> triangles;
+
+        inline std::size_t TriangleCount() const { return triangles.size() / 3; }
+    };
+
+    struct Stats
+    {
+        std::size_t meshlets{};
+        std::size_t frustumCulled{};    // meshlets
+        std::size_t backfaceCulled{};   // meshlets
+        std::size_t triangles{};
+        std::size_t visibleTriangles{};
+        double milliseconds{};
+
+        inline std::size_t CulledTriangles() const { return triangles - visibleTriangles; }
+        // input triangles per second, 0 when the cull took no measurable time
+        inline double TrianglesPerSecond() const { return milliseconds > 0.0 ? static_cast<double>(triangles) * 1000.0 / milliseconds : 0.0; }
+    };
+
+    // positions are 3 floats at positionOffset inside each vertex
+    static MeshletData Build(const std::vector<std::uint32_t>& indices, const void* vertices, std::size_t vertexCount,
+                             std::size_t stride, std::size_t positionOffset = 0);
+
+    // replaces indices with the visible triangles, jobs spreads the work, nullptr culls on the calling thread
+    static Stats Cull(const MeshletData& data, const glm::mat4& model, const glm::mat4& viewProjection,
+                      const glm::vec3& cameraPosition, std::vector<std::uint32_t>& indices, JobSystem* jobs = nullptr);
+
+    MeshletCuller() = delete;
+};
+
+#endif // !MESHLET_CULLER_H_10192026
@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "benchmarkMeshes.h"
+#include "frustumCuller.h"
+#include "jobSystem.h"
+#include "meshletCuller.h"
+#include "meshOptimizer.h"
+
+// settings
+constexpr std::size_t RINGS{500};
+constexpr std::size_t SEGMENTS{1000};
+constexpr int ITERATIONS{10};
+constexpr unsigned int SCR_WIDTH{800};
+constexpr unsigned int SCR_HEIGHT{600};
+
+namespace
+{
+    // counts culled triangles that face the camera and touch the frustum, a conservative culler finds none
+    std::size_t CountWronglyCulled(const std::vector<std::uint32_t>& all, const std::vector<std::uint32_t>& visible,
+                                   const std::vector<glm::vec3>& positions, const std::array<glm::vec4, 6>& planes,
+                                   const glm::vec3& camera)
+    {
+        std::vector<bool> kept(all.size() / 3);
+        // the compacted list keeps whole triangles, found again by their corners
+        std::vector<std::vector<std::uint32_t>> byFirst(positions.size());
+        for(std::size_t t{}; t < all.size() / 3; ++t){
+            byFirst[all[t * 3]].push_back(static_cast<std::uint32_t>(t));
+        }
+        for(std::size_t i{}; i < visible.size(); i += 3){
+            for(auto t : byFirst[visible[i]]){
+                if(all[t * 3 + 1] == visible[i + 1] && all[t * 3 + 2] == visible[i + 2]){
+                    kept[t] = true;
+                }
+            }
+        }
+
+        std::size_t wrong{};
+        for(std::size_t t{}; t < kept.size(); ++t){
+            if(kept[t]){
+                continue;
+            }
+            const auto& a{positions[all[t * 3]]};
+            const auto& b{positions[all[t * 3 + 1]]};
+            const auto& c{positions[all[t * 3 + 2]]};
+            if(glm::dot(glm::cross(b - a, c - a), camera - a) <= 0.0f){
+                continue;
+            }
+            auto center{(a + b + c) / 3.0f};
+            auto radius{std::max({glm::length(a - center), glm::length(b - center), glm::length(c - center)})};
+            bool inside{true};
+            for(const auto& plane : planes){
+                if(glm::dot(glm::vec3{plane}, center) + plane.w < -radius){
+                    inside = false;
+                    break;
+                }
+            }
+            wrong += inside ? 1 : 0;
+        }
+        return wrong;
+    }
+}
+
+/*
+Build a UV sphere of RINGS * SEGMENTS quads, vertex cache optimize it and split it into meshlets.
+Cull the meshlets from a few cameras, far away where backface cones remove the far side of the sphere,
+close up where the frustum removes most of it and from inside where every triangle faces away, on one
+thread and on the JobSystem, and report the triangles culled and the input triangles per second.
+Every compacted index list is checked against a per triangle test for triangles culled by mistake.
+*/
+int main()
+{
+    auto sphere{MakeUvSphere(RINGS, SEGMENTS)};
+    auto& positions{sphere.positions};
+    auto& indices{sphere.indices};
+    MeshOptimizer::OptimizeVertexCache(indices, positions.size());
+
+    using clock = std::chrono::steady_clock;
+    auto start{clock::now()};
+    auto data{MeshletCuller::Build(indices, positions.data(), positions.size(), sizeof(glm::vec3))};
+    auto buildMilliseconds{std::chrono::duration<double, std::milli>(clock::now() - start).count()};
+    std::cout << positions.size() << " vertices, " << indices.size() / 3 << " triangles in " << data.meshlets.size()
+        << " meshlets, " << static_cast<double>(data.vertices.size()) / static_cast<double>(data.meshlets.size())
+        << " vertices and " << static_cast<double>(data.TriangleCount()) / static_cast<double>(data.meshlets.size())
+        << " triangles each, built in " << buildMilliseconds << " ms\n";
+
+    struct Camera
+    {
+        const char* name;
+        glm::vec3 position;
+        glm::vec3 target;
+    };
+    const Camera cameras[]{
+        {"far", glm::vec3{0.0f, 0.5f, 4.0f}, glm::vec3{0.0f}},
+        {"close", glm::vec3{0.0f, 0.0f, 1.15f}, glm::vec3{0.3f, 0.0f, 0.0f}},
+        {"inside", glm::vec3{0.0f, 0.0f, 0.2f}, glm::vec3{0.0f, 0.0f, -1.0f}}
+    };
+
+    auto projection{glm::perspective(glm::radians(45.0f), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.01f, 100.0f)};
+    const glm::mat4 model{1.0f};
+    JobSystem jobs;
+    std::vector<std::uint32_t> visible;
+    for(const auto& camera : cameras){
+        auto viewProjection{projection * glm::lookAt(camera.position, camera.target, glm::vec3{0.0f, 1.0f, 0.0f})};
+        for(auto* system : {static_cast<JobSystem*>(nullptr), &jobs}){
+            // fastest run, the first ones also warm up the caches
+            MeshletCuller::Stats best{};
+            best.milliseconds = std::numeric_limits<double>::max();
+            for(int iteration{}; iteration < ITERATIONS; ++iteration){
+                auto stats{MeshletCuller::Cull(data, model, viewProjection, camera.position, visible, system)};
+                if(stats.milliseconds < best.milliseconds){
+                    best = stats;
+                }
+            }
+            std::cout << camera.name << ", " << (system != nullptr ? jobs.GetThreadCount() : 1u) << " thread(s): "
+                << best.frustumCulled << " meshlets outside the frustum, " << best.backfaceCulled << " back facing, "
+                << best.CulledTriangles() << " of " << best.triangles << " triangles culled ("
+                << 100.0 * static_cast<double>(best.CulledTriangles()) / static_cast<double>(best.triangles) << "%), "
+                << best.milliseconds << " ms, " << best.TrianglesPerSecond() / 1e6 << " M triangles/s\n";
+        }
+        std::cout << "  wrongly culled triangles: "
+            << CountWronglyCulled(indices, visible, positions, FrustumCuller::ExtractPlanes(viewProjection), camera.position) << '\n';
+    }
+    std::cout << std::flush;
+
+    return 0;
+}
@@ -0,0 +1,194 @@
+#include "objImporter.h"
+#include <array>
+#include <charconv>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "vertexLayout.h"
+
+namespace
+{
+    struct Corner
+    {
+        long position;
+        long texCoord;
+        long normal;
+    };
+
+    inline void SkipSpaces(const char*& cursor, const char* end)
+    {
+        while(cursor != end && (*cursor == ' ' || *cursor == '\t')){
+            ++cursor;
+        }
+    }
+
+    template<std::size_t Count>
+    bool ReadFloats(const char* cursor, const char* end, std::array<float, Count>& values)
+    {
+        for(auto& value : values){
+            SkipSpaces(cursor, end);
+            auto [next, error] = std::from_chars(cursor, end, value);
+            if(error != std::errc{}){
+                return false;
+            }
+            cursor = next;
+        }
+        return true;
+    }
+
+    // a face corner is v, v/vt, v//vn or v/vt/vn, 0 marks a missing index
+    bool ReadCorner(const char*& cursor, const char* end, Corner& corner)
+    {
+        corner = Corner{};
+        long* fields[]{&corner.position, &corner.texCoord, &corner.normal};
+        for(int field{}; field < 3; ++field){
+            if(cursor != end && *cursor != '/'){
+                auto [next, error] = std::from_chars(cursor, end, *fields[field]);
+                if(error != std::errc{}){
+                    return false;
+                }
+                cursor = next;
+            }
+            if(cursor == end || *cursor != '/'){
+                break;
+            }
+            ++cursor;
+        }
+        return corner.position != 0;
+    }
+
+    // OBJ indices start at 1, negative ones count back from the last element read so far
+    inline bool Resolve(long index, std::size_t count, std::size_t& resolved)
+    {
+        if(index > 0 && static_cast<std::size_t>(index) <= count){
+            resolved = static_cast<std::size_t>(index - 1);
+            return true;
+        }
+        if(index < 0 && static_cast<std::size_t>(-index) <= count){
+            resolved = count - static_cast<std::size_t>(-index);
+            return true;
+        }
+        return false;
+    }
+}
+
+bool ObjImporter::Load(std::string_view path, MeshOptimizer::WeldResult& mesh)
+{
+    std::ifstream file{std::string{path}, std::ios::binary};
+    if(!file){
+        std::cerr << "Error: could not open " << path << std::endl;
+        return false;
+    }
+    std::stringstream text;
+    text << file.rdbuf();
+    if(!Parse(text.str(), mesh)){
+        std::cerr << "Error: " << path << " is not a valid OBJ file" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool ObjImporter::Parse(std::string_view text, MeshOptimizer::WeldResult& mesh)
+{
+    using Layout = PositionTexCoordNormalLayout;
+    static_assert(Layout::Stride == 8 * sizeof(float));
+
+    std::vector<std::array<float, 3>> positions, normals;
+    std::vector<std::array<float, 2>> texCoords;
+    std::vector<float> soup;
+    std::vector<Corner> face;
+
+    std::size_t lineStart{};
+    while(lineStart < text.size()){
+        auto lineEnd{text.find('\n', lineStart)};
+        if(lineEnd == std::string_view::npos){
+            lineEnd = text.size();
+        }
+        const char* cursor{text.data() + lineStart};
+        const char* end{text.data() + lineEnd};
+        if(end != cursor && *(end - 1) == '\r'){
+            --end;
+        }
+        lineStart = lineEnd + 1;
+
+        SkipSpaces(cursor, end);
+        if(end - cursor < 2){
+            continue;
+        }
+        if(cursor[0] == 'v' && cursor[1] == ' '){
+            std::array<float, 3> position{};
+            if(!ReadFloats(cursor + 2, end, position)){
+                return false;
+            }
+            positions.push_back(position);
+        }
+        else if(cursor[0] == 'v' && cursor[1] == 't'){
+            // the optional third texture coordinate is ignored
+            std::array<float, 2> texCoord{};
+            if(!ReadFloats(cursor + 2, end, texCoord)){
+                return false;
+            }
+            texCoords.push_back(texCoord);
+        }
+        else if(cursor[0] == 'v' && cursor[1] == 'n'){
+            std::array<float, 3> normal{};
+            if(!ReadFloats(cursor + 2, end, normal)){
+                return false;
+            }
+            normals.push_back(normal);
+        }
+        else if(cursor[0] == 'f' && cursor[1] == ' '){
+            face.clear();
+            cursor += 2;
+            SkipSpaces(cursor, end);
+            while(cursor != end){
+                Corner corner;
+                if(!ReadCorner(cursor, end, corner)){
+                    return false;
+                }
+                face.push_back(corner);
+                SkipSpaces(cursor, end);
+            }
+            if(face.size() < 3){
+                return false;
+            }
+            // fan around the first corner
+            for(std::size_t i{1}; i + 1 < face.size(); ++i){
+                for(auto* corner : {&face[0], &face[i], &face[i + 1]}){
+                    std::size_t index{};
+                    if(!Resolve(corner->position, positions.size(), index)){
+                        return false;
+                    }
+                    soup.insert(soup.end(), positions[index].begin(), positions[index].end());
+                    if(corner->texCoord != 0){
+                        if(!Resolve(corner->texCoord, texCoords.size(), index)){
+                            return false;
+                        }
+                        soup.insert(soup.end(), texCoords[index].begin(), texCoords[index].end());
+                    }
+                    else{
+                        soup.insert(soup.end(), 2, 0.0f);
+                    }
+                    if(corner->normal != 0){
+                        if(!Resolve(corner->normal, normals.size(), index)){
+                            return false;
+                        }
+                        soup.insert(soup.end(), normals[index].begin(), normals[index].end());
+                    }
+                    else{
+                        soup.insert(soup.end(), 3, 0.0f);
+                    }
+                }
+            }
+        }
+    }
+    if(soup.empty()){
+        return false;
+    }
+
+    mesh = MeshOptimizer::Weld(soup.data(), soup.size() * sizeof(float) / Layout::Stride, Layout::Stride);
+    return true;
+}
@@ -0,0 +1,24 @@
+#ifndef OBJ_IMPORTER_H_10192026
+#define OBJ_IMPORTER_H_10192026
+
+#include <string_view>
+
+#include "meshOptimizer.h"
+
+/*
+Wavefront OBJ reader for the mesh converter.
+Reads v, vt, vn and f records, faces with more than three corners are fanned into triangles and
+negative (relative) indices are resolved. Everything else (groups, materials, smoothing) is skipped.
+The result is welded into PositionTexCoordNormalLayout vertices, missing texture coordinates or
+normals are zero.
+*/
+class ObjImporter
+{
+public:
+    static bool Load(std::string_view path, MeshOptimizer::WeldResult& mesh);
+    static bool Parse(std::string_view text, MeshOptimizer::WeldResult& mesh);
+
+    ObjImporter() = delete;
+};
+
+#endif // !OBJ_IMPORTER_H_10192026
@@ -0,0 +1,195 @@
+#include "renderQueue.h"
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+#include "commandBuffer.h"
+#include "glStateCache.h"
+#include "mesh.h"
+#include "glm/gtc/type_ptr.hpp"
+
+namespace
+{
+    constexpr unsigned int PassBits{4};
+    constexpr unsigned int ProgramBits{11};
+    constexpr unsigned int MaterialBits{12};
+    constexpr unsigned int VertexArrayBits{12};
+    constexpr unsigned int DepthBits{24};
+    static_assert(PassBits + 1 + ProgramBits + MaterialBits + VertexArrayBits + DepthBits == 64, "sort key must fill 64 bits");
+
+    inline std::uint64_t Field(std::uint64_t value, unsigned int bits)
+    {
+        return value & ((std::uint64_t{1} << bits) - 1);
+    }
+}
+
+RenderQueue::RenderQueue(std::size_t capacity)
+    : m_sorted{}, m_stats{}
+{
+    m_packets.reserve(capacity);
+    m_entries.reserve(capacity);
+    m_scratch.reserve(capacity);
+}
+
+std::uint64_t RenderQueue::MakeKey(unsigned int pass, bool translucent, unsigned int program,
+                                   unsigned int material, unsigned int vertexArray, float depth)
+{
+    constexpr auto depthMax{static_cast<float>((1u << DepthBits) - 1)};
+    auto quantized{static_cast<std::uint64_t>(std::clamp(depth, 0.0f, 1.0f) * depthMax)};
+
+    auto state{Field(program, ProgramBits) << (MaterialBits + VertexArrayBits) |
+               Field(material, MaterialBits) << VertexArrayBits |
+               Field(vertexArray, VertexArrayBits)};
+    constexpr auto stateBits{ProgramBits + MaterialBits + VertexArrayBits};
+
+    auto key{Field(pass, PassBits) << 60};
+    if(translucent){
+        auto backToFront{Field((1u << DepthBits) - 1 - quantized, DepthBits)};
+        key |= std::uint64_t{1} << 59 | backToFront << stateBits | state;
+    }
+    else{
+        key |= state << DepthBits | quantized;
+    }
+    return key;
+}
+
+unsigned int RenderQueue::MaterialId(const DrawPacket& packet)
+{
+    unsigned int material{};
+    for(auto texture : packet.textures){
+        material = material * 31 + texture;
+    }
+    return material;
+}
+
+void RenderQueue::Submit(std::uint64_t key, const DrawPacket& packet)
+{
+    m_entries.push_back({key, static_cast<std::uint32_t>(m_packets.size())});
+    m_packets.push_back(packet);
+    m_sorted = false;
+}
+
+void RenderQueue::Submit(const DrawPacket& packet, float depth, unsigned int pass, bool translucent)
+{
+    unsigned int program{packet.shader ? static_cast<unsigned int>(*packet.shader) : 0u};
+    Submit(MakeKey(pass, translucent, program, MaterialId(packet), packet.vertexArray, depth), packet);
+}
+
+void RenderQueue::Submit(const CommandBuffer& commands)
+{
+    const auto& keys{commands.GetKeys()};
+    const auto& packets{commands.GetPackets()};
+    auto offset{static_cast<std::uint32_t>(m_packets.size())};
+    for(std::size_t i{}; i < keys.size(); ++i){
+        m_entries.push_back({keys[i], offset + static_cast<std::uint32_t>(i)});
+    }
+    m_packets.insert(m_packets.end(), packets.begin(), packets.end());
+    m_sorted = false;
+}
+
+void RenderQueue::Sort()
+{
+    auto start{std::chrono::steady_clock::now()};
+
+    // all eight histograms in one read of the keys
+    std::array<std::array<std::size_t, 256>, 8> histograms{};
+    for(const auto& entry : m_entries){
+        for(std::size_t digit{}; digit < histograms.size(); ++digit){
+            ++histograms[digit][(entry.key >> (digit * 8)) & 0xff];
+        }
+    }
+
+    m_scratch.resize(m_entries.size());
+    for(std::size_t digit{}; digit < histograms.size(); ++digit){
+        auto& histogram{histograms[digit]};
+        // every key has the same byte here, the pass would not move anything
+        if(std::find(histogram.begin(), histogram.end(), m_entries.size()) != histogram.end()){
+            continue;
+        }
+
+        std::size_t offset{};
+        for(auto& count : histogram){
+            auto bucketSize{count};
+            count = offset;
+            offset += bucketSize;
+        }
+        for(const auto& entry : m_entries){
+            m_scratch[histogram[(entry.key >> (digit * 8)) & 0xff]++] = entry;
+        }
+        m_entries.swap(m_scratch);
+    }
+
+    m_sorted = true;
+    m_stats.sortMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void RenderQueue::Execute()
+{
+    auto& stateCache{GLStateCache::Current()};
+    const Shader* shader{};
+    int modelLocation{-1};
+    std::array<unsigned int, DrawPacket::TextureCount> textures{};
+    auto vertexArray{std::numeric_limits<unsigned int>::max()};
+    const Mesh* mesh{};
+
+    m_stats.packets = m_entries.size();
+    m_stats.programChanges = 0;
+    m_stats.textureChanges = 0;
+    m_stats.vertexArrayChanges = 0;
+    m_stats.triangles = 0;
+    if(!m_sorted){
+        m_stats.sortMilliseconds = 0.0;
+    }
+
+    for(const auto& entry : m_entries){
+        const auto& packet{m_packets[entry.packet]};
+        if(packet.shader != shader){
+            shader = packet.shader;
+            shader->Bind();
+            modelLocation = static_cast<int>(shader->GetUniformLocation("model"));
+            ++m_stats.programChanges;
+        }
+        for(std::size_t unit{}; unit < textures.size(); ++unit){
+            if(packet.textures[unit] != 0 && packet.textures[unit] != textures[unit]){
+                textures[unit] = packet.textures[unit];
+                stateCache.BindTexture(static_cast<unsigned int>(unit), GL_TEXTURE_2D, textures[unit]);
+                ++m_stats.textureChanges;
+            }
+        }
+        if(packet.mesh != nullptr){
+            if(packet.mesh != mesh){
+                mesh = packet.mesh;
+                vertexArray = mesh->GetVertexArray();
+                mesh->Bind();
+                ++m_stats.vertexArrayChanges;
+            }
+        }
+        else if(packet.vertexArray != vertexArray || mesh != nullptr){
+            mesh = nullptr;
+            vertexArray = packet.vertexArray;
+            stateCache.BindVertexArray(vertexArray);
+            ++m_stats.vertexArrayChanges;
+        }
+
+        if(packet.mode == GL_TRIANGLES){
+            m_stats.triangles += static_cast<std::size_t>(packet.count) / 3;
+        }
+
+        glUniformMatrix4fv(modelLocation, 1, GL_FALSE, glm::value_ptr(packet.model));
+        if(packet.indexType == 0){
+            glDrawArrays(packet.mode, packet.first, packet.count);
+        }
+        else{
+            auto indexSize{packet.indexType == GL_UNSIGNED_BYTE ? 1 : packet.indexType == GL_UNSIGNED_SHORT ? 2 : 4};
+            glDrawElements(packet.mode, packet.count, packet.indexType,
+                           reinterpret_cast<void*>(static_cast<std::size_t>(packet.first) * indexSize));
+        }
+    }
+}
+
+void RenderQueue::Clear()
+{
+    m_packets.clear();
+    m_entries.clear();
+    m_sorted = false;
+}
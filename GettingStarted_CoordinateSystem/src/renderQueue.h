@@ -0,0 +1,93 @@
+#ifndef RENDER_QUEUE_H_10192026
+#define RENDER_QUEUE_H_10192026
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "shader.h"
+
+class CommandBuffer;
+class Mesh;
+
+// everything one draw call needs, indexType 0 draws arrays, anything else draws elements
+// with a mesh its Bind() replaces binding vertexArray, which should still be the mesh's for the sort key
+struct DrawPacket
+{
+    static constexpr std::size_t TextureCount{2};
+
+    const Shader* shader{};
+    std::array<unsigned int, TextureCount> textures{};   // GL_TEXTURE_2D names for units 0 and 1, 0 leaves the unit alone
+    unsigned int vertexArray{};
+    GLenum mode{GL_TRIANGLES};
+    int first{};        // first vertex, or first index for indexed draws
+    int count{};
+    GLenum indexType{};
+    glm::mat4 model{1.0f};  // uploaded to the "model" uniform
+    const Mesh* mesh{};
+};
+
+/*
+Collects draw packets for a frame and issues them ordered by a 64 bit sort key.
+Key layout, most significant bits first:
+opaque      pass:4 | 0 | program:11 | material:12 | vertex array:12 | depth:24 front to back
+translucent pass:4 | 1 | depth:24 back to front | program:11 | material:12 | vertex array:12
+so within a pass opaque draws are grouped by state and come before translucent ones, which are blended
+from far to near. The material is a hash of the packet's textures. IDs wider than their field
+only cost extra state changes, never wrong results.
+Sort() is an LSD radix sort of (key, packet index) pairs, 8 bits per pass, passes where every key
+has the same byte are skipped. Execute() issues the packets in sorted order, or in submission order
+when Sort() was not called, and only rebinds what differs from the previous packet.
+*/
+class RenderQueue
+{
+public:
+    struct Stats
+    {
+        std::size_t packets{};
+        std::size_t programChanges{};
+        std::size_t textureChanges{};
+        std::size_t vertexArrayChanges{};    // vertex array or mesh binds
+        std::size_t triangles{};             // of GL_TRIANGLES packets
+        double sortMilliseconds{};
+    };
+
+    explicit RenderQueue(std::size_t capacity = 0);
+
+    // depth is the view distance normalized to [0, 1], values outside are clamped
+    static std::uint64_t MakeKey(unsigned int pass, bool translucent, unsigned int program,
+                                 unsigned int material, unsigned int vertexArray, float depth);
+    static unsigned int MaterialId(const DrawPacket& packet);
+
+    void Submit(std::uint64_t key, const DrawPacket& packet);
+    // builds the key from the packet's shader, textures and vertex array
+    void Submit(const DrawPacket& packet, float depth, unsigned int pass = 0, bool translucent = false);
+    // appends everything another thread recorded
+    void Submit(const CommandBuffer& commands);
+
+    void Sort();
+    void Execute();
+    void Clear();
+
+    inline std::size_t Size() const { return m_packets.size(); }
+    inline const Stats& GetStats() const { return m_stats; }
+
+private:
+    struct Entry
+    {
+        std::uint64_t key;
+        std::uint32_t packet;
+    };
+
+    std::vector<DrawPacket> m_packets;
+    std::vector<Entry> m_entries;
+    std::vector<Entry> m_scratch;
+    bool m_sorted;
+    Stats m_stats;
+};
+
+#endif // !RENDER_QUEUE_H_10192026
@@ -1,4 +1,5 @@
 #include "shader.h"
+#include "glStateCache.h"
 #include <fstream>
 #include <sstream>
 
@@ -45,12 +46,12 @@ Shader::Shader(const std::initializer_list<std::basic_string_view<char>> shaderF
 
 Shader::~Shader()
 {
-    glDeleteProgram(mHandle);
+    GLStateCache::Current().DeleteProgram(mHandle);
 }
 
 void Shader::Bind() const
 {
-    glUseProgram(mHandle);
+    GLStateCache::Current().UseProgram(mHandle);
 }
 
 void Shader::Update()
@@ -132,6 +133,9 @@ unsigned int Shader::CreateShader(const std::basic_string_view<char> shaderSrc,
         case GL_FRAGMENT_SHADER:
             errorMsg = "Error compiling fragment shader!";
             break;
+        case GL_COMPUTE_SHADER:
+            errorMsg = "Error compiling compute shader!";
+            break;
         default:
             errorMsg = "Error unknown shader!";
     }
@@ -15,19 +15,21 @@ const std::map<const std::basic_string<char>, const GLenum> shaderTypes{
             {".tesc", GL_TESS_CONTROL_SHADER},
             {".tese", GL_TESS_EVALUATION_SHADER},
             {".geom", GL_GEOMETRY_SHADER},
-            {".frag", GL_FRAGMENT_SHADER}
+            {".frag", GL_FRAGMENT_SHADER},
+            {".comp", GL_COMPUTE_SHADER}
 };
 
 /*
 load and bind GLSL shaders
 const std::initializer_list<std::basic_string_view<char>> shaderFiles
-must provide a vertex file and fragment shader
+must provide a vertex file and fragment shader, or a single compute shader
 valid file extensions:
 .vert for vertex shaders
 .frag for fragment shaders
 .geom for geometry shaders
 .tesc for tessellation control shaders
 .tese for tessellation evaluation shaders
+.comp for compute shaders, linked on their own, see ComputeProgram for dispatching them
 */
 class Shader
 {
@@ -65,8 +67,6 @@ private:
     std::map<std::basic_string<char>, std::pair<GLenum, unsigned int>> mUniforms;
 };
 
-#endif  // SHADER_H
-
 template<typename uniform>
 inline void Shader::SetUniform(const std::basic_string_view<char> name, const uniform& v) const
 {
@@ -198,3 +198,5 @@ inline void Shader::SetUniformMatrix(const std::basic_string_view<char> name, co
         glUniformMatrix4x3fv(location, 1, false, glm::value_ptr(m));
     }
 }
+
+#endif  // SHADER_H
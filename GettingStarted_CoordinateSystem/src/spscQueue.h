@@ -0,0 +1,67 @@
+#ifndef SPSC_QUEUE_H_10192026
+#define SPSC_QUEUE_H_10192026
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+/*
+Bounded lock free queue for one producer thread and one consumer thread.
+All Capacity slots are allocated with the queue, Push() fails instead of growing when it is full.
+The producer owns m_tail and the consumer m_head, each only reads the other's index, with acquire/release
+so the slot contents are visible before the index that publishes them. The indices grow without wrapping
+and are masked into the slots, Capacity has to be a power of two.
+Both threads may be the same one, then it is simply a ring buffer.
+*/
+template<typename T, std::size_t Capacity>
+class SpscQueue
+{
+    static_assert(Capacity != 0 && (Capacity & (Capacity - 1)) == 0, "capacity has to be a power of two");
+
+public:
+    SpscQueue()
+        : m_head{}, m_tail{}, m_slots{}
+    {}
+
+    // producer only, false when the queue is full
+    bool Push(const T& value)
+    {
+        auto tail{m_tail.load(std::memory_order_relaxed)};
+        if(tail - m_head.load(std::memory_order_acquire) == Capacity){
+            return false;
+        }
+        m_slots[tail & (Capacity - 1)] = value;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer only, false when the queue is empty
+    bool Pop(T& value)
+    {
+        auto head{m_head.load(std::memory_order_relaxed)};
+        if(head == m_tail.load(std::memory_order_acquire)){
+            return false;
+        }
+        value = m_slots[head & (Capacity - 1)];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // exact only on the consumer or producer thread when the other is idle
+    inline std::size_t Size() const { return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire); }
+    inline bool IsEmpty() const { return Size() == 0; }
+    static constexpr std::size_t GetCapacity() { return Capacity; }
+
+    SpscQueue(const SpscQueue& other) = delete;
+    SpscQueue& operator=(const SpscQueue& other) = delete;
+    SpscQueue(SpscQueue&& other) = delete;
+    SpscQueue& operator=(SpscQueue&& other) = delete;
+
+private:
+    // on their own cache lines, producer and consumer don't invalidate each other's index
+    alignas(64) std::atomic<std::size_t> m_head;
+    alignas(64) std::atomic<std::size_t> m_tail;
+    alignas(64) std::array<T, Capacity> m_slots;
+};
+
+#endif // !SPSC_QUEUE_H_10192026
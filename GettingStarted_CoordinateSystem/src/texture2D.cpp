@@ -1,13 +1,67 @@
 #include "Texture2D.h"
+#include "glStateCache.h"
 #include <cassert>
+#include <cstring>
 #include <iostream>
 
+namespace
+{
+    // flipping here instead of stbi_set_flip_vertically_on_load keeps concurrent decodes independent
+    Texture2D::ImageData TakeImage(unsigned char* imageData, int width, int height, bool flipImage)
+    {
+        Texture2D::ImageData image;
+        if(!imageData){
+            return image;
+        }
+        image.width = width;
+        image.height = height;
+        std::size_t rowSize{static_cast<std::size_t>(width) * 4};
+        image.pixels.resize(rowSize * height);
+        for(int row{}; row < height; ++row){
+            int source{flipImage ? height - 1 - row : row};
+            std::memcpy(image.pixels.data() + rowSize * row, imageData + rowSize * source, rowSize);
+        }
+        stbi_image_free(imageData);
+        return image;
+    }
+}
+
+Texture2D::ImageData Texture2D::Decode(const std::basic_string_view<char> filename, bool flipImage)
+{
+    int width, height, components;
+    unsigned char* imageData{stbi_load(std::string{filename}.c_str(), &width, &height, &components, 4)};
+
+    if(!imageData){
+        std::cerr << "Texture loading failed: " << filename << std::endl;
+    }
+    return TakeImage(imageData, width, height, flipImage);
+}
+
+Texture2D::ImageData Texture2D::Decode(const unsigned char* data, std::size_t size, bool flipImage)
+{
+    int width, height, components;
+    unsigned char* imageData{stbi_load_from_memory(data, static_cast<int>(size), &width, &height, &components, 4)};
+
+    if(!imageData){
+        std::cerr << "Texture decoding failed: " << stbi_failure_reason() << std::endl;
+    }
+    return TakeImage(imageData, width, height, flipImage);
+}
+
 Texture2D::Texture2D(const std::basic_string_view<char> filename,
                      bool flipImage,
                      GLenum wrapSStyle,
                      GLenum wrapTStyle,
                      GLenum minFilterStyle,
                      GLenum magFilterStyle)
+    : Texture2D{Decode(filename, flipImage), wrapSStyle, wrapTStyle, minFilterStyle, magFilterStyle}
+{}
+
+Texture2D::Texture2D(const ImageData& image,
+                     GLenum wrapSStyle,
+                     GLenum wrapTStyle,
+                     GLenum minFilterStyle,
+                     GLenum magFilterStyle)
     : mTexture{}
 {
     assert(wrapSStyle == GL_CLAMP_TO_EDGE || wrapSStyle == GL_CLAMP_TO_BORDER || 
@@ -21,41 +75,36 @@ Texture2D::Texture2D(const std::basic_string_view<char> filename,
            minFilterStyle == GL_NEAREST_MIPMAP_LINEAR || minFilterStyle == GL_LINEAR_MIPMAP_LINEAR);
     assert(magFilterStyle == GL_NEAREST || magFilterStyle == GL_LINEAR);
 
-    // load image, create texture and generate mipmaps
-    stbi_set_flip_vertically_on_load(flipImage); // tell stb_image.h to flip loaded texture's on the y-axis.
-
-    int width, height, components;
-    unsigned char* imageData{stbi_load(filename.data(), &width, &height, &components, 4)};
-
-    if(!imageData){
-        std::cerr << "Texture loading failed: " << filename << std::endl;
-    }
-
+    // create texture and generate mipmaps
     glGenTextures(1, &mTexture);
-    glBindTexture(GL_TEXTURE_2D, mTexture);
+    GLStateCache::Current().BindTexture(0, GL_TEXTURE_2D, mTexture);
 
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrapSStyle);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrapTStyle);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilterStyle);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilterStyle);
 
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, imageData);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image.width, image.height, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                 image.IsValid() ? image.pixels.data() : nullptr);
 
     glGenerateMipmap(GL_TEXTURE_2D);
 
-    stbi_image_free(imageData);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    GLStateCache::Current().BindTexture(0, GL_TEXTURE_2D, 0);
 }
 
 Texture2D::~Texture2D()
 {
-    glDeleteTextures(1, &mTexture);
+    GLStateCache::Current().DeleteTexture(mTexture);
 }
 
 void Texture2D::Bind(unsigned int unit)
 {
     assert(unit >= 0 && unit <= 15);
 
-    glActiveTexture(GL_TEXTURE0 + unit);
-    glBindTexture(GL_TEXTURE_2D, mTexture);
+    GLStateCache::Current().BindTexture(unit, GL_TEXTURE_2D, mTexture);
+}
+
+Texture2D::operator unsigned int() const
+{
+    return mTexture;
 }
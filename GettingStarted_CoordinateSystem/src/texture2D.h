@@ -1,7 +1,9 @@
 #ifndef TEXTURE2D_H
 #define TEXTURE2D_H
 
+#include <cstddef>
 #include <string>
+#include <vector>
 
 #include <glad/glad.h>
 #include <SOIL2/stb_image.h>
@@ -14,21 +16,43 @@ GLenum wrapSStyle = GLREPEAT, is filter for GL_TEXTURE_WRAP_S
 GLenum wrapTStyle = GLREPEAT, is filter for GL_TEXTURE_WRAP_T
 GLenum minFilterStyle = GL_NEAREST_MIPMAP_LINEAR, is filter for GL_TEXTURE_MIN_FILTER
 GLenum magFilterStyle = GL_LINEAR, is filter for GL_TEXTURE_MAG_FILTER
+
+Decode() only runs stb_image into RGBA8 memory and touches no GL or global stb state, so loaders
+can call it from worker threads and create the texture from the ImageData on the GL thread later.
 */
 class Texture2D
 {
 public:
+    struct ImageData
+    {
+        int width{};
+        int height{};
+        std::vector<unsigned char> pixels;  // RGBA8, rows bottom up when flipped
+
+        inline bool IsValid() const { return !pixels.empty(); }
+    };
+
+    static ImageData Decode(const std::basic_string_view<char> filename, bool flipImage = false);
+    static ImageData Decode(const unsigned char* data, std::size_t size, bool flipImage = false);
+
     explicit Texture2D(const std::basic_string_view<char> filename,
                        bool flipImage = false,
                        GLenum wrapSStyle = GL_REPEAT,
                        GLenum wrapTStyle = GL_REPEAT,
                        GLenum minFilterStyle = GL_NEAREST_MIPMAP_LINEAR,
                        GLenum magFilterStyle = GL_LINEAR);
+    explicit Texture2D(const ImageData& image,
+                       GLenum wrapSStyle = GL_REPEAT,
+                       GLenum wrapTStyle = GL_REPEAT,
+                       GLenum minFilterStyle = GL_NEAREST_MIPMAP_LINEAR,
+                       GLenum magFilterStyle = GL_LINEAR);
 
     virtual ~Texture2D();
 
     void Bind(unsigned int unit);
 
+    operator unsigned int() const;
+
     Texture2D() = delete;
     Texture2D(const Texture2D& other) = delete;
     Texture2D(Texture2D&& other) = delete;
@@ -0,0 +1,59 @@
+#include "vertexArrayCache.h"
+#include <algorithm>
+
+#include "glStateCache.h"
+
+VertexArrayCache::~VertexArrayCache()
+{
+    auto& stateCache{GLStateCache::Current()};
+    for(auto& [key, entry] : m_vertexArrays){
+        stateCache.DeleteVertexArray(entry.vertexArray.name);
+    }
+}
+
+VertexArrayCache::VertexArray& VertexArrayCache::Get(const VertexLayoutDescriptor& layout, VertexStorage storage)
+{
+    auto key{layout.key ^ (storage == VertexStorage::Deinterleaved ? 0x9e3779b97f4a7c15ull : 0ull)};
+    // the key is only a hash, compare the formats so two layouts can never share by accident
+    auto [first, last] = m_vertexArrays.equal_range(key);
+    for(auto it{first}; it != last; ++it){
+        auto& entry{it->second};
+        if(entry.storage == storage && std::ranges::equal(entry.attributes, layout.attributes)){
+            ++m_stats.hits;
+            return entry.vertexArray;
+        }
+    }
+
+    ++m_stats.misses;
+    Entry entry{{layout.attributes.begin(), layout.attributes.end()}, storage, {Create(layout, storage), nullptr}};
+    return m_vertexArrays.emplace(key, std::move(entry))->second.vertexArray;
+}
+
+unsigned int VertexArrayCache::Create(const VertexLayoutDescriptor& layout, VertexStorage storage)
+{
+    auto& stateCache{GLStateCache::Current()};
+    unsigned int vertexArray{};
+    glGenVertexArrays(1, &vertexArray);
+    stateCache.BindVertexArray(vertexArray);
+
+    const bool interleaved{storage == VertexStorage::Interleaved};
+    for(std::size_t i{}; i < layout.attributes.size(); ++i){
+        const auto& attribute{layout.attributes[i]};
+        // interleaved attributes share binding 0 at their offset, streams start at their own binding
+        auto relativeOffset{interleaved ? attribute.offset : 0u};
+        auto binding{interleaved ? 0u : static_cast<unsigned int>(i)};
+
+        glEnableVertexAttribArray(attribute.location);
+        if(attribute.mode == AttributeMode::Integer){
+            glVertexAttribIFormat(attribute.location, attribute.components, attribute.type, relativeOffset);
+        }
+        else{
+            glVertexAttribFormat(attribute.location, attribute.components, attribute.type,
+                                 attribute.mode == AttributeMode::Normalized, relativeOffset);
+        }
+        glVertexAttribBinding(attribute.location, binding);
+    }
+
+    stateCache.BindVertexArray(0);
+    return vertexArray;
+}
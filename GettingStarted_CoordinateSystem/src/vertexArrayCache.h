@@ -0,0 +1,72 @@
+#ifndef VERTEX_ARRAY_CACHE_H_10192026
+#define VERTEX_ARRAY_CACHE_H_10192026
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "vertexLayout.h"
+
+class Mesh;
+
+// interleaved reads every attribute from one buffer binding, deinterleaved gives each attribute its own stream
+enum class VertexStorage
+{
+    Interleaved,
+    Deinterleaved
+};
+
+/*
+One vertex array per vertex layout and storage, shared by every Mesh using that layout.
+With separate attribute formats (glVertexAttribFormat / glVertexAttribBinding) the vertex array only
+describes the format, the buffers come from glBindVertexBuffer, so switching between meshes of the
+same layout rebinds buffers instead of vertex arrays.
+Each vertex array remembers the mesh whose buffers are attached, binding that mesh again is free.
+The cache deletes its vertex arrays, it has to outlive the meshes and be destroyed while the context is current.
+*/
+class VertexArrayCache
+{
+public:
+    struct VertexArray
+    {
+        unsigned int name{};
+        const Mesh* attached{};     // mesh whose vertex and index buffers are bound to it
+    };
+
+    struct Stats
+    {
+        std::size_t hits{};
+        std::size_t misses{};
+    };
+
+    VertexArrayCache() = default;
+    ~VertexArrayCache();
+
+    // the shared vertex array for layout and storage, created the first time it is asked for
+    VertexArray& Get(const VertexLayoutDescriptor& layout, VertexStorage storage);
+
+    inline std::size_t Size() const { return m_vertexArrays.size(); }
+    inline const Stats& GetStats() const { return m_stats; }
+
+    VertexArrayCache(const VertexArrayCache&) = delete;
+    VertexArrayCache(VertexArrayCache&&) = delete;
+    VertexArrayCache& operator=(const VertexArrayCache&) = delete;
+    VertexArrayCache& operator=(VertexArrayCache&&) = delete;
+
+private:
+    struct Entry
+    {
+        std::vector<AttributeFormat> attributes;
+        VertexStorage storage;
+        VertexArray vertexArray;
+    };
+
+    static unsigned int Create(const VertexLayoutDescriptor& layout, VertexStorage storage);
+
+    // node based, references to the entries stay valid while the cache grows
+    std::unordered_multimap<std::uint64_t, Entry> m_vertexArrays;
+    Stats m_stats{};
+};
+
+#endif // !VERTEX_ARRAY_CACHE_H_10192026
@@ -0,0 +1,144 @@
+#ifndef VERTEX_LAYOUT_H_10192026
+#define VERTEX_LAYOUT_H_10192026
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include <glad/glad.h>
+
+// how the vertex shader reads an attribute: as float, as normalized fixed point, or as integer
+enum class AttributeMode
+{
+    Float,
+    Normalized,
+    Integer
+};
+
+// one attribute of a layout, offset is where it starts inside an interleaved vertex
+struct AttributeFormat
+{
+    unsigned int location{};
+    GLenum type{};
+    int components{};
+    AttributeMode mode{};
+    unsigned int size{};    // bytes per vertex
+    unsigned int offset{};
+
+    constexpr bool operator==(const AttributeFormat&) const = default;
+};
+
+// runtime view of a VertexLayout, what Mesh and VertexArrayCache work with
+struct VertexLayoutDescriptor
+{
+    std::span<const AttributeFormat> attributes;
+    unsigned int stride{};
+    std::uint64_t key{};
+};
+
+constexpr unsigned int AttributeSize(GLenum type, int components)
+{
+    switch(type){
+        case GL_BYTE:
+        case GL_UNSIGNED_BYTE:
+            return components;
+        case GL_SHORT:
+        case GL_UNSIGNED_SHORT:
+        case GL_HALF_FLOAT:
+            return 2 * components;
+        // packed formats hold all components in one 32 bit word
+        case GL_INT_2_10_10_10_REV:
+        case GL_UNSIGNED_INT_2_10_10_10_REV:
+        case GL_UNSIGNED_INT_10F_11F_11F_REV:
+            return 4;
+        case GL_DOUBLE:
+            return 8 * components;
+        default:
+            return 4 * components;
+    }
+}
+
+/*
+attribute of a VertexLayout, e.g. Attribute<GL_FLOAT, 3> for a vec3 position
+or Attribute<GL_UNSIGNED_SHORT, 2, AttributeMode::Normalized> for unorm16 texture coordinates
+*/
+template<GLenum Type, int Components, AttributeMode Mode = AttributeMode::Float>
+struct Attribute
+{
+    static_assert(Components >= 1 && Components <= 4, "an attribute has 1 to 4 components");
+    static_assert(Mode != AttributeMode::Integer || (Type != GL_FLOAT && Type != GL_HALF_FLOAT && Type != GL_DOUBLE),
+                  "integer attributes need an integer type");
+
+    static constexpr GLenum type{Type};
+    static constexpr int components{Components};
+    static constexpr AttributeMode mode{Mode};
+    static constexpr unsigned int size{AttributeSize(Type, Components)};
+};
+
+namespace VertexLayoutDetail
+{
+    // attributes start on 4 byte boundaries, unaligned vertex fetch is slow or unsupported on some GPUs
+    constexpr unsigned int Align(unsigned int size)
+    {
+        return (size + 3u) & ~3u;
+    }
+
+    template<typename... Attributes>
+    constexpr std::array<AttributeFormat, sizeof...(Attributes)> MakeFormats()
+    {
+        std::array<AttributeFormat, sizeof...(Attributes)> formats{};
+        unsigned int location{};
+        unsigned int offset{};
+        ((formats[location] = AttributeFormat{location, Attributes::type, Attributes::components,
+                                              Attributes::mode, Attributes::size, offset},
+          offset += Align(Attributes::size), ++location), ...);
+        return formats;
+    }
+
+    // FNV-1a over everything that ends up in the vertex array state
+    constexpr std::uint64_t MakeKey(std::span<const AttributeFormat> formats)
+    {
+        std::uint64_t hash{14695981039346656037ull};
+        auto mix = [&hash](std::uint64_t value){
+            hash = (hash ^ value) * 1099511628211ull;
+        };
+        for(const auto& format : formats){
+            mix(format.location);
+            mix(format.type);
+            mix(static_cast<std::uint64_t>(format.components));
+            mix(static_cast<std::uint64_t>(format.mode));
+            mix(format.offset);
+        }
+        return hash;
+    }
+}
+
+/*
+Vertex format declared at compile time, attribute i is read from shader location i.
+Offsets, stride and the key identifying the layout are all computed by the compiler, so
+static_assert(Layout::Stride == sizeof(Vertex)) catches a vertex struct drifting from its layout.
+Descriptor() is the runtime view handed to Mesh.
+*/
+template<typename... Attributes>
+struct VertexLayout
+{
+    static_assert(sizeof...(Attributes) > 0, "a vertex layout needs at least one attribute");
+
+    static constexpr std::size_t AttributeCount{sizeof...(Attributes)};
+    static constexpr std::array<AttributeFormat, AttributeCount> Formats{VertexLayoutDetail::MakeFormats<Attributes...>()};
+    static constexpr unsigned int Stride{(VertexLayoutDetail::Align(Attributes::size) + ...)};
+    static constexpr std::uint64_t Key{VertexLayoutDetail::MakeKey(std::span<const AttributeFormat>{Formats})};
+
+    static constexpr VertexLayoutDescriptor Descriptor()
+    {
+        return VertexLayoutDescriptor{Formats, Stride, Key};
+    }
+};
+
+// layout of the textured cube samples, vec3 position and vec2 texture coordinates
+using PositionTexCoordLayout = VertexLayout<Attribute<GL_FLOAT, 3>, Attribute<GL_FLOAT, 2>>;
+// imported meshes, the normal at location 2 is ignored by shaders that don't declare it
+using PositionTexCoordNormalLayout = VertexLayout<Attribute<GL_FLOAT, 3>, Attribute<GL_FLOAT, 2>, Attribute<GL_FLOAT, 3>>;
+
+#endif // !VERTEX_LAYOUT_H_10192026
@@ -0,0 +1,224 @@
+#include "vertexQuantizer.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace
+{
+    inline glm::vec3 ReadVec3(const std::uint8_t* source)
+    {
+        float xyz[3];
+        std::memcpy(xyz, source, sizeof(xyz));
+        return glm::vec3{xyz[0], xyz[1], xyz[2]};
+    }
+
+    inline glm::vec2 ReadVec2(const std::uint8_t* source)
+    {
+        float xy[2];
+        std::memcpy(xy, source, sizeof(xy));
+        return glm::vec2{xy[0], xy[1]};
+    }
+
+    inline float SignNotZero(float value)
+    {
+        return value >= 0.0f ? 1.0f : -1.0f;
+    }
+
+    // octahedral projection of a unit vector onto the [-1, 1] square
+    inline glm::vec2 Octahedral(const glm::vec3& normal)
+    {
+        auto n{normal / (std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z))};
+        glm::vec2 e{n.x, n.y};
+        if(n.z < 0.0f){
+            e = glm::vec2{(1.0f - std::abs(n.y)) * SignNotZero(n.x), (1.0f - std::abs(n.x)) * SignNotZero(n.y)};
+        }
+        return e;
+    }
+
+    // the layouts share their position and texture coordinate offsets
+    static_assert(QuantizedPositionTexCoordLayout::Formats[1].offset == HalfPositionTexCoordLayout::Formats[1].offset);
+    static_assert(QuantizedPositionTexCoordLayout::Formats[1].offset == QuantizedPositionTexCoordNormalLayout::Formats[1].offset);
+}
+
+glm::mat4 VertexQuantizer::PositionTransform::Matrix() const
+{
+    return glm::scale(glm::translate(glm::mat4{1.0f}, bias), scale);
+}
+
+VertexQuantizer::QuantizedMesh VertexQuantizer::Quantize(const void* vertices, std::size_t vertexCount, std::size_t stride,
+                                                         std::size_t positionOffset, std::size_t texCoordOffset,
+                                                         std::size_t normalOffset, PositionFormat format)
+{
+    const auto* source{static_cast<const std::uint8_t*>(vertices)};
+    const bool normals{normalOffset != NoAttribute};
+    QuantizedMesh mesh;
+    mesh.stride = normals ? QuantizedPositionTexCoordNormalLayout::Stride
+                          : format == PositionFormat::Snorm16 ? QuantizedPositionTexCoordLayout::Stride
+                                                              : HalfPositionTexCoordLayout::Stride;
+    assert(!normals || format == PositionFormat::Snorm16);
+    constexpr auto texCoordTarget{QuantizedPositionTexCoordLayout::Formats[1].offset};
+    constexpr auto normalTarget{QuantizedPositionTexCoordNormalLayout::Formats[2].offset};
+    if(vertexCount == 0){
+        return mesh;
+    }
+
+    // map the bounds onto [-1, 1] per axis, flat axes keep a scale of 1 so nothing divides by zero
+    glm::vec3 minimum{std::numeric_limits<float>::max()}, maximum{std::numeric_limits<float>::lowest()};
+    for(std::size_t v{}; v < vertexCount; ++v){
+        auto position{ReadVec3(source + v * stride + positionOffset)};
+        minimum = glm::min(minimum, position);
+        maximum = glm::max(maximum, position);
+    }
+    mesh.transform.bias = (minimum + maximum) * 0.5f;
+    mesh.transform.scale = (maximum - minimum) * 0.5f;
+    for(int axis{}; axis < 3; ++axis){
+        if(mesh.transform.scale[axis] <= 0.0f){
+            mesh.transform.scale[axis] = 1.0f;
+        }
+    }
+
+    mesh.vertices.resize(vertexCount * mesh.stride);
+    double squaredError{};
+    for(std::size_t v{}; v < vertexCount; ++v){
+        const auto* vertex{source + v * stride};
+        auto* destination{mesh.vertices.data() + v * mesh.stride};
+
+        auto position{ReadVec3(vertex + positionOffset)};
+        auto local{(position - mesh.transform.bias) / mesh.transform.scale};
+        std::array<std::uint16_t, 3> packed{};
+        glm::vec3 decoded{};
+        for(int axis{}; axis < 3; ++axis){
+            if(format == PositionFormat::Snorm16){
+                auto value{ToSnorm16(local[axis])};
+                packed[axis] = static_cast<std::uint16_t>(value);
+                decoded[axis] = FromSnorm16(value);
+            }
+            else{
+                packed[axis] = ToHalf(local[axis]);
+                decoded[axis] = FromHalf(packed[axis]);
+            }
+        }
+        std::memcpy(destination, packed.data(), sizeof(packed));
+        auto positionError{glm::length(decoded * mesh.transform.scale + mesh.transform.bias - position)};
+        mesh.error.maxPosition = std::max(mesh.error.maxPosition, positionError);
+        squaredError += static_cast<double>(positionError) * positionError;
+
+        auto texCoord{ReadVec2(vertex + texCoordOffset)};
+        std::array<std::uint16_t, 2> texCoordPacked{ToUnorm16(texCoord.x), ToUnorm16(texCoord.y)};
+        std::memcpy(destination + texCoordTarget, texCoordPacked.data(), sizeof(texCoordPacked));
+        glm::vec2 texCoordDecoded{FromUnorm16(texCoordPacked[0]), FromUnorm16(texCoordPacked[1])};
+        mesh.error.maxTexCoord = std::max(mesh.error.maxTexCoord, glm::length(texCoordDecoded - texCoord));
+
+        if(normals){
+            auto normal{glm::normalize(ReadVec3(vertex + normalOffset))};
+            auto encoded{EncodeOctahedral(normal)};
+            std::memcpy(destination + normalTarget, encoded.data(), sizeof(encoded));
+            auto cosine{std::clamp(glm::dot(DecodeOctahedral(encoded), normal), -1.0f, 1.0f)};
+            mesh.error.maxNormalDegrees = std::max(mesh.error.maxNormalDegrees, glm::degrees(std::acos(cosine)));
+        }
+    }
+    mesh.error.rmsPosition = static_cast<float>(std::sqrt(squaredError / static_cast<double>(vertexCount)));
+    return mesh;
+}
+
+std::int16_t VertexQuantizer::ToSnorm16(float value)
+{
+    return static_cast<std::int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+float VertexQuantizer::FromSnorm16(std::int16_t value)
+{
+    return std::max(static_cast<float>(value) / 32767.0f, -1.0f);
+}
+
+std::uint16_t VertexQuantizer::ToUnorm16(float value)
+{
+    return static_cast<std::uint16_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 65535.0f));
+}
+
+float VertexQuantizer::FromUnorm16(std::uint16_t value)
+{
+    return static_cast<float>(value) / 65535.0f;
+}
+
+std::uint16_t VertexQuantizer::ToHalf(float value)
+{
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const auto sign{static_cast<std::uint16_t>((bits >> 16) & 0x8000u)};
+    const auto magnitude{bits & 0x7fffffffu};
+
+    if(magnitude >= 0x7f800000u){
+        // infinity stays infinity, NaN stays a quiet NaN
+        return sign | 0x7c00u | (magnitude > 0x7f800000u ? 0x0200u : 0u);
+    }
+    if(magnitude >= 0x477ff000u){
+        // 65520 and up round past the largest half
+        return sign | 0x7c00u;
+    }
+    if(magnitude < 0x38800000u){
+        // below the smallest normal half, the result is a multiple of 2^-24
+        float absolute;
+        std::memcpy(&absolute, &magnitude, sizeof(absolute));
+        return sign | static_cast<std::uint16_t>(std::nearbyint(absolute * 16777216.0f));
+    }
+    // rebias the exponent from 127 to 15 and round the 13 dropped mantissa bits to nearest even,
+    // a carry out of the mantissa correctly bumps the exponent
+    auto half{(magnitude - 0x38000000u) >> 13};
+    auto dropped{magnitude & 0x1fffu};
+    if(dropped > 0x1000u || (dropped == 0x1000u && (half & 1u))){
+        ++half;
+    }
+    return sign | static_cast<std::uint16_t>(half);
+}
+
+float VertexQuantizer::FromHalf(std::uint16_t value)
+{
+    const std::uint32_t sign{(value & 0x8000u) << 16};
+    const std::uint32_t exponent{(value >> 10) & 0x1fu};
+    const std::uint32_t mantissa{value & 0x3ffu};
+    if(exponent == 0){
+        auto magnitude{std::ldexp(static_cast<float>(mantissa), -24)};
+        return sign ? -magnitude : magnitude;
+    }
+    auto bits{exponent == 0x1fu ? sign | 0x7f800000u | (mantissa << 13)
+                                : sign | ((exponent + 112u) << 23) | (mantissa << 13)};
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+std::array<std::int16_t, 2> VertexQuantizer::EncodeOctahedral(const glm::vec3& normal)
+{
+    // rounding each component on its own is not always closest after decoding,
+    // try the four neighbouring codes and keep the best one
+    auto e{Octahedral(normal)};
+    std::array<std::int16_t, 2> best{ToSnorm16(e.x), ToSnorm16(e.y)};
+    float bestCosine{-2.0f};
+    for(int i{}; i < 4; ++i){
+        auto x{(i & 1) ? std::ceil(e.x * 32767.0f) : std::floor(e.x * 32767.0f)};
+        auto y{(i & 2) ? std::ceil(e.y * 32767.0f) : std::floor(e.y * 32767.0f)};
+        std::array<std::int16_t, 2> candidate{static_cast<std::int16_t>(std::clamp(x, -32767.0f, 32767.0f)),
+                                              static_cast<std::int16_t>(std::clamp(y, -32767.0f, 32767.0f))};
+        auto cosine{glm::dot(DecodeOctahedral(candidate), normal)};
+        if(cosine > bestCosine){
+            bestCosine = cosine;
+            best = candidate;
+        }
+    }
+    return best;
+}
+
+glm::vec3 VertexQuantizer::DecodeOctahedral(const std::array<std::int16_t, 2>& encoded)
+{
+    glm::vec2 e{FromSnorm16(encoded[0]), FromSnorm16(encoded[1])};
+    glm::vec3 n{e.x, e.y, 1.0f - std::abs(e.x) - std::abs(e.y)};
+    if(n.z < 0.0f){
+        n.x = (1.0f - std::abs(e.y)) * SignNotZero(e.x);
+        n.y = (1.0f - std::abs(e.x)) * SignNotZero(e.y);
+    }
+    return glm::normalize(n);
+}
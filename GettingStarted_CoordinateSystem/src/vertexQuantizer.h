@@ -0,0 +1,93 @@
+#ifndef VERTEX_QUANTIZER_H_10192026
+#define VERTEX_QUANTIZER_H_10192026
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "vertexLayout.h"
+
+// snorm16 or half float positions, unorm16 texture coordinates, 12 bytes instead of 20
+using QuantizedPositionTexCoordLayout = VertexLayout<Attribute<GL_SHORT, 3, AttributeMode::Normalized>,
+                                                     Attribute<GL_UNSIGNED_SHORT, 2, AttributeMode::Normalized>>;
+using HalfPositionTexCoordLayout = VertexLayout<Attribute<GL_HALF_FLOAT, 3>,
+                                                Attribute<GL_UNSIGNED_SHORT, 2, AttributeMode::Normalized>>;
+// same with an octahedral snorm16 normal at location 2, 16 bytes instead of 32
+using QuantizedPositionTexCoordNormalLayout = VertexLayout<Attribute<GL_SHORT, 3, AttributeMode::Normalized>,
+                                                           Attribute<GL_UNSIGNED_SHORT, 2, AttributeMode::Normalized>,
+                                                           Attribute<GL_SHORT, 2, AttributeMode::Normalized>>;
+
+/*
+Packs float vertex attributes into the compact formats above, the GPU expands them while fetching.
+Positions are stored relative to the mesh bounds, p = stored * scale + bias with stored in [-1, 1],
+PositionTransform::Matrix() undoes that and is meant to be multiplied into the model matrix,
+so shaders reading plain vec3 positions keep working.
+Texture coordinates have to lie in [0, 1], values outside are clamped.
+Normals use the octahedral mapping (Cigolle et al., "A Survey of Efficient Representations for
+Independent Unit Vectors"), the shader decodes them with
+    vec3 n = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+    if(n.z < 0.0) n.xy = (1.0 - abs(n.yx)) * sign(n.xy);
+    n = normalize(n);
+Quantize() reports the largest error each attribute picked up so a format can be checked against
+the precision a mesh needs.
+*/
+class VertexQuantizer
+{
+public:
+    enum class PositionFormat
+    {
+        Snorm16,
+        Half
+    };
+
+    struct PositionTransform
+    {
+        glm::vec3 scale{1.0f};
+        glm::vec3 bias{};
+
+        glm::mat4 Matrix() const;
+    };
+
+    struct Error
+    {
+        float maxPosition{};        // object space units
+        float rmsPosition{};
+        float maxTexCoord{};
+        float maxNormalDegrees{};
+    };
+
+    struct QuantizedMesh
+    {
+        std::vector<std::uint8_t> vertices;     // in one of the layouts above, chosen by format and normals
+        std::size_t stride{};
+        PositionTransform transform;
+        Error error;
+    };
+
+    static constexpr std::size_t NoAttribute{std::numeric_limits<std::size_t>::max()};
+
+    // float vec3 positions, vec2 texture coordinates and optional vec3 normals at the given byte offsets
+    static QuantizedMesh Quantize(const void* vertices, std::size_t vertexCount, std::size_t stride,
+                                  std::size_t positionOffset, std::size_t texCoordOffset,
+                                  std::size_t normalOffset = NoAttribute,
+                                  PositionFormat format = PositionFormat::Snorm16);
+
+    // conversions follow the GL rules for normalized fixed point, snorm decodes max(c / 32767, -1)
+    static std::int16_t ToSnorm16(float value);
+    static float FromSnorm16(std::int16_t value);
+    static std::uint16_t ToUnorm16(float value);
+    static float FromUnorm16(std::uint16_t value);
+    // round to nearest even, overflow becomes infinity
+    static std::uint16_t ToHalf(float value);
+    static float FromHalf(std::uint16_t value);
+    static std::array<std::int16_t, 2> EncodeOctahedral(const glm::vec3& normal);
+    static glm::vec3 DecodeOctahedral(const std::array<std::int16_t, 2>& encoded);
+
+    VertexQuantizer() = delete;
+};
+
+#endif // !VERTEX_QUANTIZER_H_10192026
@@ -0,0 +1,73 @@
+#include <chrono>
+#include <cstddef>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "vertexQuantizer.h"
+
+// settings
+constexpr std::size_t VERTEX_COUNT{1'000'000};
+constexpr float MESH_RADIUS{25.0f};
+
+struct Vertex
+{
+    glm::vec3 position;
+    glm::vec2 texCoord;
+    glm::vec3 normal;
+};
+
+/*
+Quantize VERTEX_COUNT random points on a sphere of MESH_RADIUS units in every supported format,
+report the bytes per vertex, the error each attribute picked up and how fast the CPU packs them.
+*/
+int main()
+{
+    std::mt19937 rng{5};
+    std::normal_distribution<float> gaussian;
+    std::uniform_real_distribution<float> unit{0.0f, 1.0f};
+    std::vector<Vertex> vertices(VERTEX_COUNT);
+    for(auto& vertex : vertices){
+        vertex.normal = glm::normalize(glm::vec3{gaussian(rng), gaussian(rng), gaussian(rng)});
+        vertex.position = vertex.normal * MESH_RADIUS;
+        vertex.texCoord = glm::vec2{unit(rng), unit(rng)};
+    }
+
+    struct Run
+    {
+        const char* name;
+        VertexQuantizer::PositionFormat format;
+        bool normals;
+    };
+    const Run runs[]{
+        {"snorm16 position, unorm16 uv", VertexQuantizer::PositionFormat::Snorm16, false},
+        {"half position, unorm16 uv", VertexQuantizer::PositionFormat::Half, false},
+        {"snorm16 position, unorm16 uv, octahedral normal", VertexQuantizer::PositionFormat::Snorm16, true}
+    };
+
+    std::cout << VERTEX_COUNT << " vertices on a sphere of radius " << MESH_RADIUS << "\n";
+    using clock = std::chrono::steady_clock;
+    for(const auto& run : runs){
+        auto start{clock::now()};
+        auto mesh{VertexQuantizer::Quantize(vertices.data(), vertices.size(), sizeof(Vertex),
+                                            offsetof(Vertex, position), offsetof(Vertex, texCoord),
+                                            run.normals ? offsetof(Vertex, normal) : VertexQuantizer::NoAttribute, run.format)};
+        auto milliseconds{std::chrono::duration<double, std::milli>(clock::now() - start).count()};
+
+        auto floatBytes{run.normals ? sizeof(Vertex) : sizeof(glm::vec3) + sizeof(glm::vec2)};
+        std::cout << run.name << "\n"
+            << "    " << mesh.stride << " bytes per vertex instead of " << floatBytes << "\n"
+            << "    position error max " << mesh.error.maxPosition << ", rms " << mesh.error.rmsPosition
+            << ", uv error max " << mesh.error.maxTexCoord;
+        if(run.normals){
+            std::cout << ", normal error max " << mesh.error.maxNormalDegrees << " degrees";
+        }
+        std::cout << "\n    " << milliseconds << " ms, "
+            << static_cast<double>(vertices.size()) / milliseconds / 1000.0 << " M vertices/s" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,73 @@
+#ifndef QUAT_TRANSFORM_H_10192026
+#define QUAT_TRANSFORM_H_10192026
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include "glm/gtc/type_ptr.hpp"
+
+/*
+Transform variant holding a unit quaternion instead of euler angles and a uniform scale.
+position (12 bytes) + rotation (16 bytes) + scale (4 bytes) packs into 32 bytes, two per cache line.
+GetModel() builds translate * rotate * scale in one pass straight from the quaternion,
+Slerp() blends two transforms for animation.
+*/
+class QuatTransform
+{
+public:
+    explicit QuatTransform(const glm::vec3& position = glm::vec3{},
+                           const glm::quat& rotation = glm::quat{1.0f, 0.0f, 0.0f, 0.0f},
+                           float scale = 1.0f)
+        : m_position{position}, m_rotation{glm::normalize(rotation)}, m_scale{scale}
+    {}
+
+    // same angle convention as Transform, rotateZ * rotateY * rotateX
+    static inline glm::quat FromEuler(const glm::vec3& rotation)
+    {
+        return glm::angleAxis(rotation.z, glm::vec3{0.0f, 0.0f, 1.0f}) *
+               glm::angleAxis(rotation.y, glm::vec3{0.0f, 1.0f, 0.0f}) *
+               glm::angleAxis(rotation.x, glm::vec3{1.0f, 0.0f, 0.0f});
+    }
+
+    static inline QuatTransform Slerp(const QuatTransform& from, const QuatTransform& to, float t)
+    {
+        return QuatTransform{glm::mix(from.m_position, to.m_position, t),
+                             glm::slerp(from.m_rotation, to.m_rotation, t),
+                             glm::mix(from.m_scale, to.m_scale, t)};
+    }
+
+    inline glm::mat4 GetModel() const
+    {
+        const auto& q{m_rotation};
+        const float x2{q.x + q.x}, y2{q.y + q.y}, z2{q.z + q.z};
+        const float xx{q.x * x2}, yy{q.y * y2}, zz{q.z * z2};
+        const float xy{q.x * y2}, xz{q.x * z2}, yz{q.y * z2};
+        const float wx{q.w * x2}, wy{q.w * y2}, wz{q.w * z2};
+        const float s{m_scale};
+
+        return glm::mat4{
+            glm::vec4{(1.0f - (yy + zz)) * s, (xy + wz) * s, (xz - wy) * s, 0.0f},
+            glm::vec4{(xy - wz) * s, (1.0f - (xx + zz)) * s, (yz + wx) * s, 0.0f},
+            glm::vec4{(xz + wy) * s, (yz - wx) * s, (1.0f - (xx + yy)) * s, 0.0f},
+            glm::vec4{m_position, 1.0f}};
+    }
+
+    inline const glm::vec3& GetPosition() const { return m_position; }
+    inline const glm::quat& GetRotation() const { return m_rotation; }
+    inline float GetScale() const { return m_scale; }
+
+    inline void SetPosition(const glm::vec3& position) { m_position = position; }
+    inline void SetRotation(const glm::quat& rotation) { m_rotation = glm::normalize(rotation); }
+    inline void SetScale(float scale) { m_scale = scale; }
+
+    // apply an extra rotation on top of the current one
+    inline void Rotate(const glm::quat& rotation) { m_rotation = glm::normalize(rotation * m_rotation); }
+
+private:
+    glm::vec3 m_position;
+    glm::quat m_rotation;
+    float m_scale;
+};
+
+static_assert(sizeof(QuatTransform) == 32, "QuatTransform is meant to pack into 32 bytes");
+
+#endif // !QUAT_TRANSFORM_H_10192026
@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "quatTransform.h"
+#include "transform.h"
+
+// settings
+constexpr std::size_t TRANSFORM_COUNT{1'000'000};
+constexpr int ITERATIONS{10};
+
+float MaxError(const glm::mat4& a, const glm::mat4& b)
+{
+    float error{};
+    for(int c{}; c < 4; ++c){
+        for(int r{}; r < 4; ++r){
+            error = std::max(error, std::abs(a[c][r] - b[c][r]));
+        }
+    }
+    return error;
+}
+
+/*
+Accuracy and speed of QuatTransform against the euler angle Transform.
+Both get the same position, rotation and uniform scale and are rotated every iteration
+so the cached Transform has to rebuild its matrix like the quaternion one does.
+*/
+int main()
+{
+    std::mt19937 rng{3};
+    std::uniform_real_distribution<float> position{-100.0f, 100.0f};
+    std::uniform_real_distribution<float> angle{-glm::pi<float>(), glm::pi<float>()};
+    std::uniform_real_distribution<float> scale{0.1f, 4.0f};
+
+    std::vector<Transform> eulers;
+    std::vector<QuatTransform> quats;
+    eulers.reserve(TRANSFORM_COUNT);
+    quats.reserve(TRANSFORM_COUNT);
+    for(std::size_t i{}; i < TRANSFORM_COUNT; ++i){
+        glm::vec3 p{position(rng), position(rng), position(rng)};
+        glm::vec3 r{angle(rng), angle(rng), angle(rng)};
+        auto s{scale(rng)};
+        eulers.emplace_back(p, r, glm::vec3{s});
+        quats.emplace_back(p, QuatTransform::FromEuler(r), s);
+    }
+
+    float maxError{};
+    for(std::size_t i{}; i < TRANSFORM_COUNT; ++i){
+        maxError = std::max(maxError, MaxError(eulers[i].GetModel(), quats[i].GetModel()));
+    }
+
+    // slerp half way between two rotations about the same axis must equal the half angle,
+    // angles stay within pi of each other so the shortest arc is the direct one
+    std::uniform_real_distribution<float> halfAngle{-glm::pi<float>() * 0.5f, glm::pi<float>() * 0.5f};
+    float slerpError{};
+    for(int i{}; i < 1000; ++i){
+        glm::vec3 axis{glm::normalize(glm::vec3{angle(rng), angle(rng), angle(rng)})};
+        auto a{halfAngle(rng)}, b{halfAngle(rng)};
+        QuatTransform from{{}, glm::angleAxis(a, axis)}, to{{}, glm::angleAxis(b, axis)};
+        QuatTransform half{{}, glm::angleAxis((a + b) * 0.5f, axis)};
+        slerpError = std::max(slerpError, MaxError(QuatTransform::Slerp(from, to, 0.5f).GetModel(), half.GetModel()));
+    }
+
+    std::vector<glm::mat4> models(TRANSFORM_COUNT);
+    using clock = std::chrono::steady_clock;
+    auto best = [](auto&& work){
+        auto fastest{std::chrono::duration<double, std::milli>::max()};
+        for(int i{}; i < ITERATIONS; ++i){
+            auto start{clock::now()};
+            work(0.01f * static_cast<float>(i + 1));
+            fastest = std::min(fastest, std::chrono::duration<double, std::milli>(clock::now() - start));
+        }
+        return fastest.count();
+    };
+
+    auto eulerTime{best([&](float spin){
+        for(std::size_t i{}; i < TRANSFORM_COUNT; ++i){
+            auto rotation{eulers[i].GetRotation()};
+            rotation.z += spin;
+            eulers[i].SetRotation(rotation);
+            models[i] = eulers[i].GetModel();
+        }
+    })};
+    auto spinZ{glm::angleAxis(0.01f, glm::vec3{0.0f, 0.0f, 1.0f})};
+    auto quatTime{best([&](float){
+        for(std::size_t i{}; i < TRANSFORM_COUNT; ++i){
+            quats[i].Rotate(spinZ);
+            models[i] = quats[i].GetModel();
+        }
+    })};
+
+    std::cout << "transforms:              " << TRANSFORM_COUNT << "\n"
+              << "sizeof Transform:        " << sizeof(Transform) << " bytes\n"
+              << "sizeof QuatTransform:    " << sizeof(QuatTransform) << " bytes\n"
+              << "max abs error vs euler:  " << maxError << "\n"
+              << "max abs slerp error:     " << slerpError << "\n"
+              << "Transform rotate+model:  " << eulerTime << " ms\n"
+              << "QuatTransform:           " << quatTime << " ms\n"
+              << "speedup:                 " << eulerTime / quatTime << "x" << std::endl;
+
+    return 0;
+}
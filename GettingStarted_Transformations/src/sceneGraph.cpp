@@ -0,0 +1,259 @@
+#include "sceneGraph.h"
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+#include <type_traits>
+
+SceneGraph::SceneGraph(std::size_t capacity)
+    : m_sorted{true}, m_updatedCount{}, m_splitStart{}, m_generation{}, m_running{}, m_stop{}
+{
+    m_parent.reserve(capacity);
+    m_depth.reserve(capacity);
+    m_locals.reserve(capacity);
+    m_seenVersion.reserve(capacity);
+    m_worlds.reserve(capacity);
+    m_changed.reserve(capacity);
+    m_nodeAt.reserve(capacity);
+    m_indexOf.reserve(capacity);
+}
+
+SceneGraph::~SceneGraph()
+{
+    StopWorkers();
+}
+
+SceneGraph::NodeId SceneGraph::AddNode(const Transform& local, NodeId parent)
+{
+    assert(parent == NoParent || parent < m_indexOf.size());
+
+    auto node{static_cast<NodeId>(m_indexOf.size())};
+    auto parentIndex{parent == NoParent ? NoIndex : m_indexOf[parent]};
+    auto depth{parentIndex == NoIndex ? 0u : m_depth[parentIndex] + 1};
+
+    m_indexOf.push_back(static_cast<std::uint32_t>(m_parent.size()));
+    m_parent.push_back(parentIndex);
+    m_depth.push_back(depth);
+    m_locals.push_back(local);
+    m_seenVersion.push_back(std::numeric_limits<std::uint64_t>::max()); // never seen, forces the first update
+    m_worlds.emplace_back(1.0f);
+    m_changed.push_back(0);
+    m_nodeAt.push_back(node);
+    m_sorted = false;
+
+    return node;
+}
+
+SceneGraph::NodeId SceneGraph::GetParent(NodeId node) const
+{
+    auto parent{m_parent[m_indexOf[node]]};
+    return parent == NoIndex ? NoParent : m_nodeAt[parent];
+}
+
+void SceneGraph::Update(unsigned int threadCount)
+{
+    if(!m_sorted){
+        SortByDepth();
+    }
+
+    auto workers{std::min<std::size_t>(threadCount, Size() / MinNodesPerThread)};
+    if(workers <= 1){
+        m_updatedCount = UpdateRange(0, Size());
+        return;
+    }
+
+    if(m_partitions.size() != workers){
+        BuildPartitions(workers);
+    }
+    if(m_threads.size() + 1 != workers){
+        StopWorkers();
+        StartWorkers(workers - 1);
+    }
+
+    // the levels above the split are parents of every partition, they are done before the workers wake
+    m_updatedCount = UpdateRange(0, m_splitStart);
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_running = m_threads.size();
+        ++m_generation;
+    }
+    m_start.notify_all();
+    m_partitionUpdated[0] = UpdatePartition(0);
+    {
+        std::unique_lock<std::mutex> lock{m_mutex};
+        m_done.wait(lock, [this](){ return m_running == 0; });
+    }
+    m_updatedCount = std::accumulate(m_partitionUpdated.begin(), m_partitionUpdated.end(), m_updatedCount);
+}
+
+void SceneGraph::SortByDepth()
+{
+    // stable counting sort on depth
+    auto depthCount{*std::max_element(m_depth.begin(), m_depth.end()) + std::size_t{1}};
+    m_levelStart.assign(depthCount + 1, 0);
+    for(auto depth : m_depth){
+        ++m_levelStart[depth + 1];
+    }
+    for(std::size_t level{}; level < depthCount; ++level){
+        m_levelStart[level + 1] += m_levelStart[level];
+    }
+
+    std::vector<std::size_t> next(m_levelStart.begin(), m_levelStart.end() - 1);
+    std::vector<std::uint32_t> newIndex(m_parent.size());
+    for(std::size_t i{}; i < m_parent.size(); ++i){
+        newIndex[i] = static_cast<std::uint32_t>(next[m_depth[i]]++);
+    }
+
+    auto permute = [&newIndex](auto& values){
+        std::remove_reference_t<decltype(values)> sorted(values.size(), values.front());
+        for(std::size_t i{}; i < values.size(); ++i){
+            sorted[newIndex[i]] = values[i];
+        }
+        values.swap(sorted);
+    };
+    for(auto& parent : m_parent){
+        if(parent != NoIndex){
+            parent = newIndex[parent];
+        }
+    }
+    permute(m_parent);
+    permute(m_depth);
+    permute(m_locals);
+    permute(m_seenVersion);
+    permute(m_worlds);
+    permute(m_changed);
+    permute(m_nodeAt);
+
+    for(std::size_t i{}; i < m_nodeAt.size(); ++i){
+        m_indexOf[m_nodeAt[i]] = static_cast<std::uint32_t>(i);
+    }
+    m_sorted = true;
+    // indices moved, the partitions are rebuilt by the next threaded Update()
+    m_partitions.clear();
+}
+
+void SceneGraph::BuildPartitions(std::size_t count)
+{
+    // split at the first level wide enough to give every worker several subtrees, else at the widest
+    const auto levels{GetDepthCount()};
+    std::size_t split{};
+    for(std::size_t level{}; level < levels; ++level){
+        auto width{m_levelStart[level + 1] - m_levelStart[level]};
+        if(width > m_levelStart[split + 1] - m_levelStart[split]){
+            split = level;
+        }
+        if(width >= count * SubtreesPerWorker){
+            split = level;
+            break;
+        }
+    }
+    m_splitStart = m_levelStart[split];
+
+    // subtree sizes, children come after their parents so a backwards pass adds them up
+    std::vector<std::uint32_t> subtreeSize(Size() - m_splitStart, 1);
+    for(auto i{Size()}; i-- > m_levelStart[split + 1];){
+        subtreeSize[m_parent[i] - m_splitStart] += subtreeSize[i - m_splitStart];
+    }
+
+    // largest subtrees first, each to the partition with the fewest nodes so far
+    std::vector<std::uint32_t> roots(m_levelStart[split + 1] - m_splitStart);
+    std::iota(roots.begin(), roots.end(), static_cast<std::uint32_t>(m_splitStart));
+    std::sort(roots.begin(), roots.end(), [&](std::uint32_t a, std::uint32_t b){
+        return subtreeSize[a - m_splitStart] > subtreeSize[b - m_splitStart];
+    });
+    std::vector<std::size_t> load(count);
+    std::vector<std::uint32_t> owner(Size() - m_splitStart);
+    for(auto root : roots){
+        auto partition{static_cast<std::size_t>(std::min_element(load.begin(), load.end()) - load.begin())};
+        owner[root - m_splitStart] = static_cast<std::uint32_t>(partition);
+        load[partition] += subtreeSize[root - m_splitStart];
+    }
+
+    m_partitions.assign(count, {});
+    for(std::size_t partition{}; partition < count; ++partition){
+        m_partitions[partition].reserve(load[partition]);
+    }
+    for(auto i{m_splitStart}; i < Size(); ++i){
+        if(i >= m_levelStart[split + 1]){
+            owner[i - m_splitStart] = owner[m_parent[i] - m_splitStart];
+        }
+        m_partitions[owner[i - m_splitStart]].push_back(static_cast<std::uint32_t>(i));
+    }
+    m_partitionUpdated.assign(count, 0);
+}
+
+void SceneGraph::StartWorkers(std::size_t count)
+{
+    m_stop = false;
+    m_generation = 0;
+    m_threads.reserve(count);
+    for(std::size_t i{}; i < count; ++i){
+        m_threads.emplace_back(&SceneGraph::WorkerLoop, this, i + 1);
+    }
+}
+
+void SceneGraph::StopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_stop = true;
+    }
+    m_start.notify_all();
+    for(auto& thread : m_threads){
+        thread.join();
+    }
+    m_threads.clear();
+}
+
+void SceneGraph::WorkerLoop(std::size_t partition)
+{
+    std::uint64_t seen{};
+    while(true){
+        {
+            std::unique_lock<std::mutex> lock{m_mutex};
+            m_start.wait(lock, [&](){ return m_stop || m_generation != seen; });
+            if(m_stop){
+                return;
+            }
+            seen = m_generation;
+        }
+        m_partitionUpdated[partition] = UpdatePartition(partition);
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            --m_running;
+        }
+        m_done.notify_one();
+    }
+}
+
+bool SceneGraph::UpdateNode(std::size_t index)
+{
+    auto parent{m_parent[index]};
+    auto& local{m_locals[index]};
+    bool parentChanged{parent != NoIndex && m_changed[parent]};
+    if(parentChanged || local.GetVersion() != m_seenVersion[index]){
+        m_worlds[index] = parent == NoIndex ? local.GetModel() : m_worlds[parent] * local.GetModel();
+        m_seenVersion[index] = local.GetVersion();
+        m_changed[index] = 1;
+        return true;
+    }
+    m_changed[index] = 0;
+    return false;
+}
+
+std::size_t SceneGraph::UpdateRange(std::size_t first, std::size_t last)
+{
+    std::size_t updated{};
+    for(auto i{first}; i < last; ++i){
+        updated += UpdateNode(i) ? 1 : 0;
+    }
+    return updated;
+}
+
+std::size_t SceneGraph::UpdatePartition(std::size_t partition)
+{
+    std::size_t updated{};
+    for(auto i : m_partitions[partition]){
+        updated += UpdateNode(i) ? 1 : 0;
+    }
+    return updated;
+}
@@ -0,0 +1,107 @@
+#ifndef SCENE_GRAPH_H_10192026
+#define SCENE_GRAPH_H_10192026
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "transform.h"
+
+/*
+Parent-child hierarchy of transforms kept flat and sorted by depth.
+Nodes of the same depth are contiguous and every parent sits in an earlier depth level,
+so world matrices are propagated in one linear pass, world = parentWorld * local.
+Only nodes whose local Transform version changed, or whose parent moved, are recomputed.
+With threadCount > 1 the graph is cut at the first depth level with enough nodes to share out,
+the levels above it are updated on the calling thread and the independent subtrees below it
+are spread over threads the graph keeps running between updates, one wake up per Update().
+NodeId handles stay valid while nodes are added, references returned by GetLocal do not.
+*/
+class SceneGraph
+{
+public:
+    using NodeId = std::uint32_t;
+    static constexpr NodeId NoParent{std::numeric_limits<NodeId>::max()};
+
+    explicit SceneGraph(std::size_t capacity = 0);
+    ~SceneGraph();
+
+    NodeId AddNode(const Transform& local = Transform{}, NodeId parent = NoParent);
+
+    void Update(unsigned int threadCount = 1);
+
+    inline Transform& GetLocal(NodeId node) { return m_locals[m_indexOf[node]]; }
+    inline const Transform& GetLocal(NodeId node) const { return m_locals[m_indexOf[node]]; }
+    // valid after Update()
+    inline const glm::mat4& GetWorld(NodeId node) const { return m_worlds[m_indexOf[node]]; }
+    NodeId GetParent(NodeId node) const;
+
+    inline std::size_t Size() const { return m_indexOf.size(); }
+    inline std::size_t GetDepthCount() const { return m_levelStart.empty() ? 0 : m_levelStart.size() - 1; }
+    // nodes whose world matrix was recomputed by the last Update()
+    inline std::size_t GetUpdatedCount() const { return m_updatedCount; }
+
+    // world matrices in depth order, for uploading all of them at once
+    inline const std::vector<glm::mat4>& GetWorlds() const { return m_worlds; }
+
+    SceneGraph(const SceneGraph& other) = delete;
+    SceneGraph& operator=(const SceneGraph& other) = delete;
+    SceneGraph(SceneGraph&& other) = delete;
+    SceneGraph& operator=(SceneGraph&& other) = delete;
+
+private:
+    static constexpr std::uint32_t NoIndex{std::numeric_limits<std::uint32_t>::max()};
+    // below this many nodes waking a worker costs more than the update
+    static constexpr std::size_t MinNodesPerThread{4096};
+    // subtrees per worker at the split level, so uneven subtree sizes still balance out
+    static constexpr std::size_t SubtreesPerWorker{8};
+
+    void SortByDepth();
+    bool UpdateNode(std::size_t index);
+    std::size_t UpdateRange(std::size_t first, std::size_t last);
+    std::size_t UpdatePartition(std::size_t partition);
+    void BuildPartitions(std::size_t count);
+    void StartWorkers(std::size_t count);
+    void StopWorkers();
+    void WorkerLoop(std::size_t partition);
+
+    // indexed by position in depth order
+    std::vector<std::uint32_t> m_parent;
+    std::vector<std::uint32_t> m_depth;
+    std::vector<Transform> m_locals;
+    std::vector<std::uint64_t> m_seenVersion;
+    std::vector<glm::mat4> m_worlds;
+    std::vector<std::uint8_t> m_changed;
+    std::vector<NodeId> m_nodeAt;
+
+    // indexed by NodeId
+    std::vector<std::uint32_t> m_indexOf;
+
+    // m_levelStart[d] is the first index of depth d, the last entry is the node count
+    std::vector<std::size_t> m_levelStart;
+    bool m_sorted;
+    std::size_t m_updatedCount;
+
+    // nodes above m_splitStart are updated first, the rest belong to the subtree partition of their
+    // ancestor at the split level, each partition lists its nodes in depth order
+    std::size_t m_splitStart;
+    std::vector<std::vector<std::uint32_t>> m_partitions;
+    std::vector<std::size_t> m_partitionUpdated;
+
+    // m_threads[i] updates partition i + 1, the calling thread partition 0
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_start;
+    std::condition_variable m_done;
+    std::uint64_t m_generation;
+    std::size_t m_running;
+    bool m_stop;
+};
+
+#endif // !SCENE_GRAPH_H_10192026
@@ -0,0 +1,62 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "sceneGraph.h"
+
+// settings
+constexpr std::size_t NODE_COUNT{500'000};
+constexpr std::size_t ROOT_COUNT{64};
+constexpr int FRAMES{20};
+
+/*
+Random forest of NODE_COUNT nodes under ROOT_COUNT roots.
+Times a full update (every local transform changed), an incremental update where only a few
+nodes move and a frame where nothing moved, for 1 to 16 threads.
+*/
+int main()
+{
+    std::mt19937 rng{1};
+    std::uniform_real_distribution<float> unit{-1.0f, 1.0f};
+
+    SceneGraph graph{NODE_COUNT};
+    for(std::size_t i{}; i < NODE_COUNT; ++i){
+        // attach to a random earlier node, biased towards recent ones to get some depth
+        auto parent{i < ROOT_COUNT ? SceneGraph::NoParent
+            : static_cast<SceneGraph::NodeId>(std::uniform_int_distribution<std::size_t>{i / 2, i - 1}(rng))};
+        graph.AddNode(Transform{glm::vec3{unit(rng), unit(rng), unit(rng)},
+                                glm::vec3{unit(rng), unit(rng), unit(rng)}}, parent);
+    }
+    graph.Update();
+    std::cout << "nodes: " << graph.Size() << ", depth levels: " << graph.GetDepthCount() << "\n";
+
+    using clock = std::chrono::steady_clock;
+    auto timeFrames = [&](unsigned int threads, std::size_t moving){
+        std::chrono::duration<double, std::milli> total{};
+        std::size_t updated{};
+        for(int frame{}; frame < FRAMES; ++frame){
+            for(std::size_t i{}; i < moving; ++i){
+                auto node{static_cast<SceneGraph::NodeId>(moving == NODE_COUNT ? i : rng() % NODE_COUNT)};
+                auto rotation{graph.GetLocal(node).GetRotation()};
+                rotation.y += 0.01f;
+                graph.GetLocal(node).SetRotation(rotation);
+            }
+            auto start{clock::now()};
+            graph.Update(threads);
+            total += clock::now() - start;
+            updated += graph.GetUpdatedCount();
+        }
+        std::cout << "  " << threads << " thread(s), " << moving << " moving: "
+                  << total.count() / FRAMES << " ms/frame, " << updated / FRAMES << " nodes recomputed\n";
+    };
+
+    for(auto threads : {1u, 2u, 4u, 8u, 16u}){
+        timeFrames(threads, NODE_COUNT);
+        timeFrames(threads, 100);
+        timeFrames(threads, 0);
+    }
+
+    return 0;
+}
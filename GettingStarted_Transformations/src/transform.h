@@ -1,44 +1,92 @@
 #ifndef TRANSFORM_H_08182020
 #define TRANSFORM_H_08182020
 
+#include <cstdint>
+
 #include <glm/glm.hpp>
 #include <glm/gtx/transform.hpp>
 #include "glm/gtc/type_ptr.hpp"
 
+/*
+Position, euler rotation (radians) and scale of an object.
+The model matrix is cached and only rebuilt for the components that changed since the last GetModel(),
+a rotation change costs the sin/cos and matrix products, a position or scale change only touches columns.
+GetVersion() increases every time a component actually changes so consumers (uniform upload,
+culling bounds) can remember the version they last saw and skip work for static objects.
+*/
 class Transform
 {
 public:
     explicit Transform(const glm::vec3& position = glm::vec3{},
                        const glm::vec3& rotation = glm::vec3{},
                        const glm::vec3& scale = glm::vec3{1.0f,1.0f,1.0f})
-        : m_position{position}, m_rotation{rotation}, m_scale{scale}
+        : m_position{position}, m_rotation{rotation}, m_scale{scale},
+        m_rotationMatrix{1.0f}, m_model{1.0f}, m_dirty{DirtyAll}, m_version{}
     {}
 
-    inline glm::mat4 GetModel() const
+    inline const glm::mat4& GetModel() const
     {
-        glm::mat4 positionMatrix{glm::translate(m_position)};
-        glm::mat4 rotationXMatrix{glm::rotate(m_rotation.x, glm::vec3(1.0f, 0.0f, 0.0f))};
-        glm::mat4 rotationYMatrix{glm::rotate(m_rotation.y, glm::vec3(0.0f, 1.0f, 0.0f))};
-        glm::mat4 rotationZMatrix{glm::rotate(m_rotation.z, glm::vec3(0.0f, 0.0f, 1.0f))};
-        glm::mat4 scaleMatrix{glm::scale(m_scale)};
+        if(m_dirty & DirtyRotation){
+            glm::mat4 rotationXMatrix{glm::rotate(m_rotation.x, glm::vec3(1.0f, 0.0f, 0.0f))};
+            glm::mat4 rotationYMatrix{glm::rotate(m_rotation.y, glm::vec3(0.0f, 1.0f, 0.0f))};
+            glm::mat4 rotationZMatrix{glm::rotate(m_rotation.z, glm::vec3(0.0f, 0.0f, 1.0f))};
 
-        glm::mat4 rotationMatrix{rotationZMatrix * rotationYMatrix * rotationXMatrix};
+            m_rotationMatrix = rotationZMatrix * rotationYMatrix * rotationXMatrix;
+        }
+        if(m_dirty & (DirtyRotation | DirtyScale)){
+            // rotation * scale only scales the rotation columns
+            m_model[0] = m_rotationMatrix[0] * m_scale.x;
+            m_model[1] = m_rotationMatrix[1] * m_scale.y;
+            m_model[2] = m_rotationMatrix[2] * m_scale.z;
+        }
+        if(m_dirty & DirtyPosition){
+            // translate only sets the last column
+            m_model[3] = glm::vec4{m_position, 1.0f};
+        }
+        m_dirty = DirtyNone;
 
-        return positionMatrix * rotationMatrix * scaleMatrix;
+        return m_model;
     }
 
     inline const glm::vec3& GetPosition() const {return m_position; }
     inline const glm::vec3& GetRotation() const { return m_rotation; }
     inline const glm::vec3& GetScale() const { return m_scale; }
 
-    inline void SetPosition(const glm::vec3& position) { m_position = position; }
-    inline void SetRotation(const glm::vec3& rotation) { m_rotation = rotation; }
-    inline void SetScale(const glm::vec3& scale) { m_scale = scale; }
+    inline void SetPosition(const glm::vec3& position) { Set(m_position, position, DirtyPosition); }
+    inline void SetRotation(const glm::vec3& rotation) { Set(m_rotation, rotation, DirtyRotation); }
+    inline void SetScale(const glm::vec3& scale) { Set(m_scale, scale, DirtyScale); }
+
+    // true while a change has not been folded into the cached model matrix yet
+    inline bool IsDirty() const { return m_dirty != DirtyNone; }
+    inline std::uint64_t GetVersion() const { return m_version; }
 
 private:
+    enum DirtyBits : std::uint8_t
+    {
+        DirtyNone = 0,
+        DirtyPosition = 1 << 0,
+        DirtyRotation = 1 << 1,
+        DirtyScale = 1 << 2,
+        DirtyAll = DirtyPosition | DirtyRotation | DirtyScale
+    };
+
+    inline void Set(glm::vec3& component, const glm::vec3& value, DirtyBits bit)
+    {
+        if(component != value){
+            component = value;
+            m_dirty |= bit;
+            ++m_version;
+        }
+    }
+
     glm::vec3 m_position;
     glm::vec3 m_rotation;
     glm::vec3 m_scale;
+
+    mutable glm::mat4 m_rotationMatrix;
+    mutable glm::mat4 m_model;
+    mutable std::uint8_t m_dirty;
+    std::uint64_t m_version;
 };
 
 #endif // !TRANSFORM_H_08182020
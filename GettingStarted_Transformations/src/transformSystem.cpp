@@ -0,0 +1,323 @@
+#include "transformSystem.h"
+#include <cassert>
+#include <cmath>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TRANSFORM_SYSTEM_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    struct Streams
+    {
+        const float* positionX; const float* positionY; const float* positionZ;
+        const float* rotationX; const float* rotationY; const float* rotationZ;
+        const float* scaleX; const float* scaleY; const float* scaleZ;
+        glm::mat4* models;
+    };
+
+    // sin/cos range reduction and polynomial coefficients (cephes sinf/cosf)
+    constexpr float TwoOverPi{0.636619772367581343f};
+    constexpr float HalfPiHigh{1.57079637050628662109375f};
+    constexpr float HalfPiLow{-4.37113900018624283e-8f};
+    constexpr float SinC0{-1.6666654611e-1f};
+    constexpr float SinC1{8.3321608736e-3f};
+    constexpr float SinC2{-1.9515295891e-4f};
+    constexpr float CosC0{4.166664568298827e-2f};
+    constexpr float CosC1{-1.388731625493765e-3f};
+    constexpr float CosC2{2.443315711809948e-5f};
+
+    /*
+    model = translate * (rotateZ * rotateY * rotateX) * scale written out per element
+    column 0: scale.x * (cz*cy, sz*cy, -sy)
+    column 1: scale.y * (cz*sy*sx - sz*cx, sz*sy*sx + cz*cx, cy*sx)
+    column 2: scale.z * (cz*sy*cx + sz*sx, sz*sy*cx - cz*sx, cy*cx)
+    column 3: position
+    */
+#if defined(__AVX2__) || defined(TRANSFORM_SYSTEM_SSE2)
+    // transpose 4 lanes of (x, y, z, w) into the column of 4 consecutive matrices
+    inline void StoreColumn(glm::mat4* models, int column, __m128 x, __m128 y, __m128 z, __m128 w)
+    {
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+        _mm_storeu_ps(&models[0][column].x, x);
+        _mm_storeu_ps(&models[1][column].x, y);
+        _mm_storeu_ps(&models[2][column].x, z);
+        _mm_storeu_ps(&models[3][column].x, w);
+    }
+#endif
+
+#if defined(__AVX2__)
+    inline void SinCos(__m256 x, __m256& sinOut, __m256& cosOut)
+    {
+        // reduce to r in [-pi/4, pi/4] and quadrant q
+        const auto quadrant{_mm256_cvtps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(TwoOverPi)))};
+        const auto q{_mm256_cvtepi32_ps(quadrant)};
+        auto r{_mm256_sub_ps(x, _mm256_mul_ps(q, _mm256_set1_ps(HalfPiHigh)))};
+        r = _mm256_sub_ps(r, _mm256_mul_ps(q, _mm256_set1_ps(HalfPiLow)));
+
+        const auto r2{_mm256_mul_ps(r, r)};
+        auto sinPoly{_mm256_set1_ps(SinC2)};
+        sinPoly = _mm256_add_ps(_mm256_mul_ps(sinPoly, r2), _mm256_set1_ps(SinC1));
+        sinPoly = _mm256_add_ps(_mm256_mul_ps(sinPoly, r2), _mm256_set1_ps(SinC0));
+        sinPoly = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(sinPoly, r2), r), r);
+
+        auto cosPoly{_mm256_set1_ps(CosC2)};
+        cosPoly = _mm256_add_ps(_mm256_mul_ps(cosPoly, r2), _mm256_set1_ps(CosC1));
+        cosPoly = _mm256_add_ps(_mm256_mul_ps(cosPoly, r2), _mm256_set1_ps(CosC0));
+        cosPoly = _mm256_mul_ps(_mm256_mul_ps(cosPoly, r2), r2);
+        cosPoly = _mm256_add_ps(_mm256_sub_ps(cosPoly, _mm256_mul_ps(r2, _mm256_set1_ps(0.5f))), _mm256_set1_ps(1.0f));
+
+        // odd quadrants swap sin and cos, quadrants 2,3 negate sin and 1,2 negate cos
+        const auto one{_mm256_set1_epi32(1)};
+        const auto two{_mm256_set1_epi32(2)};
+        const auto swap{_mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(quadrant, one), one))};
+        const auto sinSign{_mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(quadrant, two), 30))};
+        const auto cosSign{_mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(quadrant, one), two), 30))};
+
+        sinOut = _mm256_xor_ps(_mm256_blendv_ps(sinPoly, cosPoly, swap), sinSign);
+        cosOut = _mm256_xor_ps(_mm256_blendv_ps(cosPoly, sinPoly, swap), cosSign);
+    }
+
+    inline void StoreColumn8(glm::mat4* models, int column, __m256 x, __m256 y, __m256 z, __m256 w)
+    {
+        StoreColumn(models, column, _mm256_castps256_ps128(x), _mm256_castps256_ps128(y),
+                    _mm256_castps256_ps128(z), _mm256_castps256_ps128(w));
+        StoreColumn(models + 4, column, _mm256_extractf128_ps(x, 1), _mm256_extractf128_ps(y, 1),
+                    _mm256_extractf128_ps(z, 1), _mm256_extractf128_ps(w, 1));
+    }
+
+    void BuildModels(const Streams& s, std::size_t first, std::size_t last)
+    {
+        const auto zero{_mm256_setzero_ps()};
+        const auto one{_mm256_set1_ps(1.0f)};
+        for(auto i{first}; i < last; i += 8){
+            __m256 sx, cx, sy, cy, sz, cz;
+            SinCos(_mm256_loadu_ps(s.rotationX + i), sx, cx);
+            SinCos(_mm256_loadu_ps(s.rotationY + i), sy, cy);
+            SinCos(_mm256_loadu_ps(s.rotationZ + i), sz, cz);
+
+            const auto scaleX{_mm256_loadu_ps(s.scaleX + i)};
+            const auto scaleY{_mm256_loadu_ps(s.scaleY + i)};
+            const auto scaleZ{_mm256_loadu_ps(s.scaleZ + i)};
+
+            const auto czsy{_mm256_mul_ps(cz, sy)};
+            const auto szsy{_mm256_mul_ps(sz, sy)};
+
+            StoreColumn8(s.models + i, 0,
+                         _mm256_mul_ps(_mm256_mul_ps(cz, cy), scaleX),
+                         _mm256_mul_ps(_mm256_mul_ps(sz, cy), scaleX),
+                         _mm256_mul_ps(_mm256_sub_ps(zero, sy), scaleX),
+                         zero);
+            StoreColumn8(s.models + i, 1,
+                         _mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(czsy, sx), _mm256_mul_ps(sz, cx)), scaleY),
+                         _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(szsy, sx), _mm256_mul_ps(cz, cx)), scaleY),
+                         _mm256_mul_ps(_mm256_mul_ps(cy, sx), scaleY),
+                         zero);
+            StoreColumn8(s.models + i, 2,
+                         _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(czsy, cx), _mm256_mul_ps(sz, sx)), scaleZ),
+                         _mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(szsy, cx), _mm256_mul_ps(cz, sx)), scaleZ),
+                         _mm256_mul_ps(_mm256_mul_ps(cy, cx), scaleZ),
+                         zero);
+            StoreColumn8(s.models + i, 3,
+                         _mm256_loadu_ps(s.positionX + i),
+                         _mm256_loadu_ps(s.positionY + i),
+                         _mm256_loadu_ps(s.positionZ + i),
+                         one);
+        }
+    }
+#elif defined(TRANSFORM_SYSTEM_SSE2)
+    inline __m128 Select(__m128 mask, __m128 a, __m128 b)
+    {
+        return _mm_or_ps(_mm_and_ps(mask, b), _mm_andnot_ps(mask, a));
+    }
+
+    inline void SinCos(__m128 x, __m128& sinOut, __m128& cosOut)
+    {
+        // reduce to r in [-pi/4, pi/4] and quadrant q
+        const auto quadrant{_mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(TwoOverPi)))};
+        const auto q{_mm_cvtepi32_ps(quadrant)};
+        auto r{_mm_sub_ps(x, _mm_mul_ps(q, _mm_set1_ps(HalfPiHigh)))};
+        r = _mm_sub_ps(r, _mm_mul_ps(q, _mm_set1_ps(HalfPiLow)));
+
+        const auto r2{_mm_mul_ps(r, r)};
+        auto sinPoly{_mm_set1_ps(SinC2)};
+        sinPoly = _mm_add_ps(_mm_mul_ps(sinPoly, r2), _mm_set1_ps(SinC1));
+        sinPoly = _mm_add_ps(_mm_mul_ps(sinPoly, r2), _mm_set1_ps(SinC0));
+        sinPoly = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(sinPoly, r2), r), r);
+
+        auto cosPoly{_mm_set1_ps(CosC2)};
+        cosPoly = _mm_add_ps(_mm_mul_ps(cosPoly, r2), _mm_set1_ps(CosC1));
+        cosPoly = _mm_add_ps(_mm_mul_ps(cosPoly, r2), _mm_set1_ps(CosC0));
+        cosPoly = _mm_mul_ps(_mm_mul_ps(cosPoly, r2), r2);
+        cosPoly = _mm_add_ps(_mm_sub_ps(cosPoly, _mm_mul_ps(r2, _mm_set1_ps(0.5f))), _mm_set1_ps(1.0f));
+
+        // odd quadrants swap sin and cos, quadrants 2,3 negate sin and 1,2 negate cos
+        const auto one{_mm_set1_epi32(1)};
+        const auto two{_mm_set1_epi32(2)};
+        const auto swap{_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, one), one))};
+        const auto sinSign{_mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, two), 30))};
+        const auto cosSign{_mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(quadrant, one), two), 30))};
+
+        sinOut = _mm_xor_ps(Select(swap, sinPoly, cosPoly), sinSign);
+        cosOut = _mm_xor_ps(Select(swap, cosPoly, sinPoly), cosSign);
+    }
+
+    void BuildModels(const Streams& s, std::size_t first, std::size_t last)
+    {
+        const auto zero{_mm_setzero_ps()};
+        const auto one{_mm_set1_ps(1.0f)};
+        for(auto i{first}; i < last; i += 4){
+            __m128 sx, cx, sy, cy, sz, cz;
+            SinCos(_mm_loadu_ps(s.rotationX + i), sx, cx);
+            SinCos(_mm_loadu_ps(s.rotationY + i), sy, cy);
+            SinCos(_mm_loadu_ps(s.rotationZ + i), sz, cz);
+
+            const auto scaleX{_mm_loadu_ps(s.scaleX + i)};
+            const auto scaleY{_mm_loadu_ps(s.scaleY + i)};
+            const auto scaleZ{_mm_loadu_ps(s.scaleZ + i)};
+
+            const auto czsy{_mm_mul_ps(cz, sy)};
+            const auto szsy{_mm_mul_ps(sz, sy)};
+
+            StoreColumn(s.models + i, 0,
+                        _mm_mul_ps(_mm_mul_ps(cz, cy), scaleX),
+                        _mm_mul_ps(_mm_mul_ps(sz, cy), scaleX),
+                        _mm_mul_ps(_mm_sub_ps(zero, sy), scaleX),
+                        zero);
+            StoreColumn(s.models + i, 1,
+                        _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(czsy, sx), _mm_mul_ps(sz, cx)), scaleY),
+                        _mm_mul_ps(_mm_add_ps(_mm_mul_ps(szsy, sx), _mm_mul_ps(cz, cx)), scaleY),
+                        _mm_mul_ps(_mm_mul_ps(cy, sx), scaleY),
+                        zero);
+            StoreColumn(s.models + i, 2,
+                        _mm_mul_ps(_mm_add_ps(_mm_mul_ps(czsy, cx), _mm_mul_ps(sz, sx)), scaleZ),
+                        _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(szsy, cx), _mm_mul_ps(cz, sx)), scaleZ),
+                        _mm_mul_ps(_mm_mul_ps(cy, cx), scaleZ),
+                        zero);
+            StoreColumn(s.models + i, 3,
+                        _mm_loadu_ps(s.positionX + i),
+                        _mm_loadu_ps(s.positionY + i),
+                        _mm_loadu_ps(s.positionZ + i),
+                        one);
+        }
+    }
+#else
+    void BuildModels(const Streams& s, std::size_t first, std::size_t last)
+    {
+        for(auto i{first}; i < last; ++i){
+            const float sx{std::sin(s.rotationX[i])}, cx{std::cos(s.rotationX[i])};
+            const float sy{std::sin(s.rotationY[i])}, cy{std::cos(s.rotationY[i])};
+            const float sz{std::sin(s.rotationZ[i])}, cz{std::cos(s.rotationZ[i])};
+
+            auto& m{s.models[i]};
+            m[0] = glm::vec4{cz * cy, sz * cy, -sy, 0.0f} * s.scaleX[i];
+            m[1] = glm::vec4{cz * sy * sx - sz * cx, sz * sy * sx + cz * cx, cy * sx, 0.0f} * s.scaleY[i];
+            m[2] = glm::vec4{cz * sy * cx + sz * sx, sz * sy * cx - cz * sx, cy * cx, 0.0f} * s.scaleZ[i];
+            m[3] = glm::vec4{s.positionX[i], s.positionY[i], s.positionZ[i], 1.0f};
+        }
+    }
+#endif
+}
+
+TransformSystem::TransformSystem(std::size_t capacity)
+    : m_size{}
+{
+    Reserve(capacity);
+}
+
+std::size_t TransformSystem::Add(const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale)
+{
+    if(m_size == m_models.size()){
+        Resize(m_size + BatchWidth);
+    }
+    auto index{m_size++};
+    SetPosition(index, position);
+    SetRotation(index, rotation);
+    SetScale(index, scale);
+    return index;
+}
+
+void TransformSystem::Reserve(std::size_t capacity)
+{
+    auto padded{(capacity + BatchWidth - 1) / BatchWidth * BatchWidth};
+    for(auto* stream : {&m_positionX, &m_positionY, &m_positionZ,
+                        &m_rotationX, &m_rotationY, &m_rotationZ,
+                        &m_scaleX, &m_scaleY, &m_scaleZ}){
+        stream->reserve(padded);
+    }
+    m_models.reserve(padded);
+}
+
+void TransformSystem::Clear()
+{
+    m_size = 0;
+    Resize(0);
+}
+
+void TransformSystem::Update()
+{
+    const Streams streams{m_positionX.data(), m_positionY.data(), m_positionZ.data(),
+                          m_rotationX.data(), m_rotationY.data(), m_rotationZ.data(),
+                          m_scaleX.data(), m_scaleY.data(), m_scaleZ.data(),
+                          m_models.data()};
+    // padding lanes hold identity transforms so the whole padded range is computed
+    BuildModels(streams, 0, m_models.size());
+}
+
+glm::vec3 TransformSystem::GetPosition(std::size_t index) const
+{
+    assert(index < m_size);
+    return {m_positionX[index], m_positionY[index], m_positionZ[index]};
+}
+
+glm::vec3 TransformSystem::GetRotation(std::size_t index) const
+{
+    assert(index < m_size);
+    return {m_rotationX[index], m_rotationY[index], m_rotationZ[index]};
+}
+
+glm::vec3 TransformSystem::GetScale(std::size_t index) const
+{
+    assert(index < m_size);
+    return {m_scaleX[index], m_scaleY[index], m_scaleZ[index]};
+}
+
+void TransformSystem::SetPosition(std::size_t index, const glm::vec3& position)
+{
+    assert(index < m_size);
+    m_positionX[index] = position.x;
+    m_positionY[index] = position.y;
+    m_positionZ[index] = position.z;
+}
+
+void TransformSystem::SetRotation(std::size_t index, const glm::vec3& rotation)
+{
+    assert(index < m_size);
+    m_rotationX[index] = rotation.x;
+    m_rotationY[index] = rotation.y;
+    m_rotationZ[index] = rotation.z;
+}
+
+void TransformSystem::SetScale(std::size_t index, const glm::vec3& scale)
+{
+    assert(index < m_size);
+    m_scaleX[index] = scale.x;
+    m_scaleY[index] = scale.y;
+    m_scaleZ[index] = scale.z;
+}
+
+void TransformSystem::Resize(std::size_t paddedSize)
+{
+    assert(paddedSize % BatchWidth == 0);
+    for(auto* stream : {&m_positionX, &m_positionY, &m_positionZ,
+                        &m_rotationX, &m_rotationY, &m_rotationZ}){
+        stream->resize(paddedSize, 0.0f);
+    }
+    for(auto* stream : {&m_scaleX, &m_scaleY, &m_scaleZ}){
+        stream->resize(paddedSize, 1.0f);
+    }
+    m_models.resize(paddedSize, glm::mat4{1.0f});
+}
@@ -0,0 +1,60 @@
+#ifndef TRANSFORM_SYSTEM_H_10192026
+#define TRANSFORM_SYSTEM_H_10192026
+
+#include <cstddef>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+/*
+Structure of arrays storage for many transforms.
+Positions, rotations (euler angles in radians) and scales are kept in separate float streams
+so model matrices can be built several objects at a time (8 with AVX2, 4 with SSE2).
+Model matrices match Transform::GetModel(), translate * rotateZ * rotateY * rotateX * scale,
+and are written into one contiguous buffer that can be handed straight to glBufferSubData.
+*/
+class TransformSystem
+{
+public:
+    explicit TransformSystem(std::size_t capacity = 0);
+
+    std::size_t Add(const glm::vec3& position = glm::vec3{},
+                    const glm::vec3& rotation = glm::vec3{},
+                    const glm::vec3& scale = glm::vec3{1.0f, 1.0f, 1.0f});
+
+    void Reserve(std::size_t capacity);
+    void Clear();
+
+    // compute the model matrices of every transform into the output buffer
+    void Update();
+
+    glm::vec3 GetPosition(std::size_t index) const;
+    glm::vec3 GetRotation(std::size_t index) const;
+    glm::vec3 GetScale(std::size_t index) const;
+
+    void SetPosition(std::size_t index, const glm::vec3& position);
+    void SetRotation(std::size_t index, const glm::vec3& rotation);
+    void SetScale(std::size_t index, const glm::vec3& scale);
+
+    // valid after Update()
+    inline const glm::mat4& GetModel(std::size_t index) const { return m_models[index]; }
+    inline const glm::mat4* Data() const { return m_models.data(); }
+    inline std::size_t SizeInBytes() const { return m_size * sizeof(glm::mat4); }
+    inline std::size_t Size() const { return m_size; }
+
+private:
+    // streams are padded to a multiple of this so batches never need a scalar tail
+    static constexpr std::size_t BatchWidth{8};
+
+    void Resize(std::size_t paddedSize);
+
+    std::size_t m_size;
+
+    std::vector<float> m_positionX, m_positionY, m_positionZ;
+    std::vector<float> m_rotationX, m_rotationY, m_rotationZ;
+    std::vector<float> m_scaleX, m_scaleY, m_scaleZ;
+
+    std::vector<glm::mat4> m_models;
+};
+
+#endif // !TRANSFORM_SYSTEM_H_10192026
@@ -0,0 +1,82 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "transform.h"
+#include "transformSystem.h"
+
+// settings
+constexpr std::size_t TRANSFORM_COUNT{1'000'000};
+constexpr int ITERATIONS{10};
+
+/*
+Compare building model matrices one Transform at a time against the batched TransformSystem.
+Every object is rotated each frame so neither path can reuse a cached matrix.
+No window is needed, this only measures the CPU side of the per frame transform update.
+*/
+int main()
+{
+    std::mt19937 rng{42};
+    std::uniform_real_distribution<float> position{-100.0f, 100.0f};
+    std::uniform_real_distribution<float> angle{-glm::pi<float>() * 4.0f, glm::pi<float>() * 4.0f};
+    std::uniform_real_distribution<float> scale{0.1f, 4.0f};
+
+    std::vector<Transform> transforms;
+    std::vector<glm::vec3> rotations;
+    transforms.reserve(TRANSFORM_COUNT);
+    rotations.reserve(TRANSFORM_COUNT);
+    TransformSystem system{TRANSFORM_COUNT};
+    for(std::size_t i{}; i < TRANSFORM_COUNT; ++i){
+        glm::vec3 p{position(rng), position(rng), position(rng)};
+        glm::vec3 r{angle(rng), angle(rng), angle(rng)};
+        glm::vec3 s{scale(rng), scale(rng), scale(rng)};
+        transforms.emplace_back(p, r, s);
+        rotations.push_back(r);
+        system.Add(p, r, s);
+    }
+
+    std::vector<glm::mat4> models(TRANSFORM_COUNT);
+    using clock = std::chrono::steady_clock;
+    auto best = [](auto&& work){
+        auto fastest{std::chrono::duration<double, std::milli>::max()};
+        for(int i{}; i < ITERATIONS; ++i){
+            auto start{clock::now()};
+            work(glm::vec3{0.01f * static_cast<float>(i + 1)});
+            fastest = std::min(fastest, std::chrono::duration<double, std::milli>(clock::now() - start));
+        }
+        return fastest.count();
+    };
+
+    auto perObject{best([&](const glm::vec3& spin){
+        for(std::size_t i{}; i < TRANSFORM_COUNT; ++i){
+            transforms[i].SetRotation(rotations[i] + spin);
+            models[i] = transforms[i].GetModel();
+        }
+    })};
+    auto batched{best([&](const glm::vec3& spin){
+        for(std::size_t i{}; i < TRANSFORM_COUNT; ++i){
+            system.SetRotation(i, rotations[i] + spin);
+        }
+        system.Update();
+    })};
+
+    float maxError{};
+    for(std::size_t i{}; i < TRANSFORM_COUNT; ++i){
+        for(int c{}; c < 4; ++c){
+            for(int r{}; r < 4; ++r){
+                maxError = std::max(maxError, std::abs(models[i][c][r] - system.GetModel(i)[c][r]));
+            }
+        }
+    }
+
+    std::cout << "transforms:       " << TRANSFORM_COUNT << "\n"
+              << "Transform:        " << perObject << " ms\n"
+              << "TransformSystem:  " << batched << " ms\n"
+              << "speedup:          " << perObject / batched << "x\n"
+              << "max abs error:    " << maxError << "\n"
+              << "upload size:      " << system.SizeInBytes() / (1024.0 * 1024.0) << " MiB" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "transform.h"
+
+// settings
+constexpr std::size_t TRANSFORM_COUNT{100'000};
+constexpr int FRAMES{100};
+
+// the per frame work before model matrices were cached, five matrices and four products per object
+glm::mat4 RebuildModel(const Transform& transform)
+{
+    glm::mat4 positionMatrix{glm::translate(transform.GetPosition())};
+    glm::mat4 rotationXMatrix{glm::rotate(transform.GetRotation().x, glm::vec3(1.0f, 0.0f, 0.0f))};
+    glm::mat4 rotationYMatrix{glm::rotate(transform.GetRotation().y, glm::vec3(0.0f, 1.0f, 0.0f))};
+    glm::mat4 rotationZMatrix{glm::rotate(transform.GetRotation().z, glm::vec3(0.0f, 0.0f, 1.0f))};
+    glm::mat4 scaleMatrix{glm::scale(transform.GetScale())};
+
+    return positionMatrix * (rotationZMatrix * rotationYMatrix * rotationXMatrix) * scaleMatrix;
+}
+
+/*
+Mostly static scene: each frame only a fraction of the objects move.
+"rebuild" recomputes and uploads every model matrix every frame,
+"cached" asks the Transform for its cached model and only uploads when the version moved on.
+The upload is a copy into a staging buffer standing in for glBufferSubData/glUniformMatrix4fv.
+*/
+int main()
+{
+    std::mt19937 rng{7};
+    std::uniform_real_distribution<float> unit{-1.0f, 1.0f};
+
+    std::vector<Transform> transforms;
+    transforms.reserve(TRANSFORM_COUNT);
+    for(std::size_t i{}; i < TRANSFORM_COUNT; ++i){
+        transforms.emplace_back(glm::vec3{unit(rng), unit(rng), unit(rng)} * 50.0f,
+                                glm::vec3{unit(rng), unit(rng), unit(rng)} * 3.0f);
+    }
+
+    std::vector<glm::mat4> staging(TRANSFORM_COUNT);
+    std::vector<std::uint64_t> uploadedVersion(TRANSFORM_COUNT, ~std::uint64_t{});
+
+    using clock = std::chrono::steady_clock;
+    std::cout << "transforms: " << TRANSFORM_COUNT << ", frames: " << FRAMES << "\n";
+
+    for(auto movingPercent : {0.0f, 1.0f, 10.0f, 100.0f}){
+        auto moving{static_cast<std::size_t>(TRANSFORM_COUNT * movingPercent / 100.0f)};
+
+        // pick the objects that animate, the rest stay where they are
+        std::vector<std::size_t> animated(TRANSFORM_COUNT);
+        for(std::size_t i{}; i < TRANSFORM_COUNT; ++i){
+            animated[i] = i;
+        }
+        std::shuffle(animated.begin(), animated.end(), rng);
+        animated.resize(moving);
+
+        std::chrono::duration<double, std::milli> rebuild{}, cached{};
+        std::size_t uploads{};
+        for(int frame{}; frame < FRAMES; ++frame){
+            for(auto i : animated){
+                auto rotation{transforms[i].GetRotation()};
+                rotation.z += 0.01f;
+                transforms[i].SetRotation(rotation);
+            }
+
+            auto start{clock::now()};
+            for(std::size_t i{}; i < TRANSFORM_COUNT; ++i){
+                staging[i] = RebuildModel(transforms[i]);
+            }
+            rebuild += clock::now() - start;
+
+            start = clock::now();
+            for(std::size_t i{}; i < TRANSFORM_COUNT; ++i){
+                if(transforms[i].GetVersion() != uploadedVersion[i]){
+                    staging[i] = transforms[i].GetModel();
+                    uploadedVersion[i] = transforms[i].GetVersion();
+                    ++uploads;
+                }
+            }
+            cached += clock::now() - start;
+        }
+
+        std::cout << movingPercent << "% moving: rebuild " << rebuild.count() / FRAMES << " ms/frame, cached "
+                  << cached.count() / FRAMES << " ms/frame, uploads skipped "
+                  << 100.0 - 100.0 * uploads / (static_cast<double>(TRANSFORM_COUNT) * FRAMES) << "%\n";
+    }
+
+    return 0;
+}
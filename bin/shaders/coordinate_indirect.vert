@@ -0,0 +1,23 @@
+#version 430 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec2 aTexCoord;
+layout (location = 2) in uint aObjectIndex;    // per instance attribute, starts at the draw's baseInstance
+
+struct Object
+{
+    mat4 model;
+    vec4 bounds;
+};
+
+layout (std430, binding = 0) readonly buffer Objects { Object objects[]; };
+
+out vec2 TexCoord;
+
+uniform mat4 view;
+uniform mat4 projection;
+
+void main()
+{
+    gl_Position = projection * view * objects[aObjectIndex].model * vec4(aPos, 1.0);
+    TexCoord = aTexCoord;
+}